@@ -33,7 +33,9 @@
 #include "em_rmu.h"
 #include "sl_watchdog.h"
 #include "sl_timer.h"
+#include "sl_latency_trace.h"
 #include "sl_bt_aoa.h"
+#include "aoa_util/aoa_iq_frame.h"
 
 //macros -----------------------------------------------------------------------
 #define SLI_APP_SATURATE(number, min, max) ((number) > (max)) ? (max) : ((number) < (min)) ? (min) : (number)
@@ -44,9 +46,30 @@
            locator_id, tag_id)
 
 //private type definitions -----------------------------------------------------
+///Kind of the queued message, messages of the same kind and tag can be coalesced.
+typedef enum {
+  SLI_APP_PUBLISH_KIND_IQ,
+  SLI_APP_PUBLISH_KIND_ANGLE,
+} sli_app_publish_kind_t;
+
+///Publish queue entry.
+typedef struct {
+  app_mqtt_data_t message;
+  uint64_t tag_id;
+  uint16_t sequence; ///< Event counter of the report, the key of its latency trace
+  sli_app_publish_kind_t kind;
+} sli_app_publish_slot_t;
+
 //private function prototypes --------------------------------------------------
+static app_mqtt_data_t *sli_app_publish_queue_acquire(sli_app_publish_kind_t kind, uint64_t tag_id, uint16_t sequence);
+
 //private variables ------------------------------------------------------------
-static app_mqtt_data_t sli_app_mqtt_message;
+///Message pool, used as a ring. Filled from the BT event handler, drained from app_process_action().
+static sli_app_publish_slot_t sli_app_publish_queue[APP_PUBLISH_QUEUE_SIZE];
+static uint32_t sli_app_publish_queue_head;
+static uint32_t sli_app_publish_queue_count;
+static app_publish_queue_stats_t sli_app_publish_queue_stats;
+SYSTEM_STATIC_ASSERT(sizeof(((app_mqtt_data_t *)0)->content) >= AOA_IQ_FRAME_HEADER_SIZE);
 
 //function definitions----------------------------------------------------------
 
@@ -68,54 +91,77 @@ void app_init(void)
 void app_process_action(void)
 {
   sl_watchdog_feed();
+  sl_bt_aoa_process_action();
+  sl_timer_hist_process_action();
+  sl_latency_trace_process_action();
+
+  for (uint32_t i = 0; (i < APP_PUBLISH_QUEUE_MAX_PUBLISH_PER_PASS) && (sli_app_publish_queue_count > 0); i++) {
+    sli_app_publish_slot_t *slot = &sli_app_publish_queue[sli_app_publish_queue_head];
+    sl_latency_trace_mark(slot->tag_id, slot->sequence, SL_LATENCY_TRACE_STAGE_PUBLISH);
+    app_mqtt_client_publish(&slot->message);
+    sli_app_publish_queue_head = (sli_app_publish_queue_head + 1) % APP_PUBLISH_QUEUE_SIZE;
+    sli_app_publish_queue_count--;
+    sli_app_publish_queue_stats.published++;
+  }
+}
+
+void app_publish_queue_get_stats(app_publish_queue_stats_t *stats)
+{
+  *stats = sli_app_publish_queue_stats;
 }
 
 void sl_bt_aoa_on_iq_report(const sl_bt_aoa_locator_id_t *locator_id,
                             const sl_bt_aoa_tag_id_t *tag_id,
                             const aoa_iq_report_t *iq)
 {
-  int len = sli_app_mqtt_create_topic(sli_app_mqtt_message.topic, "iq", locator_id->system_id, tag_id->system_id);
-  sli_app_mqtt_message.topic_length = SLI_APP_SATURATE(len, 0, (int)sizeof(sli_app_mqtt_message.topic));
+  app_mqtt_data_t *message = sli_app_publish_queue_acquire(SLI_APP_PUBLISH_KIND_IQ, tag_id->system_id, iq->event_counter);
+  int len = sli_app_mqtt_create_topic(message->topic, "iq", locator_id->system_id, tag_id->system_id);
+  message->topic_length = SLI_APP_SATURATE(len, 0, (int)sizeof(message->topic));
 
 #if SYSTEM_AOA_IQ_SAMPLE_PROVIDE_METHOD == SYSTEM_AOA_IQ_SAMPLE_PROVIDE_METHOD_RAW_BYTES
-  sli_app_mqtt_message.content_length = SLI_APP_SATURATE(iq->length, 0, sizeof(sli_app_mqtt_message.content));
-  memcpy(sli_app_mqtt_message.content, iq->samples, sli_app_mqtt_message.content_length);
+  message->content_length = SLI_APP_SATURATE(iq->length, 0, sizeof(message->content));
+  memcpy(message->content, iq->samples, message->content_length);
+#elif SYSTEM_AOA_IQ_SAMPLE_PROVIDE_METHOD == SYSTEM_AOA_IQ_SAMPLE_PROVIDE_METHOD_BINARY
+  size_t frame_size = 0;
+  //only whole IQ pairs are sent if the samples do not fit
+  (void)aoa_serialize_iq_frame(iq, tag_id->mac_addr, locator_id->mac_addr,
+                               message->content, sizeof(message->content), &frame_size);
+  message->content_length = frame_size;
 #elif SYSTEM_AOA_IQ_SAMPLE_PROVIDE_METHOD == SYSTEM_AOA_IQ_SAMPLE_PROVIDE_METHOD_JSON
   #define JSON_END "\"\n}\n"
-  const int max_content_size = sizeof(sli_app_mqtt_message.content) - sizeof(JSON_END); //terminating characters shall fit
+  const int max_content_size = sizeof(message->content) - sizeof(JSON_END); //terminating characters shall fit
   const char *hex = "0123456789ABCDEF";
 
-  len = snprintf((char *)sli_app_mqtt_message.content,
-                 sizeof(sli_app_mqtt_message.content),
+  len = snprintf((char *)message->content,
+                 sizeof(message->content),
                  "{\n\"channel\": %u,\n"
                  "\"rssi\": %d,\n"
                  "\"sequence\": %u,\n"
                  "\"samples\": \"",//extra spaces, so that ending will surely fit even when sample buffer is small
                  iq->channel, iq->rssi, iq->event_counter);
-  sli_app_mqtt_message.content_length = SLI_APP_SATURATE(len, 0, max_content_size);
+  message->content_length = SLI_APP_SATURATE(len, 0, max_content_size);
 
-  for (size_t i = 0; (i < iq->length) && (sli_app_mqtt_message.content_length < max_content_size); i++) {
-    sli_app_mqtt_message.content[sli_app_mqtt_message.content_length++] = hex[(iq->samples[i] >> 4) & 0xF];
-    sli_app_mqtt_message.content[sli_app_mqtt_message.content_length++] = hex[(iq->samples[i]) & 0xF];
+  for (size_t i = 0; (i < iq->length) && (message->content_length < max_content_size); i++) {
+    message->content[message->content_length++] = hex[(iq->samples[i] >> 4) & 0xF];
+    message->content[message->content_length++] = hex[(iq->samples[i]) & 0xF];
   }
-  memcpy(&sli_app_mqtt_message.content[sli_app_mqtt_message.content_length], JSON_END, sizeof(JSON_END));
-  sli_app_mqtt_message.content_length += (sizeof(JSON_END) - 1);
+  memcpy(&message->content[message->content_length], JSON_END, sizeof(JSON_END));
+  message->content_length += (sizeof(JSON_END) - 1);
 #else
   #error Unsupported SYSTEM_AOA_IQ_SAMPLE_PROVIDE_METHOD!
 #endif
-
-  app_mqtt_client_publish(&sli_app_mqtt_message);
 }
 
 void sl_bt_aoa_on_angle_report(const sl_bt_aoa_locator_id_t *locator_id,
                                const sl_bt_aoa_tag_id_t *tag_id,
                                const aoa_angle_t *angle)
 {
-  int len = sli_app_mqtt_create_topic(sli_app_mqtt_message.topic, "angle", locator_id->system_id, tag_id->system_id);
-  sli_app_mqtt_message.topic_length = SLI_APP_SATURATE(len, 0, (int)sizeof(sli_app_mqtt_message.topic));
+  app_mqtt_data_t *message = sli_app_publish_queue_acquire(SLI_APP_PUBLISH_KIND_ANGLE, tag_id->system_id, (uint16_t)angle->sequence);
+  int len = sli_app_mqtt_create_topic(message->topic, "angle", locator_id->system_id, tag_id->system_id);
+  message->topic_length = SLI_APP_SATURATE(len, 0, (int)sizeof(message->topic));
 
-  len = snprintf((char *)sli_app_mqtt_message.content,
-                 sizeof(sli_app_mqtt_message.content),
+  len = snprintf((char *)message->content,
+                 sizeof(message->content),
                  "{\n\"azimuth\": %.2f,\n\"azimuth_stdev\": %.2f,\n"
                  "\"elevation\": %.2f,\n\"elevation_stdev\": %.2f,\n"
                  "\"distance\": %.2f,\n\"distance_stdev\": %.2f,\n"
@@ -124,9 +170,7 @@ void sl_bt_aoa_on_angle_report(const sl_bt_aoa_locator_id_t *locator_id,
                  angle->elevation, angle->elevation_stdev,
                  angle->distance, angle->distance_stdev,
                  angle->sequence);
-  sli_app_mqtt_message.content_length = SLI_APP_SATURATE(len, 0, (int)sizeof(sli_app_mqtt_message.content));
-
-  app_mqtt_client_publish(&sli_app_mqtt_message);
+  message->content_length = SLI_APP_SATURATE(len, 0, (int)sizeof(message->content));
 }
 
 int app_mqtt_client_publish(const app_mqtt_data_t *message)
@@ -134,3 +178,41 @@ int app_mqtt_client_publish(const app_mqtt_data_t *message)
   app_log_info("Topic: %s" APP_LOG_NL "%s" APP_LOG_NL, message->topic, message->content);
   return 0;
 }
+
+/**************************************************************************//**
+ * Gets the queue slot for a new message.
+ *
+ * With the coalescing policy a message still waiting for the same tag and kind
+ * is overwritten in place. If the queue is full, the oldest message is dropped.
+ *****************************************************************************/
+static app_mqtt_data_t *sli_app_publish_queue_acquire(sli_app_publish_kind_t kind, uint64_t tag_id, uint16_t sequence)
+{
+  sli_app_publish_slot_t *slot;
+
+#if APP_PUBLISH_QUEUE_DROP_POLICY == APP_PUBLISH_QUEUE_DROP_POLICY_COALESCE_PER_TAG
+  for (uint32_t i = 0; i < sli_app_publish_queue_count; i++) {
+    slot = &sli_app_publish_queue[(sli_app_publish_queue_head + i) % APP_PUBLISH_QUEUE_SIZE];
+    if ((slot->kind == kind) && (slot->tag_id == tag_id)) {
+      sli_app_publish_queue_stats.coalesced++;
+      slot->sequence = sequence;
+      return &slot->message;
+    }
+  }
+#elif APP_PUBLISH_QUEUE_DROP_POLICY != APP_PUBLISH_QUEUE_DROP_POLICY_DROP_OLDEST
+  #error Unsupported APP_PUBLISH_QUEUE_DROP_POLICY!
+#endif
+
+  if (sli_app_publish_queue_count == APP_PUBLISH_QUEUE_SIZE) {
+    sli_app_publish_queue_head = (sli_app_publish_queue_head + 1) % APP_PUBLISH_QUEUE_SIZE;
+    sli_app_publish_queue_count--;
+    sli_app_publish_queue_stats.dropped++;
+  }
+
+  slot = &sli_app_publish_queue[(sli_app_publish_queue_head + sli_app_publish_queue_count) % APP_PUBLISH_QUEUE_SIZE];
+  slot->kind = kind;
+  slot->tag_id = tag_id;
+  slot->sequence = sequence;
+  sli_app_publish_queue_count++;
+  sli_app_publish_queue_stats.enqueued++;
+  return &slot->message;
+}
@@ -42,6 +42,16 @@ extern "C" {
   #define APP_MQTT_CLIENT_MESSAGE_PAYLOAD_SIZE   568
 #endif
 
+///Publish queue drop policies, applied when a new message is reported.
+#define APP_PUBLISH_QUEUE_DROP_POLICY_DROP_OLDEST      0 //the oldest message is dropped if the queue is full
+#define APP_PUBLISH_QUEUE_DROP_POLICY_COALESCE_PER_TAG 1 //a waiting message of the same tag and kind is replaced by the latest, drop oldest otherwise
+///Selected publish queue drop policy
+#define APP_PUBLISH_QUEUE_DROP_POLICY                  APP_PUBLISH_QUEUE_DROP_POLICY_COALESCE_PER_TAG
+///Number of messages in the publish queue, storage is allocated statically.
+#define APP_PUBLISH_QUEUE_SIZE                         8
+///Maximum number of messages published in one app_process_action() call.
+#define APP_PUBLISH_QUEUE_MAX_PUBLISH_PER_PASS         2
+
 //type definitions -------------------------------------------------------------
 ///Message buffer for the AOA data.
 //safe to use this even in a multi-threaded environment because sl_bt_aoa_on_*_report() is called from 1 thread.
@@ -52,6 +62,14 @@ typedef struct {
   uint32_t content_length; ///< Length of the content.
 } app_mqtt_data_t;
 
+///Publish queue counters.
+typedef struct {
+  uint32_t enqueued;  ///< Messages added to the queue.
+  uint32_t dropped;   ///< Messages dropped because the queue was full.
+  uint32_t coalesced; ///< Messages replaced by a later message of the same tag.
+  uint32_t published; ///< Messages passed to app_mqtt_client_publish().
+} app_publish_queue_stats_t;
+
 //global variables -------------------------------------------------------------
 //function prototypes ----------------------------------------------------------
 /**************************************************************************//**
@@ -64,6 +82,13 @@ void app_init(void);
  *****************************************************************************/
 void app_process_action(void);
 
+/**************************************************************************//**
+ * Gets the publish queue counters.
+ *
+ * @param[out] stats Counters since reset.
+ *****************************************************************************/
+void app_publish_queue_get_stats(app_publish_queue_stats_t *stats);
+
 /***************************************************************************//**
  * User shall implement this!
  * Publishes the requested message to the MQTT broker.
@@ -2,10 +2,24 @@
 
 #include <sl_common.h>
 #include "sl_bluetooth.h"
+#include "sl_bt_ncp_host.h"
 #include "sl_ncp_gatt.h"
+#include "sl_bluetooth_host_config.h"
+#if SL_BT_HOST_STEP_TIME_BUDGET_US > 0
+#include "sl_sleeptimer.h"
+
+static uint32_t sl_bt_step_budget_ticks;
+#endif
 
 void sl_bt_init(void)
 {
+#if SL_BT_HOST_STEP_TIME_BUDGET_US > 0
+  sl_bt_step_budget_ticks = (uint32_t)(((uint64_t)SL_BT_HOST_STEP_TIME_BUDGET_US
+                                        * sl_sleeptimer_get_timer_frequency()) / 1000000);
+  if (sl_bt_step_budget_ticks == 0) {
+    sl_bt_step_budget_ticks = 1;
+  }
+#endif
 }
 
 SL_WEAK void sl_bt_on_event(sl_bt_msg_t* evt)
@@ -31,13 +45,26 @@ SL_WEAK bool sl_bt_can_process_event(uint32_t len)
 
 void sl_bt_step(void)
 {
-  sl_bt_msg_t evt;
+  sl_bt_msg_t *evt;
+#if SL_BT_HOST_STEP_TIME_BUDGET_US > 0
+  uint32_t start = sl_sleeptimer_get_tick_count();
+#endif
 
-  // Pop (non-blocking) a Bluetooth stack event from event queue.
-  sl_status_t status = sl_bt_pop_event(&evt);
-  if(status != SL_STATUS_OK){
-    return;
+  // Drain the event queue up to the configured event count and time budget.
+  for (uint32_t i = 0; i < SL_BT_HOST_STEP_MAX_EVENTS; i++) {
+    // Borrow (non-blocking) a Bluetooth stack event from event queue,
+    // it is processed in place and its slot is freed afterwards.
+    sl_status_t status = sl_bt_borrow_event(&evt);
+    if(status != SL_STATUS_OK){
+      return;
+    }
+    sl_bt_process_event(evt);
+    sl_bt_release_event();
+#if SL_BT_HOST_STEP_TIME_BUDGET_US > 0
+    if ((sl_sleeptimer_get_tick_count() - start) >= sl_bt_step_budget_ticks) {
+      return;
+    }
+#endif
   }
-  sl_bt_process_event(&evt);
 }
 #endif // !defined(SL_CATALOG_KERNEL_PRESENT)
@@ -28,6 +28,7 @@
  *
  ******************************************************************************/
 
+#include <assert.h>
 #include <stdbool.h>
 #include <stdint.h>
 #include <string.h>
@@ -35,6 +36,7 @@
 
 #include "aoa_angle.h"
 #include "aoa_angle_config.h"
+#include "aoa_iq_preprocess.h"
 #include "app_log.h"
 
 // -----------------------------------------------------------------------------
@@ -45,21 +47,39 @@
 #define GUARD_PERIOD_US          4
 #define REFERENCE_PERIOD_US      8
 #define REFERENCE_PERIOD_SAMPLES 8
+// Reference period samples per measurement sample.
+#define REFERENCE_DOWNSAMPLING   2.0f
+
+#define PI_F                     3.14159265358979f
+
+// cos^2 of the largest accepted phase rotation residual, the Taylor series
+// keeps it a constant expression.
+#define PHASE_ROTATION_RESIDUAL_SQ (AOA_ANGLE_PHASE_ROTATION_MAX_RESIDUAL \
+                                    * AOA_ANGLE_PHASE_ROTATION_MAX_RESIDUAL)
+#define PHASE_ROTATION_RESIDUAL_COS2 (1.0f - PHASE_ROTATION_RESIDUAL_SQ \
+                                      + (PHASE_ROTATION_RESIDUAL_SQ     \
+                                         * PHASE_ROTATION_RESIDUAL_SQ / 3.0f))
 
 #define QUALITY_BUFFER_SIZE      100
 
+// Scales the raw 8-bit IQ samples into the [-1, 1] range.
+#define IQ_SAMPLE_SCALE          (1.0f / 127.0f)
+
+// Alignment of the sample data inside the sample slab.
+#define SAMPLE_SLAB_ALIGNMENT    16
+
 // -----------------------------------------------------------------------------
 // Type definitions
 
-typedef struct aoa_angle_config_node_s aoa_angle_config_node_t;
 struct aoa_angle_config_node_s {
   aoa_id_t id;
   aoa_angle_config_t aoa_angle_config;
   aoa_angle_config_node_t *next;
   float ref_i_samples[REFERENCE_PERIOD_SAMPLES];
   float ref_q_samples[REFERENCE_PERIOD_SAMPLES];
-  float **i_samples;
-  float **q_samples;
+  float **i_samples;    // Row pointers into sample_slab
+  float **q_samples;    // Row pointers into sample_slab
+  void *sample_slab;    // Row pointers and sample data in one allocation
   size_t sample_rows;
   size_t sample_cols;
 };
@@ -70,22 +90,38 @@ struct aoa_angle_config_node_s {
 // Linked list head
 static aoa_angle_config_node_t *head_config = NULL;
 
+// Incremented on every config change, invalidates the configs pinned in aoa_state_t
+static uint32_t config_generation = 0;
+
 // -----------------------------------------------------------------------------
 // Private function declarations
 
-static sl_status_t allocate_2D_float_buffer(float*** buf,
-                                            size_t rows,
-                                            size_t cols);
-static void free_2D_float_buffer(float** buf, size_t rows);
+static sl_status_t allocate_sample_slab(aoa_angle_config_node_t *node,
+                                        size_t rows,
+                                        size_t cols);
 static sl_status_t allocate_sample_buffers(aoa_angle_config_node_t *node);
 static void free_sample_buffers(aoa_angle_config_node_t *node);
 static void free_masks(aoa_mask_node_t *mask_head);
 static void get_samples(aoa_iq_report_t *iq_report,
                         aoa_angle_config_node_t *node);
 static float channel_to_frequency(uint8_t channel);
+static enum sl_rtl_error_code get_phase_rotation(aoa_state_t *aoa_state,
+                                                 aoa_angle_config_node_t *node,
+                                                 uint8_t channel,
+                                                 float *phase_rotation);
+#if AOA_ANGLE_PHASE_ROTATION_CACHE
+static enum sl_rtl_error_code get_cached_phase_rotation(aoa_state_t *aoa_state,
+                                                        aoa_angle_config_node_t *node,
+                                                        uint8_t channel,
+                                                        float *phase_rotation);
+static float wrap_phase(float phase);
+#endif
 static sl_status_t aoa_angle_set_default_config(aoa_angle_config_t *aoa_angle_config);
 static sl_status_t aoa_angle_finalize_node(aoa_angle_config_node_t *node);
 static sl_status_t aoa_angle_find(aoa_id_t id, aoa_angle_config_node_t **node);
+static sl_status_t aoa_angle_find_pinned(aoa_state_t *aoa_state,
+                                         aoa_id_t id,
+                                         aoa_angle_config_node_t **node);
 
 // -----------------------------------------------------------------------------
 // Public function definitions
@@ -111,6 +147,7 @@ sl_status_t aoa_angle_add_config(aoa_id_t id,
   aoa_id_copy(new->id, id);
   new->next = head_config;
   head_config = new;
+  config_generation++;
   if (NULL != config) {
     *config = &(new->aoa_angle_config);
   }
@@ -118,6 +155,7 @@ sl_status_t aoa_angle_add_config(aoa_id_t id,
   // Initialize sample buffers
   new->i_samples = NULL;
   new->q_samples = NULL;
+  new->sample_slab = NULL;
   new->sample_rows = 0;
   new->sample_cols = 0;
 
@@ -150,6 +188,7 @@ sl_status_t aoa_angle_add_azimuth_mask(aoa_id_t config_id,
 
       new->next = aoa_angle_config->azimuth_mask_head;
       aoa_angle_config->azimuth_mask_head = new;
+      config_generation++;
     }
   }
   return sc;
@@ -177,6 +216,7 @@ sl_status_t aoa_angle_add_elevation_mask(aoa_id_t config_id,
 
       new->next = aoa_angle_config->elevation_mask_head;
       aoa_angle_config->elevation_mask_head = new;
+      config_generation++;
     }
   }
   return sc;
@@ -194,6 +234,7 @@ sl_status_t aoa_angle_reset_azimuth_masks(aoa_id_t id)
   if (SL_STATUS_OK == sc) {
     free_masks(aoa_angle_config->azimuth_mask_head);
     aoa_angle_config->azimuth_mask_head = NULL;
+    config_generation++;
   }
 
   return sc;
@@ -211,6 +252,7 @@ sl_status_t aoa_angle_reset_elevation_masks(aoa_id_t id)
   if (SL_STATUS_OK == sc) {
     free_masks(aoa_angle_config->elevation_mask_head);
     aoa_angle_config->elevation_mask_head = NULL;
+    config_generation++;
   }
 
   return sc;
@@ -223,6 +265,8 @@ void aoa_angle_reset_configs(void)
 {
   aoa_angle_config_node_t *current = head_config;
 
+  config_generation++;
+
   while (NULL != current) {
     // At the end of the iteration, head will be automatically set to NULL.
     head_config = current->next;
@@ -261,6 +305,7 @@ sl_status_t aoa_angle_finalize_config(aoa_id_t id)
 
   sc = aoa_angle_find(id, &node);
   if (sc == SL_STATUS_OK) {
+    config_generation++;
     sc = aoa_angle_finalize_node(node);
   }
 
@@ -274,95 +319,50 @@ enum sl_rtl_error_code aoa_init_rtl(aoa_state_t *aoa_state,
                                     aoa_id_t config_id,
                                     bool qa_enable)
 {
+  enum sl_rtl_error_code ec;
   sl_status_t sc;
+  aoa_angle_config_node_t *node;
   aoa_angle_config_t *aoa_angle_config = NULL;
-  aoa_mask_node_t *current_azimuth;
-  aoa_mask_node_t *current_elevation;
-  uint32_t antenna_switch_pattern[ANTENNA_ARRAY_MAX_PATTERN_SIZE];
-  uint32_t antenna_switch_pattern_size = sizeof(antenna_switch_pattern) / sizeof(uint32_t);
-
-  sc = aoa_angle_get_config(config_id, &aoa_angle_config);
-  if (SL_STATUS_OK != sc) {
-    return SL_RTL_ERROR_ARGUMENT;
-  }
 
-  sc = antenna_array_get_continuous_pattern(&aoa_angle_config->antenna_array,
-                                            antenna_switch_pattern,
-                                            &antenna_switch_pattern_size);
+  // Resolve the config once, the per packet calls use the pinned node.
+  aoa_state->config = NULL;
+  sc = aoa_angle_find_pinned(aoa_state, config_id, &node);
   if (SL_STATUS_OK != sc) {
     return SL_RTL_ERROR_ARGUMENT;
   }
+  aoa_angle_config = &node->aoa_angle_config;
+  aoa_id_copy(aoa_state->config_id, config_id);
 
-  current_azimuth = aoa_angle_config->azimuth_mask_head;
-  current_elevation = aoa_angle_config->elevation_mask_head;
-
-  enum sl_rtl_error_code ec;
-  // Initialize AoX library
-  ec = sl_rtl_aox_init(&aoa_state->libitem);
-  CHECK_ERROR(ec);
-  // Set the number of snapshots, i.e. how many times the antennas are scanned
-  // during one measurement
-  ec = sl_rtl_aox_set_num_snapshots(&aoa_state->libitem,
-                                    aoa_angle_config->num_snapshots);
-  CHECK_ERROR(ec);
-  // Set the antenna array type
-  ec = sl_rtl_aox_set_array_type(&aoa_state->libitem,
-                                 aoa_angle_config->antenna_array.array_type);
-  CHECK_ERROR(ec);
-  // Select mode (high speed/high accuracy/etc.)
-  ec = sl_rtl_aox_set_mode(&aoa_state->libitem,
-                           aoa_angle_config->aox_mode);
-  CHECK_ERROR(ec);
-
+  // The handler keeps its backend even if the config selects another one later.
+  aoa_state->estimator = aoa_angle_config->estimator;
   aoa_state->qa_enable = qa_enable;
-  if (qa_enable) {
-    // Enable IQ sample quality analysis processing
-    ec = sl_rtl_aox_iq_sample_qa_configure(&aoa_state->libitem);
-    CHECK_ERROR(ec);
-  }
-
-  // Add azimuth constraints
-  while (current_azimuth != NULL) {
-    ec = sl_rtl_aox_add_constraint(&aoa_state->libitem,
-                                   SL_RTL_AOX_CONSTRAINT_TYPE_AZIMUTH,
-                                   current_azimuth->min,
-                                   current_azimuth->max);
-    CHECK_ERROR(ec);
-    current_azimuth = current_azimuth->next;
-  }
-
-  // Add elevation constraints
-  while (current_elevation != NULL) {
-    ec = sl_rtl_aox_add_constraint(&aoa_state->libitem,
-                                   SL_RTL_AOX_CONSTRAINT_TYPE_ELEVATION,
-                                   current_elevation->min,
-                                   current_elevation->max);
-    CHECK_ERROR(ec);
-    current_elevation = current_elevation->next;
+#if AOA_ANGLE_PHASE_ROTATION_CACHE
+  memset(aoa_state->phase_rotation_cache, 0, sizeof(aoa_state->phase_rotation_cache));
+#endif
+  // The estimator releases its own partial state if init fails.
+  ec = aoa_state->estimator->init(aoa_state, aoa_angle_config);
+  if (SL_RTL_ERROR_SUCCESS != ec) {
+    aoa_state->config = NULL;
+    return ec;
   }
 
-  // Create AoX estimator
-  ec = sl_rtl_aox_create_estimator(&aoa_state->libitem);
-  CHECK_ERROR(ec);
-  // Set the switching pattern mode
-  ec = sl_rtl_aox_set_switch_pattern_mode(&aoa_state->libitem, SL_RTL_AOX_SWITCH_PATTERN_MODE_EXTERNAL);
-  CHECK_ERROR(ec);
-  if (antenna_array_type_is_dp(aoa_angle_config->antenna_array.array_type)) {
-    // Skip samples from the reference antenna.
-    ec = sl_rtl_aox_set_switch_pattern_mode(&aoa_state->libitem, SL_RTL_AOX_SWITCH_PATTERN_MODE_EXTRA_REFERENCE);
-    CHECK_ERROR(ec);
-  }
-  // Set the switching pattern
-  ec = sl_rtl_aox_update_switch_pattern(&aoa_state->libitem, antenna_switch_pattern, NULL);
-  CHECK_ERROR(ec);
   if (aoa_angle_config->angle_filtering == true) {
     // Initialize an util item
     ec = sl_rtl_util_init(&aoa_state->util_libitem);
-    CHECK_ERROR(ec);
-    ec = sl_rtl_util_set_parameter(&aoa_state->util_libitem,
-                                   SL_RTL_UTIL_PARAMETER_AMOUNT_OF_FILTERING,
-                                   aoa_angle_config->angle_filtering_weight);
-    CHECK_ERROR(ec);
+    if (SL_RTL_ERROR_SUCCESS == ec) {
+      ec = sl_rtl_util_set_parameter(&aoa_state->util_libitem,
+                                     SL_RTL_UTIL_PARAMETER_AMOUNT_OF_FILTERING,
+                                     aoa_angle_config->angle_filtering_weight);
+      if (SL_RTL_ERROR_SUCCESS != ec) {
+        (void)sl_rtl_util_deinit(&aoa_state->util_libitem);
+      }
+    }
+    if (SL_RTL_ERROR_SUCCESS != ec) {
+      // Leave nothing behind, a failed handler is not deinitialized.
+      (void)aoa_state->estimator->deinit(aoa_state);
+      aoa_state->config = NULL;
+      return ec;
+    }
   }
   // Initialize correction timeout counter
   aoa_state->correction_timeout = 0;
@@ -379,15 +379,16 @@ enum sl_rtl_error_code aoa_calculate(aoa_state_t *aoa_state,
                                      aoa_id_t config_id)
 {
   enum sl_rtl_error_code ec;
-  float phase_rotation;
+  const aoa_estimator_t *estimator = aoa_state->estimator;
   sl_status_t sc;
   aoa_angle_config_node_t *node;
   aoa_angle_config_t *aoa_angle_config;
+  float phase_rotation;
   uint32_t quality;
   char quality_buffer[QUALITY_BUFFER_SIZE];
   char* quality_string;
 
-  sc = aoa_angle_find(config_id, &node);
+  sc = aoa_angle_find_pinned(aoa_state, config_id, &node);
   if (SL_STATUS_OK != sc) {
     return SL_RTL_ERROR_ARGUMENT;
   }
@@ -397,24 +398,17 @@ enum sl_rtl_error_code aoa_calculate(aoa_state_t *aoa_state,
   // Copy IQ samples into preallocated buffers.
   get_samples(iq_report, node);
 
-  // Calculate phase rotation from reference IQ samples.
-  ec = sl_rtl_aox_calculate_iq_sample_phase_rotation(&aoa_state->libitem,
-                                                     2.0f,
-                                                     node->ref_i_samples,
-                                                     node->ref_q_samples,
-                                                     REFERENCE_PERIOD_SAMPLES,
-                                                     &phase_rotation);
+  // Calculate phase rotation from reference IQ samples and provide it to the
+  // estimator.
+  ec = get_phase_rotation(aoa_state, node, iq_report->channel, &phase_rotation);
   CHECK_ERROR(ec);
-
-  // Provide calculated phase rotation to the estimator.
-  ec = sl_rtl_aox_set_iq_sample_phase_rotation(&aoa_state->libitem,
-                                               phase_rotation);
+  ec = estimator->set_phase_rotation(aoa_state, phase_rotation);
   CHECK_ERROR(ec);
 
   // Estimate Angle of Arrival from IQ samples.
-  // sl_rtl_aox_process will return SL_RTL_ERROR_ESTIMATION_IN_PROGRESS
+  // The RTL estimator will return SL_RTL_ERROR_ESTIMATION_IN_PROGRESS
   // until it has received enough packets for angle estimation.
-  ec = sl_rtl_aox_process(&aoa_state->libitem,
+  ec = estimator->process(aoa_state,
                           node->i_samples,
                           node->q_samples,
                           channel_to_frequency(iq_report->channel),
@@ -422,9 +416,9 @@ enum sl_rtl_error_code aoa_calculate(aoa_state_t *aoa_state,
                           &angle->elevation);
   CHECK_ERROR(ec);
 
-  ec = sl_rtl_aox_get_latest_aoa_standard_deviation(&aoa_state->libitem,
-                                                    &angle->azimuth_stdev,
-                                                    &angle->elevation_stdev);
+  ec = estimator->get_stdev(aoa_state,
+                            &angle->azimuth_stdev,
+                            &angle->elevation_stdev);
   CHECK_ERROR(ec);
 
   // Calculate distance from RSSI.
@@ -446,9 +440,9 @@ enum sl_rtl_error_code aoa_calculate(aoa_state_t *aoa_state,
   // Copy sequence counter.
   angle->sequence = iq_report->event_counter;
 
-  if (aoa_state->qa_enable) {
+  if (aoa_state->qa_enable && (NULL != estimator->get_quality)) {
     // Fetch the quality result.
-    quality = sl_rtl_aox_iq_sample_qa_get_results(&aoa_state->libitem);
+    quality = estimator->get_quality(aoa_state);
     if (quality != 0) {
       quality_string = sl_rtl_util_iq_sample_qa_code2string(quality_buffer,
                                                             sizeof(quality_buffer),
@@ -463,9 +457,9 @@ enum sl_rtl_error_code aoa_calculate(aoa_state_t *aoa_state,
   if (aoa_state->correction_timeout > 0) {
     // Decrement timeout counter.
     --aoa_state->correction_timeout;
-    if (aoa_state->correction_timeout == 0) {
+    if ((aoa_state->correction_timeout == 0) && (NULL != estimator->clear_correction)) {
       // Timer expired, clear correction values.
-      ec = sl_rtl_aox_clear_expected_direction(&aoa_state->libitem);
+      ec = estimator->clear_correction(aoa_state);
     }
   }
   return ec;
@@ -480,26 +474,76 @@ enum sl_rtl_error_code aoa_set_correction(aoa_state_t *aoa_state,
 {
   enum sl_rtl_error_code ec;
   sl_status_t sc;
+  aoa_angle_config_node_t *node;
   aoa_angle_config_t *aoa_angle_config = NULL;
 
-  sc = aoa_angle_get_config(config_id, &aoa_angle_config);
+  sc = aoa_angle_find_pinned(aoa_state, config_id, &node);
   if (SL_STATUS_OK != sc) {
     return SL_RTL_ERROR_ARGUMENT;
   }
+  aoa_angle_config = &node->aoa_angle_config;
 
-  ec = sl_rtl_aox_set_expected_direction(&aoa_state->libitem,
-                                         correction->azimuth,
-                                         correction->elevation);
-  CHECK_ERROR(ec);
-  ec = sl_rtl_aox_set_expected_deviation(&aoa_state->libitem,
-                                         correction->azimuth_stdev,
-                                         correction->elevation_stdev);
+  if (NULL == aoa_state->estimator->set_correction) {
+    return SL_RTL_ERROR_FEATURE_NOT_SUPPORTED;
+  }
+  ec = aoa_state->estimator->set_correction(aoa_state, correction);
   CHECK_ERROR(ec);
 
   aoa_state->correction_timeout = aoa_angle_config->angle_correction_timeout;
   return ec;
 }
 
+/***************************************************************************//**
+ * Reset angle calculation libraries for reuse
+ ******************************************************************************/
+enum sl_rtl_error_code aoa_reset_rtl(aoa_state_t *aoa_state,
+                                     aoa_id_t config_id)
+{
+  enum sl_rtl_error_code ec;
+  sl_status_t sc;
+  aoa_angle_config_node_t *node;
+  aoa_angle_config_t *aoa_angle_config = NULL;
+
+  // The estimator was built from the config of its init, another config or
+  // any config change since then needs a full init instead.
+  if ((aoa_id_compare(aoa_state->config_id, config_id) != 0)
+      || (NULL == aoa_state->config)
+      || (aoa_state->config_generation != config_generation)) {
+    return SL_RTL_ERROR_ARGUMENT;
+  }
+  sc = aoa_angle_find_pinned(aoa_state, config_id, &node);
+  if (SL_STATUS_OK != sc) {
+    return SL_RTL_ERROR_ARGUMENT;
+  }
+  aoa_angle_config = &node->aoa_angle_config;
+
+  ec = aoa_state->estimator->reset(aoa_state);
+  CHECK_ERROR(ec);
+#if AOA_ANGLE_PHASE_ROTATION_CACHE
+  memset(aoa_state->phase_rotation_cache, 0, sizeof(aoa_state->phase_rotation_cache));
+#endif
+  if ((aoa_state->correction_timeout > 0)
+      && (NULL != aoa_state->estimator->clear_correction)) {
+    ec = aoa_state->estimator->clear_correction(aoa_state);
+    CHECK_ERROR(ec);
+  }
+
+  if (aoa_angle_config->angle_filtering == true) {
+    // The util item has no reset, start its filter over.
+    ec = sl_rtl_util_deinit(&aoa_state->util_libitem);
+    CHECK_ERROR(ec);
+    ec = sl_rtl_util_init(&aoa_state->util_libitem);
+    CHECK_ERROR(ec);
+    ec = sl_rtl_util_set_parameter(&aoa_state->util_libitem,
+                                   SL_RTL_UTIL_PARAMETER_AMOUNT_OF_FILTERING,
+                                   aoa_angle_config->angle_filtering_weight);
+    CHECK_ERROR(ec);
+  }
+  aoa_state->correction_timeout = 0;
+
+  return ec;
+}
+
 /***************************************************************************//**
  * Deinitialize angle calculation libraries
  ******************************************************************************/
@@ -508,14 +552,16 @@ enum sl_rtl_error_code aoa_deinit_rtl(aoa_state_t *aoa_state,
 {
   enum sl_rtl_error_code ec;
   sl_status_t sc;
+  aoa_angle_config_node_t *node;
   aoa_angle_config_t *aoa_angle_config = NULL;
 
-  sc = aoa_angle_get_config(config_id, &aoa_angle_config);
+  sc = aoa_angle_find_pinned(aoa_state, config_id, &node);
   if (SL_STATUS_OK != sc) {
     return SL_RTL_ERROR_ARGUMENT;
   }
+  aoa_angle_config = &node->aoa_angle_config;
 
-  ec = sl_rtl_aox_deinit(&aoa_state->libitem);
+  ec = aoa_state->estimator->deinit(aoa_state);
   CHECK_ERROR(ec);
   if (aoa_angle_config->angle_filtering == true) {
     ec = sl_rtl_util_deinit(&aoa_state->util_libitem);
@@ -528,31 +574,37 @@ enum sl_rtl_error_code aoa_deinit_rtl(aoa_state_t *aoa_state,
 // -----------------------------------------------------------------------------
 // Private function declarations
 
-static sl_status_t allocate_2D_float_buffer(float*** buf, size_t rows, size_t cols)
+/**************************************************************************//**
+ * Allocates the I and Q sample matrices as one contiguous slab.
+ *
+ * The slab starts with the row pointers of both matrices, followed by the
+ * I then the Q samples, each stored row after row without gaps.
+ *****************************************************************************/
+static sl_status_t allocate_sample_slab(aoa_angle_config_node_t *node,
+                                        size_t rows,
+                                        size_t cols)
 {
-  *buf = malloc(sizeof(float*) * rows);
-  if (*buf == NULL) {
+  size_t pointers_size = 2 * rows * sizeof(float *);
+  size_t data_offset = (pointers_size + SAMPLE_SLAB_ALIGNMENT - 1)
+                       & ~(size_t)(SAMPLE_SLAB_ALIGNMENT - 1);
+  uint8_t *slab = malloc(data_offset + (2 * rows * cols * sizeof(float)));
+  if (slab == NULL) {
     return SL_STATUS_ALLOCATION_FAILED;
   }
 
+  float **row_pointers = (float **)slab;
+  float *data = (float *)(slab + data_offset);
+  node->i_samples = row_pointers;
+  node->q_samples = row_pointers + rows;
   for (size_t i = 0; i < rows; i++) {
-    (*buf)[i] = malloc(sizeof(float) * cols);
-    if ((*buf)[i] == NULL) {
-      return SL_STATUS_ALLOCATION_FAILED;
-    }
+    node->i_samples[i] = data + (i * cols);
+    node->q_samples[i] = data + ((rows + i) * cols);
   }
+  node->sample_slab = slab;
 
   return SL_STATUS_OK;
 }
 
-static void free_2D_float_buffer(float** buf, size_t rows)
-{
-  for (size_t i = 0; i < rows; i++) {
-    free(buf[i]);
-  }
-  free(buf);
-}
-
 static float channel_to_frequency(uint8_t channel)
 {
   static const uint8_t logical_to_physical_channel[40] = {
@@ -565,38 +617,135 @@ static float channel_to_frequency(uint8_t channel)
   return 2402000000 + 2000000 * logical_to_physical_channel[channel];
 }
 
-static void get_samples(aoa_iq_report_t *iq_report, aoa_angle_config_node_t *node)
+static enum sl_rtl_error_code get_phase_rotation(aoa_state_t *aoa_state,
+                                                 aoa_angle_config_node_t *node,
+                                                 uint8_t channel,
+                                                 float *phase_rotation)
 {
-  size_t index = 0;
-  // Write reference IQ samples into the IQ sample buffer (sampled on one antenna)
-  for (size_t sample = 0; sample < REFERENCE_PERIOD_SAMPLES; ++sample) {
-    node->ref_i_samples[sample] = iq_report->samples[index++] / 127.0;
-    if (index == iq_report->length) {
-      break;
-    }
-    node->ref_q_samples[sample] = iq_report->samples[index++] / 127.0;
-    if (index == iq_report->length) {
-      break;
+#if AOA_ANGLE_PHASE_ROTATION_CACHE
+  if (node->aoa_angle_config.phase_rotation_cache
+      && (channel < AOA_ANGLE_CHANNEL_COUNT)) {
+    return get_cached_phase_rotation(aoa_state, node, channel, phase_rotation);
+  }
+#else
+  (void)channel;
+#endif
+  return aoa_state->estimator->calculate_phase_rotation(aoa_state,
+                                                        REFERENCE_DOWNSAMPLING,
+                                                        node->ref_i_samples,
+                                                        node->ref_q_samples,
+                                                        REFERENCE_PERIOD_SAMPLES,
+                                                        phase_rotation);
+}
+
+#if AOA_ANGLE_PHASE_ROTATION_CACHE
+static enum sl_rtl_error_code get_cached_phase_rotation(aoa_state_t *aoa_state,
+                                                        aoa_angle_config_node_t *node,
+                                                        uint8_t channel,
+                                                        float *phase_rotation)
+{
+  enum sl_rtl_error_code ec;
+  const aoa_estimator_t *estimator = aoa_state->estimator;
+  const float *ref_i = node->ref_i_samples;
+  const float *ref_q = node->ref_q_samples;
+  // Even number of reference samples, a whole number of measurement samples
+  // apart. The rotation over it follows unambiguously from the cached one.
+  const size_t span = REFERENCE_PERIOD_SAMPLES - 2;
+  aoa_phase_rotation_cache_t *cache;
+  float estimate;
+  float angle;
+
+  cache = &aoa_state->phase_rotation_cache[channel];
+
+  if ((cache->age > 0) && (cache->age < AOA_ANGLE_PHASE_ROTATION_REFRESH_PACKETS)) {
+    // Rotation over the span, s[span] * conj(s[0]), projected on the one
+    // expected from the cached estimate. No trigonometry needed.
+    float rot_i = (ref_i[span] * ref_i[0]) + (ref_q[span] * ref_q[0]);
+    float rot_q = (ref_q[span] * ref_i[0]) - (ref_i[span] * ref_q[0]);
+    float match = (rot_i * cache->expected_i) + (rot_q * cache->expected_q);
+
+    if ((match > 0.0f)
+        && ((match * match)
+            >= (((rot_i * rot_i) + (rot_q * rot_q)) * PHASE_ROTATION_RESIDUAL_COS2))) {
+      cache->age++;
+      *phase_rotation = cache->phase_rotation;
+      return SL_RTL_ERROR_SUCCESS;
     }
+    // The rotation has moved away, drop the history.
+    cache->age = 0;
+  }
+
+  ec = estimator->calculate_phase_rotation(aoa_state,
+                                           REFERENCE_DOWNSAMPLING,
+                                           node->ref_i_samples,
+                                           node->ref_q_samples,
+                                           REFERENCE_PERIOD_SAMPLES,
+                                           &estimate);
+  CHECK_ERROR(ec);
+
+  if (cache->age == 0) {
+    cache->phase_rotation = estimate;
+  } else {
+    // Periodic refresh, smooth the noise of the single packet estimates.
+    cache->phase_rotation = wrap_phase(cache->phase_rotation
+                                       + (AOA_ANGLE_PHASE_ROTATION_SMOOTHING
+                                          * wrap_phase(estimate - cache->phase_rotation)));
+  }
+  angle = cache->phase_rotation * (float)span / REFERENCE_DOWNSAMPLING;
+  cache->expected_i = cosf(angle);
+  cache->expected_q = sinf(angle);
+  cache->age = 1;
+  *phase_rotation = cache->phase_rotation;
+
+  return SL_RTL_ERROR_SUCCESS;
+}
+
+// Wrap a phase difference into the [-pi, pi] range.
+static float wrap_phase(float phase)
+{
+  while (phase > PI_F) {
+    phase -= 2.0f * PI_F;
+  }
+  while (phase < -PI_F) {
+    phase += 2.0f * PI_F;
   }
+  return phase;
+}
+#endif
+
+static void get_samples(aoa_iq_report_t *iq_report, aoa_angle_config_node_t *node)
+{
   // The last reference sample is the first measurement sample too.
-  index = (REFERENCE_PERIOD_SAMPLES - 1) * 2;
+  const size_t measurement_offset = (REFERENCE_PERIOD_SAMPLES - 1) * 2;
+  const size_t pairs = iq_report->length / 2;
+  aoa_iq_factor_t factor;
+  size_t count;
+
+  // The estimator compensates the phase rotation itself, scale only.
+  aoa_iq_factor_init(&factor, IQ_SAMPLE_SCALE, 0.0f);
+
+  // Write reference IQ samples into the IQ sample buffer (sampled on one antenna)
+  count = (pairs < REFERENCE_PERIOD_SAMPLES) ? pairs : REFERENCE_PERIOD_SAMPLES;
+  aoa_iq_preprocess(iq_report->samples,
+                    count,
+                    &factor,
+                    node->ref_i_samples,
+                    node->ref_q_samples);
+
   // Write antenna IQ samples into the IQ sample buffer (sampled on all antennas)
-  for (size_t snapshot = 0; snapshot < node->sample_rows; ++snapshot) {
-    for (size_t antenna = 0; antenna < node->sample_cols; ++antenna) {
-      node->i_samples[snapshot][antenna] = iq_report->samples[index++] / 127.0;
-      if (index == iq_report->length) {
-        break;
-      }
-      node->q_samples[snapshot][antenna] = iq_report->samples[index++] / 127.0;
-      if (index == iq_report->length) {
-        break;
-      }
-    }
-    if (index == iq_report->length) {
-      break;
-    }
-  }
+  // The rows are contiguous, so the whole matrix is filled in one pass.
+  if ((iq_report->length <= measurement_offset) || (NULL == node->sample_slab)) {
+    return;
+  }
+  count = (iq_report->length - measurement_offset) / 2;
+  if (count > (node->sample_rows * node->sample_cols)) {
+    count = node->sample_rows * node->sample_cols;
+  }
+  aoa_iq_preprocess(&iq_report->samples[measurement_offset],
+                    count,
+                    &factor,
+                    node->i_samples[0],
+                    node->q_samples[0]);
 }
 
 /**************************************************************************//**
@@ -604,6 +753,11 @@ static void get_samples(aoa_iq_report_t *iq_report, aoa_angle_config_node_t *nod
  *****************************************************************************/
 static sl_status_t aoa_angle_set_default_config(aoa_angle_config_t *aoa_angle_config)
 {
+#if (AOA_ANGLE_ESTIMATOR == AOA_ANGLE_ESTIMATOR_PORTABLE)
+  aoa_angle_config->estimator = &aoa_estimator_portable;
+#else
+  aoa_angle_config->estimator = &aoa_estimator_rtl;
+#endif
   aoa_angle_config->aox_mode = AOA_ANGLE_AOX_MODE;
   aoa_angle_config->angle_filtering = true;
   aoa_angle_config->angle_filtering_weight = AOA_ANGLE_FILTERING_AMOUNT;
@@ -611,6 +765,7 @@ static sl_status_t aoa_angle_set_default_config(aoa_angle_config_t *aoa_angle_co
   aoa_angle_config->angle_correction_delay = AOA_ANGLE_MAX_CORRECTION_DELAY;
   aoa_angle_config->cte_min_length = AOA_ANGLE_CTE_MIN_LENGTH;
   aoa_angle_config->cte_slot_duration = AOA_ANGLE_CTE_SLOT_DURATION;
+  aoa_angle_config->phase_rotation_cache = (AOA_ANGLE_PHASE_ROTATION_CACHE != 0);
   aoa_angle_config->azimuth_mask_head = NULL;
   aoa_angle_config->elevation_mask_head = NULL;
   return antenna_array_init(&aoa_angle_config->antenna_array,
@@ -654,18 +809,13 @@ static sl_status_t allocate_sample_buffers(aoa_angle_config_node_t *node)
   // Reallocate sample buffers
   if ((node->sample_rows != cfg->num_snapshots)
       || (node->sample_cols != antenna_switch_pattern_size)) {
-    free_2D_float_buffer(node->i_samples, node->sample_rows);
-    free_2D_float_buffer(node->q_samples, node->sample_rows);
-    sc = allocate_2D_float_buffer(&node->i_samples,
-                                  cfg->num_snapshots,
-                                  antenna_switch_pattern_size);
-    if (SL_STATUS_OK != sc) {
-      return sc;
-    }
-    sc = allocate_2D_float_buffer(&node->q_samples,
-                                  cfg->num_snapshots,
-                                  antenna_switch_pattern_size);
+    free_sample_buffers(node);
+    sc = allocate_sample_slab(node,
+                              cfg->num_snapshots,
+                              antenna_switch_pattern_size);
     if (SL_STATUS_OK != sc) {
+      node->sample_rows = 0;
+      node->sample_cols = 0;
       return sc;
     }
     // Store new sample buffer dimensions
@@ -678,8 +828,10 @@ static sl_status_t allocate_sample_buffers(aoa_angle_config_node_t *node)
 
 static void free_sample_buffers(aoa_angle_config_node_t *node)
 {
-  free_2D_float_buffer(node->i_samples, node->sample_rows);
-  free_2D_float_buffer(node->q_samples, node->sample_rows);
+  free(node->sample_slab);
+  node->sample_slab = NULL;
+  node->i_samples = NULL;
+  node->q_samples = NULL;
 }
 
 static sl_status_t aoa_angle_find(aoa_id_t id, aoa_angle_config_node_t **node)
@@ -699,6 +851,40 @@ static sl_status_t aoa_angle_find(aoa_id_t id, aoa_angle_config_node_t **node)
   return SL_STATUS_NOT_FOUND;
 }
 
+/**************************************************************************//**
+ * Returns the config pinned in the angle calculation handler.
+ *
+ * The config is only looked up by its ID if it was not pinned yet or the
+ * configs have changed since it was pinned. A handler serves one config, the
+ * ID of the pinned config is only checked against the one asked for in debug
+ * builds, to keep string compares off the per packet path.
+ *****************************************************************************/
+static sl_status_t aoa_angle_find_pinned(aoa_state_t *aoa_state,
+                                         aoa_id_t id,
+                                         aoa_angle_config_node_t **node)
+{
+  sl_status_t sc;
+
+  if ((NULL != aoa_state->config)
+      && (aoa_state->config_generation == config_generation)) {
+#if DEBUG
+    assert(aoa_id_compare(aoa_state->config->id, id) == 0);
+#endif
+    *node = aoa_state->config;
+    return SL_STATUS_OK;
+  }
+
+  sc = aoa_angle_find(id, node);
+  if (SL_STATUS_OK == sc) {
+    aoa_state->config = *node;
+    aoa_state->config_generation = config_generation;
+  } else {
+    aoa_state->config = NULL;
+  }
+
+  return sc;
+}
+
 static void free_masks(aoa_mask_node_t *mask_head)
 {
   aoa_mask_node_t *current;
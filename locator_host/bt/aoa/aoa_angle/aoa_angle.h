@@ -42,17 +42,41 @@ extern "C" {
 #include "sl_status.h"
 #include "aoa_util.h"
 #include "antenna_array.h"
+#include "aoa_estimator.h"
+#include "aoa_angle_config.h"
 
 // Forward declaration
 typedef struct aoa_mask_node_s aoa_mask_node_t;
+typedef struct aoa_angle_config_node_s aoa_angle_config_node_t;
+
+/// Number of BLE channels, the phase rotation is cached per channel.
+#define AOA_ANGLE_CHANNEL_COUNT  40
+
+/// Phase rotation estimate of a tag on one channel.
+typedef struct {
+  float phase_rotation;  // Smoothed radians between two measurement samples
+  float expected_i;      // Expected rotation over the reference period
+  float expected_q;
+  uint16_t age;          // Packets since the last full estimation, 0 if empty
+} aoa_phase_rotation_cache_t;
 
 /// AoA angle estimation handler type, one instance for each asset tag.
-typedef struct aoa_state_s {
-  sl_rtl_aox_libitem libitem;
+struct aoa_state_s {
+  union {
+    sl_rtl_aox_libitem libitem;               // RTL estimator
+    aoa_estimator_portable_state_t portable;  // Portable estimator
+  };
   sl_rtl_util_libitem util_libitem;
+  const aoa_estimator_t *estimator;  // Backend the handler was initialized with
   uint8_t correction_timeout;
   bool qa_enable;
-} aoa_state_t;
+  aoa_angle_config_node_t *config;  // Config resolved at init, valid while config_generation matches
+  uint32_t config_generation;
+  aoa_id_t config_id;               // Config the estimator was initialized with
+#if AOA_ANGLE_PHASE_ROTATION_CACHE
+  aoa_phase_rotation_cache_t phase_rotation_cache[AOA_ANGLE_CHANNEL_COUNT];
+#endif
+};
 
 /// Elevation or azimuth mask min/max values.
 struct aoa_mask_node_s {
@@ -62,7 +86,8 @@ struct aoa_mask_node_s {
 };
 
 /// Locator specific configuration settings for AoA angle estimation.
-typedef struct aoa_angle_config_s {
+struct aoa_angle_config_s {
+  const aoa_estimator_t *estimator;
   enum sl_rtl_aox_mode aox_mode;
   bool angle_filtering;
   float angle_filtering_weight;
@@ -71,10 +96,11 @@ typedef struct aoa_angle_config_s {
   uint8_t num_snapshots;
   uint16_t cte_min_length;
   uint16_t cte_slot_duration;
+  bool phase_rotation_cache;
   aoa_mask_node_t *azimuth_mask_head;
   aoa_mask_node_t *elevation_mask_head;
   antenna_array_t antenna_array;
-} aoa_angle_config_t;
+};
 
 /**************************************************************************//**
  * Add a config to the config list.
@@ -165,6 +191,12 @@ sl_status_t aoa_angle_finalize_config(aoa_id_t id);
 /***************************************************************************//**
  * Initialize angle calculation libraries.
  *
+ * The config is resolved here and pinned in the handler, later calls only
+ * look it up again by its id after a config change. The later calls shall
+ * pass the same id, this is only asserted in debug builds.
+ * On failure the partial initialization is undone, the handler shall not be
+ * passed to aoa_deinit_rtl.
+ *
  * @param[in] aoa_state Angle calculation handler
  * @param[in] config config entry id
  * @param[in] qa_enable IQ sample quality analysis
@@ -175,6 +207,22 @@ enum sl_rtl_error_code aoa_init_rtl(aoa_state_t *aoa_state,
                                     aoa_id_t config_id,
                                     bool qa_enable);
 
+/***************************************************************************//**
+ * Reset an initialized handler so that it can serve a new asset tag.
+ *
+ * The estimator and the angle filter start over, the configuration done by
+ * @ref aoa_init_rtl is kept. This is much cheaper than a deinit and init pair.
+ *
+ * @param[in] aoa_state Angle calculation handler
+ * @param[in] config config entry id
+ *
+ * @return Status returned by the RTL library, SL_RTL_ERROR_ARGUMENT if the
+ *         handler was initialized with another config id or the config
+ *         changed since.
+ ******************************************************************************/
+enum sl_rtl_error_code aoa_reset_rtl(aoa_state_t *aoa_state,
+                                     aoa_id_t config_id);
+
 /***************************************************************************//**
  * Estimate angle data from IQ samples.
  *
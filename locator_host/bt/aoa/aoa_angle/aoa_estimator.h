@@ -0,0 +1,113 @@
+/***************************************************************************//**
+ * @file
+ * @brief Angle estimator backends of the AoA angle calculation.
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2024 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ ******************************************************************************/
+
+#ifndef AOA_ESTIMATOR_H
+#define AOA_ESTIMATOR_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include "sl_rtl_clib_api.h"
+#include "antenna_array.h"
+#include "aoa_types.h"
+
+// Forward declaration
+typedef struct aoa_state_s aoa_state_t;
+typedef struct aoa_angle_config_s aoa_angle_config_t;
+
+/// Per tag state of the portable estimator.
+typedef struct {
+  uint8_t element_antenna[ANTENNA_ARRAY_MAX_PIN_PATTERN_SIZE]; // Antenna of each pin pattern element
+  uint8_t element_count;
+  uint8_t dual_polarized;
+  uint8_t num_snapshots;
+  float phase_rotation;        // Radians between two measurement samples
+  float azimuth_mean;          // Exponentially weighted statistics of the estimates
+  float azimuth_variance;
+  float elevation_mean;
+  float elevation_variance;
+  uint32_t estimate_count;
+} aoa_estimator_portable_state_t;
+
+/// Angle estimator backend. The optional operations are NULL if not supported.
+typedef struct {
+  const char *name;
+  // Set up the estimator of a tag for the given config.
+  enum sl_rtl_error_code (*init)(aoa_state_t *aoa_state,
+                                 aoa_angle_config_t *config);
+  // Estimate the phase rotation between two measurement samples from the
+  // reference period samples.
+  enum sl_rtl_error_code (*calculate_phase_rotation)(aoa_state_t *aoa_state,
+                                                     float downsampling_factor,
+                                                     float *ref_i_samples,
+                                                     float *ref_q_samples,
+                                                     uint32_t num_samples,
+                                                     float *phase_rotation);
+  // Apply the phase rotation on the next process call.
+  enum sl_rtl_error_code (*set_phase_rotation)(aoa_state_t *aoa_state,
+                                               float phase_rotation);
+  // Estimate the direction from the snapshots x pin pattern sample matrices.
+  enum sl_rtl_error_code (*process)(aoa_state_t *aoa_state,
+                                    float **i_samples,
+                                    float **q_samples,
+                                    float frequency,
+                                    float *azimuth,
+                                    float *elevation);
+  // Standard deviation of the latest estimate.
+  enum sl_rtl_error_code (*get_stdev)(aoa_state_t *aoa_state,
+                                      float *azimuth_stdev,
+                                      float *elevation_stdev);
+  // Restart the estimation, keeping the configuration.
+  enum sl_rtl_error_code (*reset)(aoa_state_t *aoa_state);
+  // Release the resources of the estimator.
+  enum sl_rtl_error_code (*deinit)(aoa_state_t *aoa_state);
+  // Optional: expected direction from the positioning.
+  enum sl_rtl_error_code (*set_correction)(aoa_state_t *aoa_state,
+                                           const aoa_angle_t *correction);
+  // Optional: drop the expected direction.
+  enum sl_rtl_error_code (*clear_correction)(aoa_state_t *aoa_state);
+  // Optional: IQ sample quality analysis result of the latest estimate.
+  uint32_t (*get_quality)(aoa_state_t *aoa_state);
+} aoa_estimator_t;
+
+/// Silicon Labs RTL library, requires libaox.
+extern const aoa_estimator_t aoa_estimator_rtl;
+
+/// Portable C estimator based on the phase differences of neighbouring
+/// antennas. No corrections, constraints or IQ quality analysis.
+extern const aoa_estimator_t aoa_estimator_portable;
+
+#ifdef __cplusplus
+};
+#endif
+
+#endif // AOA_ESTIMATOR_H
@@ -0,0 +1,340 @@
+/***************************************************************************//**
+ * @file
+ * @brief Portable angle estimator based on antenna phase differences.
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2024 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ ******************************************************************************/
+
+#include <math.h>
+#include <string.h>
+
+#include "aoa_angle.h"
+#include "aoa_angle_config.h"
+
+// -----------------------------------------------------------------------------
+// Defines
+
+#define SPEED_OF_LIGHT           299792458.0f
+
+// Antennas are numbered row by row on the 4x4 boards.
+#define BOARD_COLUMNS            4
+#define BOARD_ANTENNAS           16
+
+// ANT_6_CP is the reference antenna of the dual polarized array.
+#define DP_REFERENCE_ANTENNA     5
+
+// Marks the elements that do not take part in the estimation.
+#define ELEMENT_SKIPPED          0xFF
+
+// Weight of the latest estimate in the statistics behind the deviation.
+#define STATISTICS_WEIGHT        0.2f
+
+// M_PI is not visible with _POSIX_C_SOURCE.
+#define PI_F                     3.14159265358979f
+#define RAD_TO_DEG(x)            ((x) * 180.0f / PI_F)
+
+// -----------------------------------------------------------------------------
+// Private function declarations
+
+static enum sl_rtl_error_code portable_init(aoa_state_t *aoa_state,
+                                            aoa_angle_config_t *config);
+static enum sl_rtl_error_code portable_calculate_phase_rotation(aoa_state_t *aoa_state,
+                                                                float downsampling_factor,
+                                                                float *ref_i_samples,
+                                                                float *ref_q_samples,
+                                                                uint32_t num_samples,
+                                                                float *phase_rotation);
+static enum sl_rtl_error_code portable_set_phase_rotation(aoa_state_t *aoa_state,
+                                                          float phase_rotation);
+static enum sl_rtl_error_code portable_process(aoa_state_t *aoa_state,
+                                               float **i_samples,
+                                               float **q_samples,
+                                               float frequency,
+                                               float *azimuth,
+                                               float *elevation);
+static enum sl_rtl_error_code portable_get_stdev(aoa_state_t *aoa_state,
+                                                 float *azimuth_stdev,
+                                                 float *elevation_stdev);
+static enum sl_rtl_error_code portable_reset(aoa_state_t *aoa_state);
+static enum sl_rtl_error_code portable_deinit(aoa_state_t *aoa_state);
+static void update_statistics(aoa_estimator_portable_state_t *state,
+                              float azimuth,
+                              float elevation);
+static float clamp_unit(float value);
+
+// -----------------------------------------------------------------------------
+// Public variables
+
+const aoa_estimator_t aoa_estimator_portable = {
+  .name = "portable",
+  .init = portable_init,
+  .calculate_phase_rotation = portable_calculate_phase_rotation,
+  .set_phase_rotation = portable_set_phase_rotation,
+  .process = portable_process,
+  .get_stdev = portable_get_stdev,
+  .reset = portable_reset,
+  .deinit = portable_deinit,
+  .set_correction = NULL,
+  .clear_correction = NULL,
+  .get_quality = NULL
+};
+
+// -----------------------------------------------------------------------------
+// Private function definitions
+
+static enum sl_rtl_error_code portable_init(aoa_state_t *aoa_state,
+                                            aoa_angle_config_t *config)
+{
+  aoa_estimator_portable_state_t *state = &aoa_state->portable;
+  antenna_array_t *antenna_array = &config->antenna_array;
+  uint8_t pattern_size;
+  sl_status_t sc;
+
+  sc = antenna_array_get_pin_pattern(antenna_array, NULL, &pattern_size);
+  if ((SL_STATUS_OK != sc) || (pattern_size < 2) || (config->num_snapshots == 0)) {
+    return SL_RTL_ERROR_ARGUMENT;
+  }
+
+  memset(state, 0, sizeof(*state));
+  state->element_count = pattern_size;
+  state->num_snapshots = config->num_snapshots;
+  state->dual_polarized = antenna_array_type_is_dp(antenna_array->array_type);
+
+  // Map the pin pattern elements back to antenna positions,
+  // see antenna_array_get_pin_pattern.
+  for (uint8_t e = 0; e < pattern_size; e++) {
+    if (!state->dual_polarized) {
+      state->element_antenna[e] = antenna_array->pattern[e];
+    } else if (e == 0) {
+      // The reference antenna sample repeats the reference period.
+      state->element_antenna[e] = ELEMENT_SKIPPED;
+    } else {
+      // Vertical and horizontal port of each antenna.
+      state->element_antenna[e] = antenna_array->pattern[(e - 1) / 2];
+    }
+    if ((state->element_antenna[e] != ELEMENT_SKIPPED)
+        && (state->element_antenna[e] >= BOARD_ANTENNAS)) {
+      return SL_RTL_ERROR_ARGUMENT;
+    }
+  }
+
+  return SL_RTL_ERROR_SUCCESS;
+}
+
+static enum sl_rtl_error_code portable_calculate_phase_rotation(aoa_state_t *aoa_state,
+                                                                float downsampling_factor,
+                                                                float *ref_i_samples,
+                                                                float *ref_q_samples,
+                                                                uint32_t num_samples,
+                                                                float *phase_rotation)
+{
+  float sum_i = 0.0f;
+  float sum_q = 0.0f;
+
+  (void)aoa_state;
+  if (num_samples < 2) {
+    return SL_RTL_ERROR_ARGUMENT;
+  }
+
+  // Average rotation between the reference samples, s[n] * conj(s[n - 1]).
+  for (uint32_t n = 1; n < num_samples; n++) {
+    sum_i += (ref_i_samples[n] * ref_i_samples[n - 1]) + (ref_q_samples[n] * ref_q_samples[n - 1]);
+    sum_q += (ref_q_samples[n] * ref_i_samples[n - 1]) - (ref_i_samples[n] * ref_q_samples[n - 1]);
+  }
+  *phase_rotation = atan2f(sum_q, sum_i) * downsampling_factor;
+
+  return SL_RTL_ERROR_SUCCESS;
+}
+
+static enum sl_rtl_error_code portable_set_phase_rotation(aoa_state_t *aoa_state,
+                                                          float phase_rotation)
+{
+  aoa_state->portable.phase_rotation = phase_rotation;
+
+  return SL_RTL_ERROR_SUCCESS;
+}
+
+static enum sl_rtl_error_code portable_process(aoa_state_t *aoa_state,
+                                               float **i_samples,
+                                               float **q_samples,
+                                               float frequency,
+                                               float *azimuth,
+                                               float *elevation)
+{
+  aoa_estimator_portable_state_t *state = &aoa_state->portable;
+  // Coherent sum of the samples of each antenna, per polarization.
+  float antenna_i[2][BOARD_ANTENNAS] = { 0 };
+  float antenna_q[2][BOARD_ANTENNAS] = { 0 };
+  uint16_t antenna_used[2] = { 0 };
+  float x_i = 0.0f, x_q = 0.0f;
+  float y_i = 0.0f, y_q = 0.0f;
+  bool x_valid = false;
+  bool y_valid = false;
+
+  for (uint8_t r = 0; r < state->num_snapshots; r++) {
+    for (uint8_t c = 0; c < state->element_count; c++) {
+      uint8_t antenna = state->element_antenna[c];
+      if (antenna == ELEMENT_SKIPPED) {
+        continue;
+      }
+      uint8_t polarization = state->dual_polarized ? ((c - 1) % 2) : 0;
+      // Remove the rotation accumulated since the first measurement sample.
+      float angle = -state->phase_rotation * (float)((r * state->element_count) + c);
+      float rot_i = cosf(angle);
+      float rot_q = sinf(angle);
+      float i = i_samples[r][c];
+      float q = q_samples[r][c];
+      antenna_i[polarization][antenna] += (i * rot_i) - (q * rot_q);
+      antenna_q[polarization][antenna] += (i * rot_q) + (q * rot_i);
+      antenna_used[polarization] |= (uint16_t)(1 << antenna);
+    }
+  }
+
+  // Phase differences of the neighbouring antennas along both axes,
+  // s[right] * conj(s[left]) and s[down] * conj(s[up]).
+  for (uint8_t p = 0; p < 2; p++) {
+    for (uint8_t a = 0; a < BOARD_ANTENNAS; a++) {
+      if (!(antenna_used[p] & (1 << a))) {
+        continue;
+      }
+      uint8_t right = a + 1;
+      uint8_t down = a + BOARD_COLUMNS;
+      if (((a % BOARD_COLUMNS) != (BOARD_COLUMNS - 1)) && (antenna_used[p] & (1 << right))) {
+        x_i += (antenna_i[p][right] * antenna_i[p][a]) + (antenna_q[p][right] * antenna_q[p][a]);
+        x_q += (antenna_q[p][right] * antenna_i[p][a]) - (antenna_i[p][right] * antenna_q[p][a]);
+        x_valid = true;
+      }
+      if ((down < BOARD_ANTENNAS) && (antenna_used[p] & (1 << down))) {
+        y_i += (antenna_i[p][down] * antenna_i[p][a]) + (antenna_q[p][down] * antenna_q[p][a]);
+        y_q += (antenna_q[p][down] * antenna_i[p][a]) - (antenna_i[p][down] * antenna_q[p][a]);
+        y_valid = true;
+      }
+    }
+  }
+
+  if (!x_valid && !y_valid) {
+    return SL_RTL_ERROR_ARGUMENT;
+  }
+  if (((x_i == 0.0f) && (x_q == 0.0f)) && ((y_i == 0.0f) && (y_q == 0.0f))) {
+    // No signal, nothing to estimate from.
+    return SL_RTL_ERROR_INCORRECT_MEASUREMENT;
+  }
+
+  // Direction cosines of the arrival along the array axes.
+  float phase_per_spacing = 2.0f * PI_F * frequency * AOA_ANGLE_ANTENNA_SPACING / SPEED_OF_LIGHT;
+  float ux = x_valid ? clamp_unit(atan2f(x_q, x_i) / phase_per_spacing) : 0.0f;
+  float uy = y_valid ? clamp_unit(atan2f(y_q, y_i) / phase_per_spacing) : 0.0f;
+
+  if (x_valid && y_valid) {
+    // Elevation is measured from the array plane.
+    *elevation = RAD_TO_DEG(acosf(clamp_unit(sqrtf((ux * ux) + (uy * uy)))));
+    *azimuth = RAD_TO_DEG(atan2f(uy, ux));
+    if (*azimuth < 0.0f) {
+      *azimuth += 360.0f;
+    }
+  } else {
+    // A linear array only resolves the angle from its axis.
+    *azimuth = RAD_TO_DEG(acosf(x_valid ? ux : uy));
+    *elevation = 0.0f;
+  }
+
+  update_statistics(state, *azimuth, *elevation);
+
+  return SL_RTL_ERROR_SUCCESS;
+}
+
+static enum sl_rtl_error_code portable_get_stdev(aoa_state_t *aoa_state,
+                                                 float *azimuth_stdev,
+                                                 float *elevation_stdev)
+{
+  if (aoa_state->portable.estimate_count == 0) {
+    return SL_RTL_ERROR_ESTIMATION_IN_PROGRESS;
+  }
+  *azimuth_stdev = sqrtf(aoa_state->portable.azimuth_variance);
+  *elevation_stdev = sqrtf(aoa_state->portable.elevation_variance);
+
+  return SL_RTL_ERROR_SUCCESS;
+}
+
+static enum sl_rtl_error_code portable_reset(aoa_state_t *aoa_state)
+{
+  aoa_estimator_portable_state_t *state = &aoa_state->portable;
+
+  state->phase_rotation = 0.0f;
+  state->azimuth_mean = 0.0f;
+  state->azimuth_variance = 0.0f;
+  state->elevation_mean = 0.0f;
+  state->elevation_variance = 0.0f;
+  state->estimate_count = 0;
+
+  return SL_RTL_ERROR_SUCCESS;
+}
+
+static enum sl_rtl_error_code portable_deinit(aoa_state_t *aoa_state)
+{
+  // Nothing is allocated.
+  memset(&aoa_state->portable, 0, sizeof(aoa_state->portable));
+
+  return SL_RTL_ERROR_SUCCESS;
+}
+
+// Exponentially weighted mean and variance, the azimuth wraps around.
+static void update_statistics(aoa_estimator_portable_state_t *state,
+                              float azimuth,
+                              float elevation)
+{
+  if (state->estimate_count == 0) {
+    state->azimuth_mean = azimuth;
+    state->elevation_mean = elevation;
+  } else {
+    float azimuth_delta = remainderf(azimuth - state->azimuth_mean, 360.0f);
+    float elevation_delta = elevation - state->elevation_mean;
+
+    state->azimuth_mean = remainderf(state->azimuth_mean + (STATISTICS_WEIGHT * azimuth_delta), 360.0f);
+    if (state->azimuth_mean < 0.0f) {
+      state->azimuth_mean += 360.0f;
+    }
+    state->elevation_mean += STATISTICS_WEIGHT * elevation_delta;
+    state->azimuth_variance = (1.0f - STATISTICS_WEIGHT)
+                              * (state->azimuth_variance + (STATISTICS_WEIGHT * azimuth_delta * azimuth_delta));
+    state->elevation_variance = (1.0f - STATISTICS_WEIGHT)
+                                * (state->elevation_variance + (STATISTICS_WEIGHT * elevation_delta * elevation_delta));
+  }
+  if (state->estimate_count < UINT32_MAX) {
+    state->estimate_count++;
+  }
+}
+
+static float clamp_unit(float value)
+{
+  if (value > 1.0f) {
+    return 1.0f;
+  }
+  if (value < -1.0f) {
+    return -1.0f;
+  }
+  return value;
+}
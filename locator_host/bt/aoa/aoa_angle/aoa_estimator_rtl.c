@@ -0,0 +1,263 @@
+/***************************************************************************//**
+ * @file
+ * @brief Angle estimator backend on the Silicon Labs RTL library.
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2024 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ ******************************************************************************/
+
+#include <stddef.h>
+
+#include "aoa_angle.h"
+
+// -----------------------------------------------------------------------------
+// Defines
+
+#define CHECK_ERROR(x)           if ((x) != SL_RTL_ERROR_SUCCESS) return (x)
+
+// -----------------------------------------------------------------------------
+// Private function declarations
+
+static enum sl_rtl_error_code rtl_init(aoa_state_t *aoa_state,
+                                       aoa_angle_config_t *config);
+static enum sl_rtl_error_code rtl_configure(aoa_state_t *aoa_state,
+                                            aoa_angle_config_t *config,
+                                            uint32_t *antenna_switch_pattern);
+static enum sl_rtl_error_code rtl_calculate_phase_rotation(aoa_state_t *aoa_state,
+                                                           float downsampling_factor,
+                                                           float *ref_i_samples,
+                                                           float *ref_q_samples,
+                                                           uint32_t num_samples,
+                                                           float *phase_rotation);
+static enum sl_rtl_error_code rtl_set_phase_rotation(aoa_state_t *aoa_state,
+                                                     float phase_rotation);
+static enum sl_rtl_error_code rtl_process(aoa_state_t *aoa_state,
+                                          float **i_samples,
+                                          float **q_samples,
+                                          float frequency,
+                                          float *azimuth,
+                                          float *elevation);
+static enum sl_rtl_error_code rtl_get_stdev(aoa_state_t *aoa_state,
+                                            float *azimuth_stdev,
+                                            float *elevation_stdev);
+static enum sl_rtl_error_code rtl_reset(aoa_state_t *aoa_state);
+static enum sl_rtl_error_code rtl_deinit(aoa_state_t *aoa_state);
+static enum sl_rtl_error_code rtl_set_correction(aoa_state_t *aoa_state,
+                                                 const aoa_angle_t *correction);
+static enum sl_rtl_error_code rtl_clear_correction(aoa_state_t *aoa_state);
+static uint32_t rtl_get_quality(aoa_state_t *aoa_state);
+
+// -----------------------------------------------------------------------------
+// Public variables
+
+const aoa_estimator_t aoa_estimator_rtl = {
+  .name = "rtl",
+  .init = rtl_init,
+  .calculate_phase_rotation = rtl_calculate_phase_rotation,
+  .set_phase_rotation = rtl_set_phase_rotation,
+  .process = rtl_process,
+  .get_stdev = rtl_get_stdev,
+  .reset = rtl_reset,
+  .deinit = rtl_deinit,
+  .set_correction = rtl_set_correction,
+  .clear_correction = rtl_clear_correction,
+  .get_quality = rtl_get_quality
+};
+
+// -----------------------------------------------------------------------------
+// Private function definitions
+
+static enum sl_rtl_error_code rtl_init(aoa_state_t *aoa_state,
+                                       aoa_angle_config_t *config)
+{
+  enum sl_rtl_error_code ec;
+  sl_status_t sc;
+  uint32_t antenna_switch_pattern[ANTENNA_ARRAY_MAX_PATTERN_SIZE];
+  uint32_t antenna_switch_pattern_size = sizeof(antenna_switch_pattern) / sizeof(uint32_t);
+
+  sc = antenna_array_get_continuous_pattern(&config->antenna_array,
+                                            antenna_switch_pattern,
+                                            &antenna_switch_pattern_size);
+  if (SL_STATUS_OK != sc) {
+    return SL_RTL_ERROR_ARGUMENT;
+  }
+
+  // Initialize AoX library
+  ec = sl_rtl_aox_init(&aoa_state->libitem);
+  CHECK_ERROR(ec);
+
+  ec = rtl_configure(aoa_state, config, antenna_switch_pattern);
+  if (ec != SL_RTL_ERROR_SUCCESS) {
+    // Release the library item, a failed init is not deinitialized.
+    (void)sl_rtl_aox_deinit(&aoa_state->libitem);
+  }
+
+  return ec;
+}
+
+static enum sl_rtl_error_code rtl_configure(aoa_state_t *aoa_state,
+                                            aoa_angle_config_t *config,
+                                            uint32_t *antenna_switch_pattern)
+{
+  enum sl_rtl_error_code ec;
+  aoa_mask_node_t *current_azimuth = config->azimuth_mask_head;
+  aoa_mask_node_t *current_elevation = config->elevation_mask_head;
+
+  // Set the number of snapshots, i.e. how many times the antennas are scanned
+  // during one measurement
+  ec = sl_rtl_aox_set_num_snapshots(&aoa_state->libitem,
+                                    config->num_snapshots);
+  CHECK_ERROR(ec);
+  // Set the antenna array type
+  ec = sl_rtl_aox_set_array_type(&aoa_state->libitem,
+                                 config->antenna_array.array_type);
+  CHECK_ERROR(ec);
+  // Select mode (high speed/high accuracy/etc.)
+  ec = sl_rtl_aox_set_mode(&aoa_state->libitem,
+                           config->aox_mode);
+  CHECK_ERROR(ec);
+
+  if (aoa_state->qa_enable) {
+    // Enable IQ sample quality analysis processing
+    ec = sl_rtl_aox_iq_sample_qa_configure(&aoa_state->libitem);
+    CHECK_ERROR(ec);
+  }
+
+  // Add azimuth constraints
+  while (current_azimuth != NULL) {
+    ec = sl_rtl_aox_add_constraint(&aoa_state->libitem,
+                                   SL_RTL_AOX_CONSTRAINT_TYPE_AZIMUTH,
+                                   current_azimuth->min,
+                                   current_azimuth->max);
+    CHECK_ERROR(ec);
+    current_azimuth = current_azimuth->next;
+  }
+
+  // Add elevation constraints
+  while (current_elevation != NULL) {
+    ec = sl_rtl_aox_add_constraint(&aoa_state->libitem,
+                                   SL_RTL_AOX_CONSTRAINT_TYPE_ELEVATION,
+                                   current_elevation->min,
+                                   current_elevation->max);
+    CHECK_ERROR(ec);
+    current_elevation = current_elevation->next;
+  }
+
+  // Create AoX estimator
+  ec = sl_rtl_aox_create_estimator(&aoa_state->libitem);
+  CHECK_ERROR(ec);
+  // Set the switching pattern mode
+  ec = sl_rtl_aox_set_switch_pattern_mode(&aoa_state->libitem, SL_RTL_AOX_SWITCH_PATTERN_MODE_EXTERNAL);
+  CHECK_ERROR(ec);
+  if (antenna_array_type_is_dp(config->antenna_array.array_type)) {
+    // Skip samples from the reference antenna.
+    ec = sl_rtl_aox_set_switch_pattern_mode(&aoa_state->libitem, SL_RTL_AOX_SWITCH_PATTERN_MODE_EXTRA_REFERENCE);
+    CHECK_ERROR(ec);
+  }
+  // Set the switching pattern
+  ec = sl_rtl_aox_update_switch_pattern(&aoa_state->libitem, antenna_switch_pattern, NULL);
+
+  return ec;
+}
+
+static enum sl_rtl_error_code rtl_calculate_phase_rotation(aoa_state_t *aoa_state,
+                                                           float downsampling_factor,
+                                                           float *ref_i_samples,
+                                                           float *ref_q_samples,
+                                                           uint32_t num_samples,
+                                                           float *phase_rotation)
+{
+  return sl_rtl_aox_calculate_iq_sample_phase_rotation(&aoa_state->libitem,
+                                                       downsampling_factor,
+                                                       ref_i_samples,
+                                                       ref_q_samples,
+                                                       num_samples,
+                                                       phase_rotation);
+}
+
+static enum sl_rtl_error_code rtl_set_phase_rotation(aoa_state_t *aoa_state,
+                                                     float phase_rotation)
+{
+  return sl_rtl_aox_set_iq_sample_phase_rotation(&aoa_state->libitem,
+                                                 phase_rotation);
+}
+
+static enum sl_rtl_error_code rtl_process(aoa_state_t *aoa_state,
+                                          float **i_samples,
+                                          float **q_samples,
+                                          float frequency,
+                                          float *azimuth,
+                                          float *elevation)
+{
+  return sl_rtl_aox_process(&aoa_state->libitem,
+                            i_samples,
+                            q_samples,
+                            frequency,
+                            azimuth,
+                            elevation);
+}
+
+static enum sl_rtl_error_code rtl_get_stdev(aoa_state_t *aoa_state,
+                                            float *azimuth_stdev,
+                                            float *elevation_stdev)
+{
+  return sl_rtl_aox_get_latest_aoa_standard_deviation(&aoa_state->libitem,
+                                                      azimuth_stdev,
+                                                      elevation_stdev);
+}
+
+static enum sl_rtl_error_code rtl_reset(aoa_state_t *aoa_state)
+{
+  return sl_rtl_aox_reset_estimator(&aoa_state->libitem);
+}
+
+static enum sl_rtl_error_code rtl_deinit(aoa_state_t *aoa_state)
+{
+  return sl_rtl_aox_deinit(&aoa_state->libitem);
+}
+
+static enum sl_rtl_error_code rtl_set_correction(aoa_state_t *aoa_state,
+                                                 const aoa_angle_t *correction)
+{
+  enum sl_rtl_error_code ec;
+
+  ec = sl_rtl_aox_set_expected_direction(&aoa_state->libitem,
+                                         correction->azimuth,
+                                         correction->elevation);
+  CHECK_ERROR(ec);
+  return sl_rtl_aox_set_expected_deviation(&aoa_state->libitem,
+                                           correction->azimuth_stdev,
+                                           correction->elevation_stdev);
+}
+
+static enum sl_rtl_error_code rtl_clear_correction(aoa_state_t *aoa_state)
+{
+  return sl_rtl_aox_clear_expected_direction(&aoa_state->libitem);
+}
+
+static uint32_t rtl_get_quality(aoa_state_t *aoa_state)
+{
+  return sl_rtl_aox_iq_sample_qa_get_results(&aoa_state->libitem);
+}
@@ -0,0 +1,240 @@
+/***************************************************************************//**
+ * @file
+ * @brief Synthetic plane-wave IQ samples for benchmarks and accuracy checks.
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2024 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ ******************************************************************************/
+
+#include <math.h>
+
+#include "aoa_iq_gen.h"
+#include "aoa_angle_config.h"
+
+// -----------------------------------------------------------------------------
+// Defines
+
+// CTE timing, mirrors the sample layout parsed by aoa_angle.c.
+#define GUARD_PERIOD_US          4
+#define REFERENCE_PERIOD_US      8
+
+// The CTE is a constant tone 250 kHz above the carrier.
+#define CTE_TONE_HZ              250000.0f
+
+#define SPEED_OF_LIGHT           299792458.0f
+
+// Antennas are numbered row by row on the 4x4 boards.
+#define BOARD_COLUMNS            4
+#define BOARD_CENTER             1.5f
+
+// ANT_6_CP is the reference antenna of the dual polarized array.
+#define DP_REFERENCE_ANTENNA     5
+
+// M_PI is not visible with _POSIX_C_SOURCE.
+#define PI_F                     3.14159265358979f
+#define DEG_TO_RAD(x)            ((x) * PI_F / 180.0f)
+
+// -----------------------------------------------------------------------------
+// Private function declarations
+
+static float channel_to_frequency(uint8_t channel);
+static uint8_t get_antenna(antenna_array_t *antenna_array, size_t element);
+static float get_gaussian(uint32_t *random_state);
+static int8_t quantize(float value);
+
+// -----------------------------------------------------------------------------
+// Public function definitions
+
+/**************************************************************************//**
+ * Fill the generator configuration with defaults.
+ *****************************************************************************/
+void aoa_iq_gen_get_default_config(aoa_iq_gen_config_t *config)
+{
+  config->azimuth = 0.0f;
+  config->elevation = 90.0f;
+  config->channel = 37;
+  config->rssi = -60;
+  config->snr_db = 30.0f;
+  config->cfo_hz = 0.0f;
+  config->phase = 0.0f;
+  config->amplitude = 100.0f;
+  config->spacing = AOA_ANGLE_ANTENNA_SPACING;
+  config->cte_length = AOA_ANGLE_CTE_MIN_LENGTH;
+  config->slot_duration = AOA_ANGLE_CTE_SLOT_DURATION;
+}
+
+/**************************************************************************//**
+ * Number of IQ sample pairs in a generated report.
+ *****************************************************************************/
+size_t aoa_iq_gen_get_sample_count(const aoa_iq_gen_config_t *config)
+{
+  size_t cte_us = (size_t)config->cte_length * 8;
+
+  if ((config->slot_duration == 0)
+      || (cte_us <= (GUARD_PERIOD_US + REFERENCE_PERIOD_US))) {
+    return 0;
+  }
+  return AOA_IQ_GEN_REFERENCE_SAMPLES
+         + ((cte_us - GUARD_PERIOD_US - REFERENCE_PERIOD_US) / (2 * config->slot_duration));
+}
+
+/**************************************************************************//**
+ * Synthesize the IQ samples of a plane wave.
+ *****************************************************************************/
+sl_status_t aoa_iq_gen_generate(const aoa_iq_gen_config_t *config,
+                                antenna_array_t *antenna_array,
+                                uint32_t *random_state,
+                                int8_t *samples,
+                                size_t size,
+                                aoa_iq_report_t *iq_report)
+{
+  uint8_t pattern_size;
+  sl_status_t sc;
+
+  if ((config == NULL) || (antenna_array == NULL) || (random_state == NULL)
+      || (samples == NULL) || (iq_report == NULL)) {
+    return SL_STATUS_NULL_POINTER;
+  }
+  if ((config->channel > 39) || (*random_state == 0)) {
+    return SL_STATUS_INVALID_PARAMETER;
+  }
+
+  size_t count = aoa_iq_gen_get_sample_count(config);
+  if ((count == 0) || ((count * 2) > size) || ((count * 2) > UINT8_MAX)) {
+    return SL_STATUS_INVALID_RANGE;
+  }
+
+  sc = antenna_array_get_pin_pattern(antenna_array, NULL, &pattern_size);
+  if (sc != SL_STATUS_OK) {
+    return sc;
+  }
+
+  // Phase difference per meter along the axes.
+  float wavenumber = 2.0f * PI_F * channel_to_frequency(config->channel) / SPEED_OF_LIGHT;
+  float azimuth = DEG_TO_RAD(config->azimuth);
+  float elevation = DEG_TO_RAD(config->elevation);
+  float kx = wavenumber * cosf(elevation) * cosf(azimuth);
+  float ky = wavenumber * cosf(elevation) * sinf(azimuth);
+
+  // Baseband tone progression per us.
+  float tone = 2.0f * PI_F * (CTE_TONE_HZ + config->cfo_hz) * 1e-6f;
+
+  float noise = 0.0f;
+  if (isfinite(config->snr_db)) {
+    // Complex noise power is amplitude^2 / SNR, split between I and Q.
+    noise = config->amplitude / sqrtf(2.0f * powf(10.0f, config->snr_db / 10.0f));
+  }
+
+  for (size_t i = 0; i < count; i++) {
+    float time_us;
+    size_t element;
+
+    if (i < AOA_IQ_GEN_REFERENCE_SAMPLES) {
+      time_us = (float)(GUARD_PERIOD_US + i);
+      element = 0;
+    } else {
+      // The last reference sample is the first measurement sample too.
+      size_t slot = i - (AOA_IQ_GEN_REFERENCE_SAMPLES - 1);
+      time_us = (float)(GUARD_PERIOD_US + REFERENCE_PERIOD_US
+                        + (((2 * slot) - 1) * config->slot_duration));
+      element = slot % pattern_size;
+    }
+
+    uint8_t antenna = get_antenna(antenna_array, element);
+    float x = ((float)(antenna % BOARD_COLUMNS) - BOARD_CENTER) * config->spacing;
+    float y = ((float)(antenna / BOARD_COLUMNS) - BOARD_CENTER) * config->spacing;
+    float phase = config->phase + (tone * time_us) + (kx * x) + (ky * y);
+
+    samples[2 * i] = quantize((config->amplitude * cosf(phase)) + (noise * get_gaussian(random_state)));
+    samples[2 * i + 1] = quantize((config->amplitude * sinf(phase)) + (noise * get_gaussian(random_state)));
+  }
+
+  iq_report->channel = config->channel;
+  iq_report->rssi = config->rssi;
+  iq_report->length = (uint8_t)(count * 2);
+  iq_report->samples = samples;
+
+  return SL_STATUS_OK;
+}
+
+// -----------------------------------------------------------------------------
+// Private function definitions
+
+static float channel_to_frequency(uint8_t channel)
+{
+  // Advertising channels are spread over the band.
+  switch (channel) {
+    case 37:
+      return 2402e6f;
+    case 38:
+      return 2426e6f;
+    case 39:
+      return 2480e6f;
+    default:
+      break;
+  }
+  // Data channels skip the advertising channel 38.
+  return (channel < 11) ? (2404e6f + (2e6f * channel)) : (2406e6f + (2e6f * channel));
+}
+
+// Antenna number of an element in the pin pattern, see antenna_array_get_pin_pattern.
+static uint8_t get_antenna(antenna_array_t *antenna_array, size_t element)
+{
+  if (antenna_array_type_is_dp(antenna_array->array_type)) {
+    // Reference antenna, then the vertical and horizontal port of each antenna.
+    return (element == 0) ? DP_REFERENCE_ANTENNA : antenna_array->pattern[(element - 1) / 2];
+  }
+  return antenna_array->pattern[element];
+}
+
+// Standard normal sample from a xorshift32 generator (Box-Muller).
+static float get_gaussian(uint32_t *random_state)
+{
+  float uniform[2];
+
+  for (size_t i = 0; i < 2; i++) {
+    uint32_t x = *random_state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *random_state = x;
+    // (0, 1], avoids log(0)
+    uniform[i] = ((float)(x >> 8) + 1.0f) / 16777216.0f;
+  }
+  return sqrtf(-2.0f * logf(uniform[0])) * cosf(2.0f * PI_F * uniform[1]);
+}
+
+static int8_t quantize(float value)
+{
+  long rounded = lroundf(value);
+
+  if (rounded > INT8_MAX) {
+    return INT8_MAX;
+  }
+  if (rounded < INT8_MIN) {
+    return INT8_MIN;
+  }
+  return (int8_t)rounded;
+}
@@ -0,0 +1,112 @@
+/***************************************************************************//**
+ * @file
+ * @brief Synthetic plane-wave IQ samples for benchmarks and accuracy checks.
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2024 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ ******************************************************************************/
+
+#ifndef AOA_IQ_GEN_H
+#define AOA_IQ_GEN_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+#include "sl_status.h"
+#include "antenna_array.h"
+#include "aoa_types.h"
+
+// Number of IQ samples taken on the reference antenna.
+#define AOA_IQ_GEN_REFERENCE_SAMPLES  8
+
+/// Plane wave and CTE parameters.
+///
+/// The array lies in the x-y plane, the antennas are numbered row by row along
+/// the x axis. The wave arrives from the direction
+/// (cos(elevation) * cos(azimuth), cos(elevation) * sin(azimuth), sin(elevation)).
+typedef struct {
+  float azimuth;           ///< Azimuth in degrees.
+  float elevation;         ///< Elevation in degrees.
+  uint8_t channel;         ///< BLE channel, 0..39.
+  int8_t rssi;             ///< RSSI reported with the samples in dBm.
+  float snr_db;            ///< Signal to noise ratio, INFINITY for no noise.
+  float cfo_hz;            ///< Carrier frequency offset of the tag.
+  float phase;             ///< Carrier phase at the first sample in radians.
+  float amplitude;         ///< Signal amplitude in LSB, at most 127.
+  float spacing;           ///< Distance of the neighbouring antennas in meters.
+  uint8_t cte_length;      ///< CTE length in 8 us units.
+  uint8_t slot_duration;   ///< Switching and sampling slot in us (1 or 2).
+} aoa_iq_gen_config_t;
+
+/**************************************************************************//**
+ * Fill the generator configuration with defaults: broadside, channel 37,
+ * 30 dB SNR, no CFO, the antenna spacing and the CTE of aoa_angle_config.h.
+ *
+ * @param[out] config Configuration to fill.
+ *****************************************************************************/
+void aoa_iq_gen_get_default_config(aoa_iq_gen_config_t *config);
+
+/**************************************************************************//**
+ * Number of IQ sample pairs in a report generated with the given CTE.
+ *
+ * The reference period is followed by one sample in every sampling slot,
+ * the same layout as the one the angle estimation expects.
+ *
+ * @param[in] config Generator configuration.
+ * @return Number of IQ sample pairs.
+ *****************************************************************************/
+size_t aoa_iq_gen_get_sample_count(const aoa_iq_gen_config_t *config);
+
+/**************************************************************************//**
+ * Synthesize the IQ samples of a plane wave received on an antenna array.
+ *
+ * The antennas are switched according to the pin pattern of the array, the
+ * reference period is sampled on the first antenna of the pattern.
+ * The output only depends on the inputs, including the random state.
+ *
+ * @param[in] config Generator configuration.
+ * @param[in] antenna_array Antenna array and switch pattern.
+ * @param[in,out] random_state State of the noise generator, must not be 0.
+ * @param[out] samples Buffer for the interleaved IQ samples.
+ * @param[in] size Size of the buffer in bytes.
+ * @param[out] iq_report Report pointing to samples. The event counter is left
+ *                       to the caller.
+ * @return SL_STATUS_OK if successful. Error code otherwise.
+ *****************************************************************************/
+sl_status_t aoa_iq_gen_generate(const aoa_iq_gen_config_t *config,
+                                antenna_array_t *antenna_array,
+                                uint32_t *random_state,
+                                int8_t *samples,
+                                size_t size,
+                                aoa_iq_report_t *iq_report);
+
+#ifdef __cplusplus
+};
+#endif
+
+#endif // AOA_IQ_GEN_H
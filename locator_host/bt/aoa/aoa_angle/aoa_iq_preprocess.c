@@ -0,0 +1,369 @@
+/***************************************************************************//**
+ * @file
+ * @brief IQ sample preprocessing for AoA angle estimation.
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2024 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ ******************************************************************************/
+
+#include <math.h>
+#include <stdbool.h>
+
+#include "aoa_iq_preprocess.h"
+#include "aoa_angle_config.h"
+
+#if AOA_ANGLE_IQ_PREPROCESS_MVP
+#include "sl_mvp.h"
+#include "sl_mvp_program_area.h"
+#include "sl_math_types.h"
+#endif
+
+// -----------------------------------------------------------------------------
+// Defines
+
+// The raw samples are handled as Q7 values, the results are Q15.
+#define Q7_FRACTION_BITS         7
+#define Q15_FRACTION_BITS        15
+#define Q15_ONE                  32768.0f
+
+// Sample pairs converted per chunk on the stack in aoa_iq_preprocess.
+#define Q15_CHUNK_SAMPLES        64
+
+// Relative precision of half precision floats, 2^-10.
+#define F16_EPSILON              0.0009765625f
+
+// -----------------------------------------------------------------------------
+// Private function declarations
+
+static inline int16_t saturate_q15(int32_t value);
+#if AOA_ANGLE_IQ_PREPROCESS_MVP
+static bool mvp_matches_reference(const int8_t *samples,
+                                  size_t count,
+                                  const aoa_iq_factor_t *factor,
+                                  const float *i_samples,
+                                  const float *q_samples);
+#endif
+
+// -----------------------------------------------------------------------------
+// Private variables
+
+#if AOA_ANGLE_IQ_PREPROCESS_MVP
+// Half precision output of the MVP, widened to float on the CPU.
+static sl_math_complex_f16_t mvp_output[AOA_ANGLE_IQ_PREPROCESS_MVP_MAX_SAMPLES] __attribute__((aligned(4)));
+
+// The first MVP result is checked against the reference, the MVP is not used
+// any more if they differ.
+static enum {
+  MVP_UNCHECKED,
+  MVP_CHECKED,
+  MVP_MISMATCH
+} mvp_check = MVP_UNCHECKED;
+#endif
+
+// -----------------------------------------------------------------------------
+// Public function definitions
+
+/**************************************************************************//**
+ * Set up a preprocessing factor.
+ *****************************************************************************/
+void aoa_iq_factor_init(aoa_iq_factor_t *factor, float scale, float phase)
+{
+  if (phase == 0.0f) {
+    // Keep the pure scaling exact.
+    factor->real = scale;
+    factor->imag = 0.0f;
+    return;
+  }
+  factor->real = scale * cosf(phase);
+  factor->imag = -scale * sinf(phase);
+}
+
+/**************************************************************************//**
+ * Convert, scale and derotate IQ samples.
+ *****************************************************************************/
+void aoa_iq_preprocess(const int8_t *samples,
+                       size_t count,
+                       const aoa_iq_factor_t *factor,
+                       float *i_samples,
+                       float *q_samples)
+{
+#if AOA_ANGLE_IQ_PREPROCESS_MVP
+  if ((mvp_check != MVP_MISMATCH)
+      && (aoa_iq_preprocess_mvp(samples, count, factor, i_samples, q_samples) == SL_STATUS_OK)) {
+    if (mvp_check == MVP_CHECKED) {
+      return;
+    }
+    if (mvp_matches_reference(samples, count, factor, i_samples, q_samples)) {
+      mvp_check = MVP_CHECKED;
+      return;
+    }
+    // Overwritten by the other paths below.
+    mvp_check = MVP_MISMATCH;
+  }
+#endif
+#if AOA_ANGLE_IQ_PREPROCESS_Q15
+  aoa_iq_factor_q15_t factor_q15;
+
+  if (aoa_iq_factor_to_q15(factor, &factor_q15) == SL_STATUS_OK) {
+    int16_t i_chunk[Q15_CHUNK_SAMPLES];
+    int16_t q_chunk[Q15_CHUNK_SAMPLES];
+
+    for (size_t n = 0; n < count; n += Q15_CHUNK_SAMPLES) {
+      size_t chunk = ((count - n) < Q15_CHUNK_SAMPLES) ? (count - n) : Q15_CHUNK_SAMPLES;
+      aoa_iq_preprocess_q15(&samples[2 * n], chunk, &factor_q15, i_chunk, q_chunk);
+      aoa_iq_q15_to_float(i_chunk, chunk, &i_samples[n]);
+      aoa_iq_q15_to_float(q_chunk, chunk, &q_samples[n]);
+    }
+    return;
+  }
+#endif
+  aoa_iq_preprocess_reference(samples, count, factor, i_samples, q_samples);
+}
+
+/**************************************************************************//**
+ * Portable C implementation of the IQ preprocessing.
+ *
+ * Branch free, so that the compiler can vectorize it where the target allows.
+ *****************************************************************************/
+void aoa_iq_preprocess_reference(const int8_t *samples,
+                                 size_t count,
+                                 const aoa_iq_factor_t *factor,
+                                 float *i_samples,
+                                 float *q_samples)
+{
+  const float re = factor->real;
+  const float im = factor->imag;
+
+  for (size_t n = 0; n < count; n++) {
+    float i = (float)samples[2 * n];
+    float q = (float)samples[(2 * n) + 1];
+    i_samples[n] = (i * re) - (q * im);
+    q_samples[n] = (i * im) + (q * re);
+  }
+}
+
+/**************************************************************************//**
+ * Convert a preprocessing factor into fixed point.
+ *****************************************************************************/
+sl_status_t aoa_iq_factor_to_q15(const aoa_iq_factor_t *factor,
+                                 aoa_iq_factor_q15_t *factor_q15)
+{
+  // The raw samples are integers, the factor seen by their Q7 value is larger.
+  float real = ldexpf(factor->real, Q7_FRACTION_BITS);
+  float imag = ldexpf(factor->imag, Q7_FRACTION_BITS);
+  float magnitude = fmaxf(fabsf(real), fabsf(imag));
+  int shift = 0;
+
+  if (magnitude > 0.0f) {
+    // magnitude = mantissa * 2^shift, mantissa in [0.5, 1)
+    (void)frexpf(magnitude, &shift);
+  }
+  if (shift > Q7_FRACTION_BITS) {
+    return SL_STATUS_INVALID_RANGE;
+  }
+  if (shift < (Q7_FRACTION_BITS - Q15_FRACTION_BITS)) {
+    // Too small to matter, the right shift is limited to 15 bits.
+    shift = Q7_FRACTION_BITS - Q15_FRACTION_BITS;
+  }
+
+  factor_q15->real = saturate_q15((int32_t)lrintf(ldexpf(real, Q15_FRACTION_BITS - shift)));
+  factor_q15->imag = saturate_q15((int32_t)lrintf(ldexpf(imag, Q15_FRACTION_BITS - shift)));
+  factor_q15->shift = (int8_t)shift;
+  return SL_STATUS_OK;
+}
+
+/**************************************************************************//**
+ * Fixed point implementation of the IQ preprocessing.
+ *
+ * The int8 x Q15 products fit in 32 bits, the result is shifted back to Q15.
+ *****************************************************************************/
+void aoa_iq_preprocess_q15(const int8_t *samples,
+                           size_t count,
+                           const aoa_iq_factor_q15_t *factor,
+                           int16_t *i_samples,
+                           int16_t *q_samples)
+{
+  const int32_t re = factor->real;
+  const int32_t im = factor->imag;
+  const int shift = Q7_FRACTION_BITS - factor->shift;
+
+  for (size_t n = 0; n < count; n++) {
+    int32_t i = samples[2 * n];
+    int32_t q = samples[(2 * n) + 1];
+    i_samples[n] = saturate_q15(((i * re) - (q * im)) >> shift);
+    q_samples[n] = saturate_q15(((i * im) + (q * re)) >> shift);
+  }
+}
+
+/**************************************************************************//**
+ * Convert Q15 samples to float.
+ *****************************************************************************/
+void aoa_iq_q15_to_float(const int16_t *src, size_t count, float *dst)
+{
+  for (size_t n = 0; n < count; n++) {
+    dst[n] = (float)src[n] * (1.0f / Q15_ONE);
+  }
+}
+
+/**************************************************************************//**
+ * Estimate the phase rotation between consecutive Q15 IQ samples.
+ *****************************************************************************/
+sl_status_t aoa_iq_get_phase_rotation_q15(const int16_t *i_samples,
+                                          const int16_t *q_samples,
+                                          size_t count,
+                                          float *rotation)
+{
+  int64_t sum_i = 0;
+  int64_t sum_q = 0;
+
+  if (count < 2) {
+    return SL_STATUS_INVALID_PARAMETER;
+  }
+
+  // s[n] * conj(s[n - 1]), the Q30 products are accumulated in Q33.30.
+  for (size_t n = 1; n < count; n++) {
+    int32_t i0 = i_samples[n - 1];
+    int32_t q0 = q_samples[n - 1];
+    int32_t i1 = i_samples[n];
+    int32_t q1 = q_samples[n];
+    sum_i += ((int64_t)i1 * i0) + ((int64_t)q1 * q0);
+    sum_q += ((int64_t)q1 * i0) - ((int64_t)i1 * q0);
+  }
+  *rotation = atan2f((float)sum_q, (float)sum_i);
+  return SL_STATUS_OK;
+}
+
+/**************************************************************************//**
+ * MVP implementation of the IQ preprocessing.
+ *
+ * The samples are loaded as complex int8, multiplied by the factor held in a
+ * register and stored as complex binary16.
+ *****************************************************************************/
+sl_status_t aoa_iq_preprocess_mvp(const int8_t *samples,
+                                  size_t count,
+                                  const aoa_iq_factor_t *factor,
+                                  float *i_samples,
+                                  float *q_samples)
+{
+#if AOA_ANGLE_IQ_PREPROCESS_MVP
+  sl_status_t status = SL_STATUS_OK;
+  sli_mvp_program_context_t *p;
+
+  if ((count == 0)
+      || (count > AOA_ANGLE_IQ_PREPROCESS_MVP_MAX_SAMPLES)
+      || (count > SLI_MVP_MAX_ROW_LENGTH)) {
+    return SL_STATUS_INVALID_RANGE;
+  }
+
+  p = sli_mvp_get_program_area_context();
+  sli_mvp_pb_init_program(p);
+  sli_mvp_pb_begin_program(p);
+
+  sli_mvp_pb_config_vector(p->p, SLI_MVP_ARRAY(0), (void *)samples, SLI_MVP_DATATYPE_COMPLEX_INT8, (unsigned short)count, &status);
+  sli_mvp_pb_config_vector(p->p, SLI_MVP_ARRAY(1), mvp_output, SLI_MVP_DATATYPE_COMPLEX_BINARY16, (unsigned short)count, &status);
+  sli_mvp_prog_set_reg_f16c(p->p, SLI_MVP_R1, (float16_t)factor->real, (float16_t)factor->imag);
+
+  sli_mvp_pb_begin_loop(p, (int)count, &status); {
+    sli_mvp_pb_compute(p,
+                       SLI_MVP_OP(MULC),
+                       SLI_MVP_ALU_X(SLI_MVP_R0)
+                       | SLI_MVP_ALU_Y(SLI_MVP_R1)
+                       | SLI_MVP_ALU_Z(SLI_MVP_R2),
+                       SLI_MVP_LOAD(0, SLI_MVP_R0, SLI_MVP_ARRAY(0), SLI_MVP_INCRDIM_WIDTH),
+                       SLI_MVP_STORE(SLI_MVP_R2, SLI_MVP_ARRAY(1), SLI_MVP_INCRDIM_WIDTH),
+                       &status);
+  }
+  sli_mvp_pb_end_loop(p);
+
+  // Check if any errors found during program generation.
+  if (status != SL_STATUS_OK) {
+    return status;
+  }
+  status = sli_mvp_pb_execute_program(p);
+  if (status != SL_STATUS_OK) {
+    return status;
+  }
+  status = sli_mvp_cmd_wait_for_completion();
+  if (status != SL_STATUS_OK) {
+    return status;
+  }
+
+  for (size_t n = 0; n < count; n++) {
+    i_samples[n] = (float)mvp_output[n].real;
+    q_samples[n] = (float)mvp_output[n].imag;
+  }
+  return SL_STATUS_OK;
+#else
+  (void)samples;
+  (void)count;
+  (void)factor;
+  (void)i_samples;
+  (void)q_samples;
+  return SL_STATUS_NOT_AVAILABLE;
+#endif
+}
+
+// -----------------------------------------------------------------------------
+// Private function definitions
+
+static inline int16_t saturate_q15(int32_t value)
+{
+  if (value > INT16_MAX) {
+    return INT16_MAX;
+  }
+  if (value < INT16_MIN) {
+    return INT16_MIN;
+  }
+  return (int16_t)value;
+}
+
+#if AOA_ANGLE_IQ_PREPROCESS_MVP
+/**************************************************************************//**
+ * Cross-check MVP results against the reference implementation.
+ *
+ * Rounding the factor and the result to half precision costs up to half an
+ * F16_EPSILON of the largest possible result each, the limit leaves the same
+ * again for the rounding inside the MVP.
+ *****************************************************************************/
+static bool mvp_matches_reference(const int8_t *samples,
+                                  size_t count,
+                                  const aoa_iq_factor_t *factor,
+                                  const float *i_samples,
+                                  const float *q_samples)
+{
+  const float limit = (fabsf(factor->real) + fabsf(factor->imag))
+                      * (float)(-INT8_MIN) * 2.0f * F16_EPSILON;
+  float i;
+  float q;
+
+  for (size_t n = 0; n < count; n++) {
+    aoa_iq_preprocess_reference(&samples[2 * n], 1, factor, &i, &q);
+    if ((fabsf(i_samples[n] - i) > limit) || (fabsf(q_samples[n] - q) > limit)) {
+      return false;
+    }
+  }
+  return true;
+}
+#endif
@@ -0,0 +1,178 @@
+/***************************************************************************//**
+ * @file
+ * @brief IQ sample preprocessing for AoA angle estimation.
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2024 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ ******************************************************************************/
+
+#ifndef AOA_IQ_PREPROCESS_H
+#define AOA_IQ_PREPROCESS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+#include "sl_status.h"
+
+/// Complex factor applied to every IQ sample, combines scaling and derotation.
+typedef struct {
+  float real;
+  float imag;
+} aoa_iq_factor_t;
+
+/// Fixed point form of aoa_iq_factor_t, the factor is (real + j imag) * 2^shift
+/// with real and imag in Q15.
+typedef struct {
+  int16_t real;
+  int16_t imag;
+  int8_t shift;
+} aoa_iq_factor_q15_t;
+
+/**************************************************************************//**
+ * Set up a preprocessing factor.
+ *
+ * @param[out] factor Factor to set up.
+ * @param[in] scale Scale applied on the raw samples.
+ * @param[in] phase Phase in radians the samples are rotated back by.
+ *****************************************************************************/
+void aoa_iq_factor_init(aoa_iq_factor_t *factor, float scale, float phase);
+
+/**************************************************************************//**
+ * Convert interleaved 8-bit IQ samples into separate I and Q float arrays,
+ * multiplied by the given factor.
+ *
+ * Runs on the MVP when AOA_ANGLE_IQ_PREPROCESS_MVP is enabled and the input
+ * fits the accelerator. The first MVP result is cross-checked against the
+ * reference implementation, the MVP is left unused if they differ by more
+ * than the half precision rounding. Otherwise runs in fixed point when
+ * AOA_ANGLE_IQ_PREPROCESS_Q15 is enabled, or falls back to the reference
+ * implementation.
+ *
+ * @param[in] samples Interleaved IQ samples, 2 * count bytes.
+ * @param[in] count Number of IQ sample pairs.
+ * @param[in] factor Scale and derotation factor.
+ * @param[out] i_samples I samples, count elements.
+ * @param[out] q_samples Q samples, count elements.
+ *****************************************************************************/
+void aoa_iq_preprocess(const int8_t *samples,
+                       size_t count,
+                       const aoa_iq_factor_t *factor,
+                       float *i_samples,
+                       float *q_samples);
+
+/**************************************************************************//**
+ * Portable C implementation of aoa_iq_preprocess.
+ *
+ * Serves as the reference that the accelerated path is checked against.
+ *****************************************************************************/
+void aoa_iq_preprocess_reference(const int8_t *samples,
+                                 size_t count,
+                                 const aoa_iq_factor_t *factor,
+                                 float *i_samples,
+                                 float *q_samples);
+
+/**************************************************************************//**
+ * Convert a preprocessing factor into fixed point.
+ *
+ * @param[in] factor Floating point factor.
+ * @param[out] factor_q15 Fixed point factor.
+ *
+ * @return SL_STATUS_OK if the factor can be represented,
+ *         SL_STATUS_INVALID_RANGE if the factor is too large.
+ *****************************************************************************/
+sl_status_t aoa_iq_factor_to_q15(const aoa_iq_factor_t *factor,
+                                 aoa_iq_factor_q15_t *factor_q15);
+
+/**************************************************************************//**
+ * Fixed point implementation of the IQ preprocessing.
+ *
+ * Deinterleaves, scales and derotates the samples in Q15. Results outside
+ * of [-1, 1) saturate.
+ *
+ * @param[in] samples Interleaved IQ samples, 2 * count bytes.
+ * @param[in] count Number of IQ sample pairs.
+ * @param[in] factor Scale and derotation factor.
+ * @param[out] i_samples I samples in Q15, count elements.
+ * @param[out] q_samples Q samples in Q15, count elements.
+ *****************************************************************************/
+void aoa_iq_preprocess_q15(const int8_t *samples,
+                           size_t count,
+                           const aoa_iq_factor_q15_t *factor,
+                           int16_t *i_samples,
+                           int16_t *q_samples);
+
+/**************************************************************************//**
+ * Convert Q15 samples to float.
+ *
+ * @param[in] src Samples in Q15.
+ * @param[in] count Number of samples.
+ * @param[out] dst Samples in float, count elements.
+ *****************************************************************************/
+void aoa_iq_q15_to_float(const int16_t *src, size_t count, float *dst);
+
+/**************************************************************************//**
+ * Estimate the phase rotation between consecutive Q15 IQ samples.
+ *
+ * The products of the consecutive samples are accumulated in 64 bits, only
+ * the final angle is computed in floating point.
+ *
+ * @param[in] i_samples I samples in Q15.
+ * @param[in] q_samples Q samples in Q15.
+ * @param[in] count Number of IQ sample pairs, at least 2.
+ * @param[out] rotation Average rotation in radians per sample.
+ *
+ * @return SL_STATUS_OK if successful,
+ *         SL_STATUS_INVALID_PARAMETER if count is less than 2.
+ *****************************************************************************/
+sl_status_t aoa_iq_get_phase_rotation_q15(const int16_t *i_samples,
+                                          const int16_t *q_samples,
+                                          size_t count,
+                                          float *rotation);
+
+/**************************************************************************//**
+ * MVP implementation of aoa_iq_preprocess.
+ *
+ * Computes in half precision, results match the reference within
+ * half precision rounding.
+ *
+ * @return SL_STATUS_OK if the samples were processed,
+ *         SL_STATUS_NOT_AVAILABLE if the MVP path is disabled,
+ *         SL_STATUS_INVALID_RANGE if count exceeds the accelerator limits,
+ *         other value on MVP failure.
+ *****************************************************************************/
+sl_status_t aoa_iq_preprocess_mvp(const int8_t *samples,
+                                  size_t count,
+                                  const aoa_iq_factor_t *factor,
+                                  float *i_samples,
+                                  float *q_samples);
+
+#ifdef __cplusplus
+};
+#endif
+
+#endif // AOA_IQ_PREPROCESS_H
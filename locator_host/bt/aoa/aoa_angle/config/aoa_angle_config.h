@@ -34,6 +34,18 @@
 #include <math.h>
 #include "sl_rtl_clib_api.h"
 
+// Angle estimator backend, see aoa_estimator.h.
+#define AOA_ANGLE_ESTIMATOR_RTL                  0
+#define AOA_ANGLE_ESTIMATOR_PORTABLE             1
+// Can be overridden by the build, e.g. where libaox is not available.
+#ifndef AOA_ANGLE_ESTIMATOR
+#define AOA_ANGLE_ESTIMATOR                      AOA_ANGLE_ESTIMATOR_RTL
+#endif
+
+// Distance of the neighbouring antennas in meters, used by the portable
+// estimator and the IQ generator. Half wavelength at 2.44 GHz.
+#define AOA_ANGLE_ANTENNA_SPACING                (299792458.0f / 2440e6f / 2.0f)
+
 // AoA estimator mode
 #define AOA_ANGLE_AOX_MODE                       SL_RTL_AOA_MODE_REAL_TIME_FAST_RESPONSE
 
@@ -60,4 +72,44 @@
 // Switching and sampling slots in us (1 or 2).
 #define AOA_ANGLE_CTE_SLOT_DURATION              1
 
+// Run the IQ sample preprocessing (conversion, scaling, derotation) on the MVP.
+// The portable C implementation is used when disabled, when a report does
+// not fit the MVP buffer or when the first MVP result does not match it.
+#define AOA_ANGLE_IQ_PREPROCESS_MVP              0
+
+// Maximum number of IQ sample pairs processed on the MVP at once.
+#define AOA_ANGLE_IQ_PREPROCESS_MVP_MAX_SAMPLES  256
+
+// Run the IQ sample preprocessing in Q15 fixed point, the samples are converted
+// to float only for the estimator. The MVP takes precedence when enabled.
+#define AOA_ANGLE_IQ_PREPROCESS_Q15              0
+
+// Keep a smoothed phase rotation estimate for each tag and channel instead of
+// estimating it from the reference period of every packet. The cached value
+// is only checked against two reference samples of each packet. Adds 640 bytes
+// to each angle calculation handler, the configs can still turn it off.
+// Can be overridden by the build, e.g. by the host side benchmark.
+#ifndef AOA_ANGLE_PHASE_ROTATION_CACHE
+#define AOA_ANGLE_PHASE_ROTATION_CACHE           0
+#endif
+
+// Packets between two full phase rotation estimations of a cached channel.
+#define AOA_ANGLE_PHASE_ROTATION_REFRESH_PACKETS 16
+
+// Largest deviation in radians over the reference period (three measurement
+// samples) accepted from the cached phase rotation, a larger one restarts the
+// estimation. At most 0.5. Lower values also restart on noise, 0.15 already
+// does at 25 dB SNR. The check tolerates about 5 kHz of CFO change since the
+// last full estimation, so a tag drifting by 20 Hz per packet still sees
+// about 2 degrees rms azimuth error against 0.5 degrees without the cache:
+// disable the cache in the config of such tags.
+// Can be overridden by the build, e.g. by the host side benchmark.
+#ifndef AOA_ANGLE_PHASE_ROTATION_MAX_RESIDUAL
+#define AOA_ANGLE_PHASE_ROTATION_MAX_RESIDUAL    0.2f
+#endif
+
+// Weight of a new full estimation in the cached phase rotation. Ranges from
+// 0 to 1.
+#define AOA_ANGLE_PHASE_ROTATION_SMOOTHING       0.25f
+
 #endif // AOA_ANGLE_CONFIG_H
@@ -30,9 +30,27 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include "aoa_cte.h"
 #include "sl_common.h"
+#include "sl_ncp_evt_filter_common.h"
+#include "sl_ncp_evt_filter_config.h"
 #include "aoa_cte_config.h"
+#include "app_log.h"
+
+// -----------------------------------------------------------------------------
+// Defines.
+
+// IQ report rate user messages of the NCP, see locator_ncp/app.h.
+#define NCP_IQ_RATE_CMD_ID       0x04
+#define NCP_IQ_RATE_CMD_LEN      (1 + ADR_LEN + 2)
+#define NCP_IQ_STATS_CMD_ID      0x05
+#define NCP_IQ_STATS_CMD_LEN     (1 + 2)
+#define NCP_IQ_STATS_EVT_ID      0x05
+// Header, forwarded and skipped count, tag count, then address and skipped
+// count of each tag, all little endian without padding.
+#define NCP_IQ_STATS_EVT_LEN     (1 + 4 + 4 + 1)
+#define NCP_IQ_STATS_EVT_TAG_LEN (ADR_LEN + 4)
 
 // -----------------------------------------------------------------------------
 // Module variables.
@@ -52,6 +70,18 @@ aoa_cte_config_t aoa_cte_config = {
   NULL
 };
 
+// UUID defined by Bluetooth SIG
+static const uint8_t cte_service[] = { 0x4A, 0x18 };
+
+// Incomplete and complete List of 16-bit Service Class UUIDs.
+static const uint8_t cte_service_ad_types[] = { 0x02, 0x03 };
+
+// -----------------------------------------------------------------------------
+// Private function declarations.
+
+static void log_ncp_iq_stats(const uint8_t *data, size_t len);
+static uint32_t get_le32(const uint8_t *data);
+
 // -----------------------------------------------------------------------------
 // Public function definitions.
 
@@ -71,6 +101,28 @@ sl_status_t aoa_cte_bt_on_event(sl_bt_msg_t *evt)
     if (sc != SL_STATUS_OK) {
       return sc;
     }
+#if AOA_CTE_NCP_FILTER
+    // The host filters the same events, an older NCP is not an error.
+    sl_status_t filter_sc = aoa_cte_update_ncp_filter();
+    if (SL_STATUS_FULL == filter_sc) {
+      app_log_warning("Allowlist longer than the %d addresses of the NCP, filtering addresses on the host only." APP_LOG_NL,
+                      SL_NCP_EVT_FILTER_ADDRESS_LIST_LENGTH);
+    } else if (SL_STATUS_OK != filter_sc) {
+      app_log_warning("NCP content filter not set, filtering on the host only." APP_LOG_NL);
+    }
+#endif
+#if AOA_CTE_NCP_MAX_IQ_RATE
+    if (SL_STATUS_OK != aoa_cte_set_ncp_iq_rate(NULL, AOA_CTE_NCP_MAX_IQ_RATE)) {
+      app_log_warning("NCP IQ report rate limit not set." APP_LOG_NL);
+    }
+#endif
+  }
+
+  if (SL_BT_MSG_ID(evt->header) == sl_bt_evt_user_message_to_host_id) {
+    uint8array *message = &evt->data.evt_user_message_to_host.message;
+    if ((message->len > 0) && (message->data[0] == NCP_IQ_STATS_EVT_ID)) {
+      log_ncp_iq_stats(message->data, message->len);
+    }
   }
 
   switch (cte_mode) {
@@ -90,6 +142,17 @@ sl_status_t aoa_cte_bt_on_event(sl_bt_msg_t *evt)
   return sc;
 }
 
+/**************************************************************************//**
+ * Periodic processing.
+ *****************************************************************************/
+void aoa_cte_process_action(void)
+{
+  // Tags are only removed on disconnection in the other modes.
+  if (cte_mode == AOA_CTE_TYPE_SILABS) {
+    cte_process_action_silabs();
+  }
+}
+
 /**************************************************************************//**
  * Sets the CTE Mode.
  *****************************************************************************/
@@ -110,6 +173,107 @@ aoa_cte_type_t aoa_cte_get_mode(void)
   return cte_mode;
 }
 
+/**************************************************************************//**
+ * Uploads the content filter rules of the current CTE mode to the NCP.
+ *****************************************************************************/
+sl_status_t aoa_cte_update_ncp_filter(void)
+{
+  sl_status_t sc;
+  sl_status_t allowlist_sc = SL_STATUS_OK;
+  uint8_t user_data[SL_NCP_EVT_FILTER_CMD_ADD_ADDRESS_LEN(SL_NCP_EVT_FILTER_ADDRESS_MAX_COUNT)];
+  size_t allowlist_size = aoa_db_allowlist_get_size();
+  size_t count;
+
+  // Replace the allowlist of the NCP.
+  user_data[0] = SL_NCP_EVT_FILTER_CMD_RESET_ADDRESS_ID;
+  sc = sl_bt_user_manage_event_filter(SL_NCP_EVT_FILTER_CMD_RESET_ADDRESS_LEN, user_data);
+  if (SL_STATUS_OK != sc) {
+    return sc;
+  }
+  // The host holds more addresses than the NCP, the NCP config shall match the
+  // one of the host copy. A partial allowlist would drop allowed tags.
+  if (allowlist_size > SL_NCP_EVT_FILTER_ADDRESS_LIST_LENGTH) {
+    allowlist_sc = SL_STATUS_FULL;
+    allowlist_size = 0;
+  }
+  for (size_t index = 0; index < allowlist_size; index += count) {
+    count = allowlist_size - index;
+    if (count > SL_NCP_EVT_FILTER_ADDRESS_MAX_COUNT) {
+      count = SL_NCP_EVT_FILTER_ADDRESS_MAX_COUNT;
+    }
+    user_data[0] = SL_NCP_EVT_FILTER_CMD_ADD_ADDRESS_ID;
+    for (size_t i = 0; i < count; i++) {
+      aoa_db_allowlist_get(index + i, &user_data[1 + (i * ADR_LEN)]);
+    }
+    sc = sl_bt_user_manage_event_filter(SL_NCP_EVT_FILTER_CMD_ADD_ADDRESS_LEN(count), user_data);
+    if (SL_STATUS_OK != sc) {
+      // A partial allowlist would drop allowed tags, let everything through.
+      user_data[0] = SL_NCP_EVT_FILTER_CMD_RESET_ADDRESS_ID;
+      (void)sl_bt_user_manage_event_filter(SL_NCP_EVT_FILTER_CMD_RESET_ADDRESS_LEN, user_data);
+      return sc;
+    }
+  }
+
+  // The tags of the connection based modes advertise the CTE service.
+  user_data[0] = SL_NCP_EVT_FILTER_CMD_RESET_AD_MATCH_ID;
+  sc = sl_bt_user_manage_event_filter(SL_NCP_EVT_FILTER_CMD_RESET_AD_MATCH_LEN, user_data);
+  if (SL_STATUS_OK != sc) {
+    return sc;
+  }
+  if (cte_mode != AOA_CTE_TYPE_SILABS) {
+    for (size_t i = 0; i < sizeof(cte_service_ad_types); i++) {
+      user_data[0] = SL_NCP_EVT_FILTER_CMD_ADD_AD_MATCH_ID;
+      user_data[1] = cte_service_ad_types[i];
+      memcpy(&user_data[2], cte_service, sizeof(cte_service));
+      sc = sl_bt_user_manage_event_filter(SL_NCP_EVT_FILTER_CMD_ADD_AD_MATCH_LEN(sizeof(cte_service)),
+                                          user_data);
+      if (SL_STATUS_OK != sc) {
+        return sc;
+      }
+    }
+  }
+
+  user_data[0] = SL_NCP_EVT_FILTER_CMD_SET_MIN_RSSI_ID;
+  user_data[1] = (uint8_t)(int8_t)AOA_CTE_NCP_MIN_RSSI;
+  sc = sl_bt_user_manage_event_filter(SL_NCP_EVT_FILTER_CMD_SET_MIN_RSSI_LEN, user_data);
+  if (SL_STATUS_OK != sc) {
+    return sc;
+  }
+  return allowlist_sc;
+}
+
+/**************************************************************************//**
+ * Limits the IQ report rate of a tag on the NCP.
+ *****************************************************************************/
+sl_status_t aoa_cte_set_ncp_iq_rate(const uint8_t address[ADR_LEN],
+                                    uint16_t max_rate)
+{
+  uint8_t user_data[NCP_IQ_RATE_CMD_LEN];
+
+  user_data[0] = NCP_IQ_RATE_CMD_ID;
+  if (NULL == address) {
+    memset(&user_data[1], 0xff, ADR_LEN);
+  } else {
+    memcpy(&user_data[1], address, ADR_LEN);
+  }
+  user_data[1 + ADR_LEN] = (uint8_t)max_rate;
+  user_data[2 + ADR_LEN] = (uint8_t)(max_rate >> 8);
+  return sl_bt_user_message_to_target(sizeof(user_data), user_data, 0, NULL, NULL);
+}
+
+/**************************************************************************//**
+ * Sets the period of the IQ report statistics of the NCP.
+ *****************************************************************************/
+sl_status_t aoa_cte_set_ncp_iq_stats_period(uint16_t period)
+{
+  uint8_t user_data[NCP_IQ_STATS_CMD_LEN];
+
+  user_data[0] = NCP_IQ_STATS_CMD_ID;
+  user_data[1] = (uint8_t)period;
+  user_data[2] = (uint8_t)(period >> 8);
+  return sl_bt_user_message_to_target(sizeof(user_data), user_data, 0, NULL, NULL);
+}
+
 /**************************************************************************//**
  * Callback to notify the application on new iq report.
  *****************************************************************************/
@@ -118,3 +282,40 @@ SL_WEAK void aoa_cte_on_iq_report(aoa_db_entry_t *tag,
 {
   // Implement in the application.
 }
+
+// -----------------------------------------------------------------------------
+// Private function definitions.
+
+/**************************************************************************//**
+ * Logs the IQ report statistics of the NCP.
+ *****************************************************************************/
+static void log_ncp_iq_stats(const uint8_t *data, size_t len)
+{
+  const uint8_t *tag = &data[NCP_IQ_STATS_EVT_LEN];
+  size_t tag_count;
+
+  if (len < NCP_IQ_STATS_EVT_LEN) {
+    return;
+  }
+  tag_count = data[NCP_IQ_STATS_EVT_LEN - 1];
+  if (tag_count > ((len - NCP_IQ_STATS_EVT_LEN) / NCP_IQ_STATS_EVT_TAG_LEN)) {
+    tag_count = (len - NCP_IQ_STATS_EVT_LEN) / NCP_IQ_STATS_EVT_TAG_LEN;
+  }
+
+  app_log_info("NCP IQ reports forwarded: %lu, skipped: %lu" APP_LOG_NL,
+               (unsigned long)get_le32(&data[1]),
+               (unsigned long)get_le32(&data[5]));
+  for (size_t i = 0; i < tag_count; i++, tag += NCP_IQ_STATS_EVT_TAG_LEN) {
+    app_log_info("  %02X:%02X:%02X:%02X:%02X:%02X skipped: %lu" APP_LOG_NL,
+                 tag[5], tag[4], tag[3], tag[2], tag[1], tag[0],
+                 (unsigned long)get_le32(&tag[ADR_LEN]));
+  }
+}
+
+static uint32_t get_le32(const uint8_t *data)
+{
+  return (uint32_t)data[0]
+         | ((uint32_t)data[1] << 8)
+         | ((uint32_t)data[2] << 16)
+         | ((uint32_t)data[3] << 24);
+}
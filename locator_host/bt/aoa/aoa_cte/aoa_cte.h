@@ -77,6 +77,13 @@ extern aoa_cte_config_t aoa_cte_config;
  *****************************************************************************/
 sl_status_t aoa_cte_bt_on_event(sl_bt_msg_t *evt);
 
+/**************************************************************************//**
+ * Periodic processing, to be called from the main loop.
+ *
+ * Removes the stale tags in Silabs CTE mode.
+ *****************************************************************************/
+void aoa_cte_process_action(void);
+
 /**************************************************************************//**
  * Sets the CTE Mode.
  *
@@ -94,6 +101,51 @@ sl_status_t aoa_cte_set_mode(aoa_cte_type_t mode);
  *****************************************************************************/
 aoa_cte_type_t aoa_cte_get_mode(void);
 
+/**************************************************************************//**
+ * Uploads the content filter rules of the current CTE mode to the NCP.
+ *
+ * The allowlist, the CTE service of the connection based modes and the
+ * minimum RSSI are evaluated on the NCP, the host keeps checking them too.
+ * Called at boot if AOA_CTE_NCP_FILTER is enabled, call again after changing
+ * the allowlist.
+ *
+ * @retval SL_STATUS_OK - Rules uploaded.
+ * @retval SL_STATUS_FULL - Allowlist longer than
+ *         SL_NCP_EVT_FILTER_ADDRESS_LIST_LENGTH, the allowlist of the NCP is
+ *         left empty, the other rules are uploaded.
+ * @return Error code of the NCP otherwise, e.g. if it does not support the
+ *         content filter.
+ *****************************************************************************/
+sl_status_t aoa_cte_update_ncp_filter(void);
+
+/**************************************************************************//**
+ * Limits the IQ report rate of a tag on the NCP.
+ *
+ * Reports in excess are dropped by the NCP before they cross the UART.
+ * Called at boot for all tags if AOA_CTE_NCP_MAX_IQ_RATE is set.
+ *
+ * @param[in] address Address of the tag, NULL sets the limit of all tags
+ *                    without their own limit.
+ * @param[in] max_rate IQ reports per second, 0 removes the limit.
+ *
+ * @retval SL_STATUS_OK - Limit set.
+ * @return Error code of the NCP otherwise, e.g. if it does not support the
+ *         IQ report rate limit.
+ *****************************************************************************/
+sl_status_t aoa_cte_set_ncp_iq_rate(const uint8_t address[ADR_LEN],
+                                    uint16_t max_rate);
+
+/**************************************************************************//**
+ * Sets the period of the IQ report statistics the NCP sends while it drops
+ * reports. The statistics are logged when received.
+ *
+ * @param[in] period Period in ms, 0 stops the statistics.
+ *
+ * @retval SL_STATUS_OK - Period set.
+ * @return Error code of the NCP otherwise.
+ *****************************************************************************/
+sl_status_t aoa_cte_set_ncp_iq_stats_period(uint16_t period);
+
 /**************************************************************************//**
  * Bluetooth event handle for connectionless CTE.
  *
@@ -121,6 +173,11 @@ sl_status_t cte_bt_on_event_conn(sl_bt_msg_t *evt);
  *****************************************************************************/
 sl_status_t cte_bt_on_event_silabs(sl_bt_msg_t *evt);
 
+/**************************************************************************//**
+ * Periodic processing for Silabs CTE.
+ *****************************************************************************/
+void cte_process_action_silabs(void);
+
 /**************************************************************************//**
  * Callback to notify the application on new iq report.
  *
@@ -54,4 +54,27 @@
 // Switching and sampling slots in us (1 or 2).
 #define AOA_CTE_SLOT_DURATION              1
 
+// Silabs CTE mode: tags not heard from for this long are removed, in ms.
+// 0 disables the aging.
+#define AOA_CTE_TAG_TTL_MS                 10000
+
+// Silabs CTE mode: period of the stale tag sweep in ms.
+#define AOA_CTE_TAG_SWEEP_PERIOD_MS        1000
+
+// Silabs CTE mode: a new tag replaces the least recently seen one when the
+// tag database is full. The new tag is dropped otherwise.
+#define AOA_CTE_TAG_LRU_EVICTION           1
+
+// Upload the allowlist, the CTE service and the minimum RSSI to the NCP at boot,
+// so that it drops the events of other devices before sending them over UART.
+#define AOA_CTE_NCP_FILTER                 1
+
+// IQ reports weaker than this are dropped by the NCP, in dBm.
+// -128 lets every IQ report through.
+#define AOA_CTE_NCP_MIN_RSSI               (-128)
+
+// Maximum IQ report rate of each tag set on the NCP at boot, in reports per
+// second. The NCP drops the reports in excess. 0 leaves the NCP unlimited.
+#define AOA_CTE_NCP_MAX_IQ_RATE            0
+
 #endif /* AOA_CTE_CONFIG_H */
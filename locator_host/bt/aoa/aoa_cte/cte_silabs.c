@@ -28,6 +28,7 @@
  *
  ******************************************************************************/
 #include "sl_bt_api.h"
+#include "sl_sleeptimer.h"
 #include "sl_ncp_evt_filter_common.h"
 #include "aoa_cte.h"
 #include "aoa_cte_config.h"
@@ -36,6 +37,11 @@
 extern uint8_t cte_switch_pattern[ANTENNA_ARRAY_MAX_PIN_PATTERN_SIZE];
 extern uint8_t cte_switch_pattern_size;
 
+// Module variables.
+#if AOA_CTE_TAG_TTL_MS > 0
+static uint32_t last_sweep = 0;
+#endif
+
 /**************************************************************************//**
  * CTE specific Bluetooth event handler.
  *****************************************************************************/
@@ -104,14 +110,25 @@ sl_status_t cte_bt_on_event_silabs(sl_bt_msg_t *evt)
       sc = aoa_db_get_tag_by_address(&evt->data.evt_cte_receiver_silabs_iq_report.address, &tag);
       // Check if it is a new tag
       if (sc == SL_STATUS_NOT_FOUND) {
-        sc = aoa_db_add_tag(0,
+        sc = aoa_db_add_tag(AOA_DB_HANDLE_NONE,
                             &evt->data.evt_cte_receiver_silabs_iq_report.address,
                             evt->data.evt_cte_receiver_silabs_iq_report.address_type,
                             &tag);
+#if AOA_CTE_TAG_LRU_EVICTION
+        if ((SL_STATUS_ALLOCATION_FAILED == sc)
+            && (SL_STATUS_OK == aoa_db_remove_lru_tag())) {
+          // Make room by dropping the tag that was seen the longest time ago.
+          sc = aoa_db_add_tag(AOA_DB_HANDLE_NONE,
+                              &evt->data.evt_cte_receiver_silabs_iq_report.address,
+                              evt->data.evt_cte_receiver_silabs_iq_report.address_type,
+                              &tag);
+        }
+#endif
         if (SL_STATUS_OK != sc) {
           break;
         }
       }
+      aoa_db_touch_tag(tag, sl_sleeptimer_get_tick_count());
 
       // Convert event to common IQ report format.
       iq_report.channel = evt->data.evt_cte_receiver_silabs_iq_report.channel;
@@ -132,3 +149,26 @@ sl_status_t cte_bt_on_event_silabs(sl_bt_msg_t *evt)
 
   return sc;
 }
+
+/**************************************************************************//**
+ * Periodic processing for Silabs CTE.
+ *****************************************************************************/
+void cte_process_action_silabs(void)
+{
+#if AOA_CTE_TAG_TTL_MS > 0
+  uint32_t now = sl_sleeptimer_get_tick_count();
+  uint32_t period;
+  uint32_t ttl;
+
+  if ((SL_STATUS_OK != sl_sleeptimer_ms32_to_tick(AOA_CTE_TAG_SWEEP_PERIOD_MS, &period))
+      || ((now - last_sweep) < period)) {
+    return;
+  }
+  last_sweep = now;
+
+  if (SL_STATUS_OK == sl_sleeptimer_ms32_to_tick(AOA_CTE_TAG_TTL_MS, &ttl)) {
+    // The tags are removed through aoa_db_on_tag_removed, like on disconnection.
+    (void)aoa_db_remove_stale_tags(now, ttl);
+  }
+#endif
+}
@@ -32,31 +32,85 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include "aoa_db.h"
+#include "aoa_db_config.h"
 #include "sl_common.h"
 
+// -----------------------------------------------------------------------------
+// Defines
+
+// Number of slots in each index, kept at least twice the tag count so that
+// the load factor stays at or below 0.5 and probe sequences stay short.
+#define AOA_DB_INDEX_SIZE       (2 * AOA_DB_MAX_TAG_COUNT)
+
+// Marks a free index slot.
+#define AOA_DB_INDEX_EMPTY      UINT16_MAX
+
 // -----------------------------------------------------------------------------
 // Type definitions.
 
 // Forward declarations
 typedef struct aoa_db_node aoa_db_node_t;
-typedef struct aoa_db_allow_node aoa_db_allow_node_t;
 
 struct aoa_db_node{
   aoa_db_entry_t entry;
-  aoa_db_node_t *next;
+  uint16_t position;  // Position of the node in the tag list
+  uint32_t added;     // Order of addition, tells duplicate handles apart
+  uint16_t lru_prev;  // Less recently seen neighbour
+  uint16_t lru_next;  // More recently seen neighbour
 };
 
-struct aoa_db_allow_node{
-  uint8_t address[ADR_LEN];
-  aoa_db_allow_node_t *next;
-};
+// Returns the hash of the key the index is built on.
+typedef uint32_t (*aoa_db_index_hash_t)(const aoa_db_entry_t *entry);
+
+// -----------------------------------------------------------------------------
+// Forward declaration of private functions.
+
+static uint32_t hash_handle(uint16_t handle);
+static uint32_t hash_address(const bd_addr *address);
+static uint32_t hash_entry_handle(const aoa_db_entry_t *entry);
+static uint32_t hash_entry_address(const aoa_db_entry_t *entry);
+static void index_insert(uint16_t *index, uint32_t hash, uint16_t id);
+static void index_remove(uint16_t *index, aoa_db_index_hash_t hash_fn, uint16_t id);
+static void remove_node(uint16_t id);
+static void lru_append(uint16_t id);
+static void lru_unlink(uint16_t id);
+static uint64_t allowlist_key(const uint8_t address[ADR_LEN]);
+static size_t allowlist_lower_bound(uint64_t key);
+static int allowlist_compare(const void *a, const void *b);
+static void allowlist_sort(void);
 
 // -----------------------------------------------------------------------------
 // Module variables.
 
-// Linked list heads
-static aoa_db_node_t *head_conn = NULL;
-static aoa_db_allow_node_t *head_allow = NULL;
+// Statically allocated tag storage
+static aoa_db_node_t tag_nodes[AOA_DB_MAX_TAG_COUNT];
+
+// Ids of the stored tags, densely packed
+static uint16_t tag_list[AOA_DB_MAX_TAG_COUNT];
+static uint16_t tag_count = 0;
+
+// Ids of the unused tag nodes
+static uint16_t free_list[AOA_DB_MAX_TAG_COUNT];
+static uint16_t free_count = 0;
+static bool nodes_initialized = false;
+
+// Recency order of the tags, from the least to the most recently seen
+static uint16_t lru_oldest = AOA_DB_INDEX_EMPTY;
+static uint16_t lru_newest = AOA_DB_INDEX_EMPTY;
+
+// Latest time given to the database, new tags are aged from this
+static uint32_t current_time = 0;
+
+// Incremented for every added tag
+static uint32_t add_counter = 0;
+
+// Open addressing indexes with linear probing, slots hold tag node ids
+static uint16_t handle_index[AOA_DB_INDEX_SIZE];
+static uint16_t address_index[AOA_DB_INDEX_SIZE];
+
+// Allowlisted addresses as 48-bit keys, sorted in ascending order
+static uint64_t allowlist[AOA_DB_MAX_ALLOWLIST_SIZE];
+static size_t allowlist_size = 0;
 
 // -----------------------------------------------------------------------------
 // Public function definitions.
@@ -69,24 +123,43 @@ sl_status_t aoa_db_add_tag(uint16_t handle,
                            uint8_t address_type,
                            aoa_db_entry_t **tag)
 {
-  aoa_db_node_t *new = (aoa_db_node_t *)malloc(sizeof(aoa_db_node_t));
-  if (NULL == new) {
+  if (!nodes_initialized) {
+    aoa_db_remove_all();
+  }
+
+  if (0 == free_count) {
     return SL_STATUS_ALLOCATION_FAILED;
   }
+  uint16_t id = free_list[--free_count];
+  aoa_db_node_t *new = &tag_nodes[id];
 
   // Store the connection handle, and the server address
+  memset(&new->entry, 0, sizeof(new->entry));
   new->entry.handle = handle;
   new->entry.address = *address;
   new->entry.address_type = address_type;
   new->entry.connection_state = DISCOVER_SERVICES;
   new->entry.sequence = -1;
-  new->next = head_conn;
-  head_conn = new;
+  new->entry.last_seen = current_time;
+  new->position = tag_count;
+  new->added = add_counter++;
+  tag_list[tag_count++] = id;
+  // All Silabs mode tags would share one probe sequence otherwise.
+  if (AOA_DB_HANDLE_NONE != handle) {
+    index_insert(handle_index, hash_handle(handle), id);
+  }
+  index_insert(address_index, hash_address(address), id);
+  lru_append(id);
   *tag = &(new->entry);
 
-  aoa_db_on_tag_added(*tag);
+  sl_status_t sc = aoa_db_on_tag_added(*tag);
+  if (SL_STATUS_OK != sc) {
+    // Rejected by the application.
+    remove_node(id);
+    *tag = NULL;
+  }
 
-  return SL_STATUS_OK;
+  return sc;
 }
 
 /**************************************************************************//**
@@ -94,29 +167,70 @@ sl_status_t aoa_db_add_tag(uint16_t handle,
  *****************************************************************************/
 sl_status_t aoa_db_remove_tag(uint16_t handle)
 {
-  aoa_db_node_t *current = head_conn;
-  aoa_db_node_t *previous = NULL;
+  aoa_db_entry_t *tag;
 
-  if (head_conn == NULL) {
+  if (0 == tag_count) {
     return SL_STATUS_EMPTY;
   }
 
-  while (NULL != current) {
-    if (current->entry.handle == handle) {
-      if (previous != NULL) {
-        previous->next = current->next;
-      } else {
-        head_conn = current->next;
-      }
-      aoa_db_on_tag_removed(&current->entry);
-      free(current);
-      return SL_STATUS_OK;
-    }
-    previous = current;
-    current = current->next;
+  if (SL_STATUS_OK != aoa_db_get_tag_by_handle(handle, &tag)) {
+    return SL_STATUS_NOT_FOUND;
   }
 
-  return SL_STATUS_NOT_FOUND;
+  aoa_db_on_tag_removed(tag);
+  remove_node((uint16_t)((aoa_db_node_t *)tag - tag_nodes));
+  return SL_STATUS_OK;
+}
+
+/**************************************************************************//**
+ * Marks a tag as the most recently seen one.
+ *****************************************************************************/
+void aoa_db_touch_tag(aoa_db_entry_t *tag, uint32_t now)
+{
+  uint16_t id = (uint16_t)((aoa_db_node_t *)tag - tag_nodes);
+
+  tag->last_seen = now;
+  current_time = now;
+  if (lru_newest != id) {
+    lru_unlink(id);
+    lru_append(id);
+  }
+}
+
+/**************************************************************************//**
+ * Removes the tags that were not seen for longer than the given age.
+ *****************************************************************************/
+size_t aoa_db_remove_stale_tags(uint32_t now, uint32_t max_age)
+{
+  size_t removed = 0;
+
+  current_time = now;
+  // The oldest tags are at the front, stop at the first fresh one.
+  while ((lru_oldest != AOA_DB_INDEX_EMPTY)
+         && ((now - tag_nodes[lru_oldest].entry.last_seen) > max_age)) {
+    uint16_t id = lru_oldest;
+    aoa_db_on_tag_removed(&tag_nodes[id].entry);
+    remove_node(id);
+    removed++;
+  }
+
+  return removed;
+}
+
+/**************************************************************************//**
+ * Removes the least recently seen tag.
+ *****************************************************************************/
+sl_status_t aoa_db_remove_lru_tag(void)
+{
+  uint16_t id = lru_oldest;
+
+  if (AOA_DB_INDEX_EMPTY == id) {
+    return SL_STATUS_EMPTY;
+  }
+
+  aoa_db_on_tag_removed(&tag_nodes[id].entry);
+  remove_node(id);
+  return SL_STATUS_OK;
 }
 
 /**************************************************************************//**
@@ -125,21 +239,28 @@ sl_status_t aoa_db_remove_tag(uint16_t handle)
 sl_status_t aoa_db_get_tag_by_handle(uint16_t handle,
                                      aoa_db_entry_t **tag)
 {
-  aoa_db_node_t *current = head_conn;
+  aoa_db_node_t *found = NULL;
 
-  if (NULL == head_conn) {
+  if ((0 == tag_count) || (AOA_DB_HANDLE_NONE == handle)) {
     return SL_STATUS_NOT_FOUND;
   }
 
-  while (NULL != current) {
-    if (current->entry.handle == handle) {
-      *tag = &(current->entry);
-      return SL_STATUS_OK;
+  // Walk the whole probe sequence, it is short, to return the newest match.
+  for (uint32_t slot = hash_handle(handle) % AOA_DB_INDEX_SIZE;
+       handle_index[slot] != AOA_DB_INDEX_EMPTY;
+       slot = (slot + 1) % AOA_DB_INDEX_SIZE) {
+    aoa_db_node_t *current = &tag_nodes[handle_index[slot]];
+    if ((current->entry.handle == handle)
+        && ((NULL == found) || ((int32_t)(current->added - found->added) > 0))) {
+      found = current;
     }
-    current = current->next;
   }
 
-  return SL_STATUS_NOT_FOUND;
+  if (NULL == found) {
+    return SL_STATUS_NOT_FOUND;
+  }
+  *tag = &found->entry;
+  return SL_STATUS_OK;
 }
 
 /**************************************************************************//**
@@ -148,23 +269,12 @@ sl_status_t aoa_db_get_tag_by_handle(uint16_t handle,
 sl_status_t aoa_db_get_tag_by_index(uint32_t index,
                                     aoa_db_entry_t **tag)
 {
-  aoa_db_node_t *current = head_conn;
-  uint32_t i = 0;
-
-  if (NULL == head_conn) {
+  if (index >= tag_count) {
     return SL_STATUS_NOT_FOUND;
   }
 
-  while (NULL != current) {
-    if (index == i) {
-      *tag = &(current->entry);
-      return SL_STATUS_OK;
-    }
-    current = current->next;
-    i++;
-  }
-
-  return SL_STATUS_NOT_FOUND;
+  *tag = &tag_nodes[tag_list[index]].entry;
+  return SL_STATUS_OK;
 }
 
 /**************************************************************************//**
@@ -173,18 +283,18 @@ sl_status_t aoa_db_get_tag_by_index(uint32_t index,
 sl_status_t aoa_db_get_tag_by_address(bd_addr *address,
                                       aoa_db_entry_t **entry)
 {
-  aoa_db_node_t *current = head_conn;
-
-  if (NULL == head_conn) {
+  if (0 == tag_count) {
     return SL_STATUS_NOT_FOUND;
   }
 
-  while (NULL != current) {
-    if (0 == memcmp(address, &(current->entry.address), sizeof(bd_addr))) {
-      *entry = &(current->entry);
+  for (uint32_t slot = hash_address(address) % AOA_DB_INDEX_SIZE;
+       address_index[slot] != AOA_DB_INDEX_EMPTY;
+       slot = (slot + 1) % AOA_DB_INDEX_SIZE) {
+    aoa_db_entry_t *current = &tag_nodes[address_index[slot]].entry;
+    if (0 == memcmp(address, &(current->address), sizeof(bd_addr))) {
+      *entry = current;
       return SL_STATUS_OK;
     }
-    current = current->next;
   }
 
   return SL_STATUS_NOT_FOUND;
@@ -195,15 +305,7 @@ sl_status_t aoa_db_get_tag_by_address(bd_addr *address,
  *****************************************************************************/
 size_t aoa_db_get_number_of_tags(void)
 {
-  size_t i = 0;
-  aoa_db_node_t *current = head_conn;
-
-  while (NULL != current) {
-    i++;
-    current = current->next;
-  }
-
-  return i;
+  return tag_count;
 }
 
 /**************************************************************************//**
@@ -211,21 +313,43 @@ size_t aoa_db_get_number_of_tags(void)
  *****************************************************************************/
 sl_status_t aoa_db_allowlist_add(uint8_t address[ADR_LEN])
 {
-  aoa_db_allow_node_t *new = NULL;
+  uint64_t key = allowlist_key(address);
+  size_t position = allowlist_lower_bound(key);
 
-  if (SL_STATUS_OK == aoa_db_allowlist_find(address)) {
+  if ((position < allowlist_size) && (allowlist[position] == key)) {
     return SL_STATUS_ALREADY_EXISTS;
-  } else {
-    new = (aoa_db_allow_node_t *)malloc(sizeof(aoa_db_allow_node_t));
-    if (NULL == new) {
+  }
+  if (allowlist_size >= AOA_DB_MAX_ALLOWLIST_SIZE) {
+    return SL_STATUS_ALLOCATION_FAILED;
+  }
+
+  memmove(&allowlist[position + 1],
+          &allowlist[position],
+          (allowlist_size - position) * sizeof(allowlist[0]));
+  allowlist[position] = key;
+  allowlist_size++;
+
+  return SL_STATUS_OK;
+}
+
+/**************************************************************************//**
+ * Adds multiple addresses to the allowlist.
+ *****************************************************************************/
+sl_status_t aoa_db_allowlist_add_bulk(const uint8_t *addresses, size_t count)
+{
+  while (count > 0) {
+    if (allowlist_size >= AOA_DB_MAX_ALLOWLIST_SIZE) {
       return SL_STATUS_ALLOCATION_FAILED;
     }
-    for (uint32_t i = 0; i < ADR_LEN; i++) {
-      new->address[i] = address[i];
+
+    // Append as many addresses as fit, then restore the ordering in one go.
+    while ((count > 0) && (allowlist_size < AOA_DB_MAX_ALLOWLIST_SIZE)) {
+      allowlist[allowlist_size++] = allowlist_key(addresses);
+      addresses += ADR_LEN;
+      count--;
     }
+    allowlist_sort();
   }
-  new->next = head_allow;
-  head_allow = new;
 
   return SL_STATUS_OK;
 }
@@ -235,15 +359,7 @@ sl_status_t aoa_db_allowlist_add(uint8_t address[ADR_LEN])
  *****************************************************************************/
 void aoa_db_allowlist_reset(void)
 {
-  aoa_db_allow_node_t *current;
-  aoa_db_allow_node_t *next;
-
-  for (current = head_allow; current != NULL; current = next) {
-    next = current->next;
-    free(current);
-  }
-
-  head_allow = NULL;
+  allowlist_size = 0;
 }
 
 /**************************************************************************//**
@@ -251,30 +367,23 @@ void aoa_db_allowlist_reset(void)
  *****************************************************************************/
 sl_status_t aoa_db_allowlist_remove(uint8_t address[ADR_LEN])
 {
-  aoa_db_allow_node_t *current = head_allow;
-  aoa_db_allow_node_t *previous = NULL;
-
-  if (head_allow == NULL) {
+  if (0 == allowlist_size) {
     return SL_STATUS_EMPTY;
   }
 
-  if (0 == memcmp(head_allow->address, address, ADR_LEN)) {
-    head_allow = head_allow->next;
-    free(current);
-    return SL_STATUS_OK;
-  }
+  uint64_t key = allowlist_key(address);
+  size_t position = allowlist_lower_bound(key);
 
-  while (NULL != current) {
-    if (memcmp(current->address, address, ADR_LEN) == 0) {
-      previous->next = current->next;
-      free(current);
-      return SL_STATUS_OK;
-    }
-    previous = current;
-    current = current->next;
+  if ((position >= allowlist_size) || (allowlist[position] != key)) {
+    return SL_STATUS_NOT_FOUND;
   }
 
-  return SL_STATUS_NOT_FOUND;
+  allowlist_size--;
+  memmove(&allowlist[position],
+          &allowlist[position + 1],
+          (allowlist_size - position) * sizeof(allowlist[0]));
+
+  return SL_STATUS_OK;
 }
 
 /**************************************************************************//**
@@ -282,18 +391,16 @@ sl_status_t aoa_db_allowlist_remove(uint8_t address[ADR_LEN])
  *****************************************************************************/
 sl_status_t aoa_db_allowlist_find(uint8_t address[ADR_LEN])
 {
-  aoa_db_allow_node_t *current = head_allow;
-
-  if (NULL == head_allow) {
+  if (0 == allowlist_size) {
     // Allowlist is empty, every tag is allowed
     return SL_STATUS_EMPTY;
   }
 
-  while (NULL != current) {
-    if (0 == memcmp(address, current->address, ADR_LEN)) {
-      return SL_STATUS_OK;
-    }
-    current = current->next;
+  uint64_t key = allowlist_key(address);
+  size_t position = allowlist_lower_bound(key);
+
+  if ((position < allowlist_size) && (allowlist[position] == key)) {
+    return SL_STATUS_OK;
   }
 
   return SL_STATUS_NOT_FOUND;
@@ -304,15 +411,22 @@ sl_status_t aoa_db_allowlist_find(uint8_t address[ADR_LEN])
  *****************************************************************************/
 size_t aoa_db_allowlist_get_size(void)
 {
-  size_t i = 0;
-  aoa_db_allow_node_t *current = head_allow;
+  return allowlist_size;
+}
 
-  while (NULL != current) {
-    i++;
-    current = current->next;
+/**************************************************************************//**
+ * Copies an address from the allowlist.
+ *****************************************************************************/
+sl_status_t aoa_db_allowlist_get(size_t index, uint8_t address[ADR_LEN])
+{
+  if (index >= allowlist_size) {
+    return SL_STATUS_INVALID_INDEX;
   }
 
-  return i;
+  for (uint32_t i = 0; i < ADR_LEN; i++) {
+    address[i] = (uint8_t)(allowlist[index] >> (8 * i));
+  }
+  return SL_STATUS_OK;
 }
 
 /**************************************************************************//**
@@ -320,24 +434,33 @@ size_t aoa_db_allowlist_get_size(void)
  *****************************************************************************/
 void aoa_db_remove_all(void)
 {
-  aoa_db_node_t *current;
-  aoa_db_node_t *next;
-
-  for (current = head_conn; current != NULL; current = next) {
-    next = current->next;
-    aoa_db_on_tag_removed(&current->entry);
-    free(current);
+  if (nodes_initialized) {
+    for (uint32_t i = 0; i < tag_count; i++) {
+      aoa_db_on_tag_removed(&tag_nodes[tag_list[i]].entry);
+    }
   }
 
-  head_conn = NULL;
+  tag_count = 0;
+  for (uint32_t i = 0; i < AOA_DB_MAX_TAG_COUNT; i++) {
+    free_list[i] = (uint16_t)(AOA_DB_MAX_TAG_COUNT - 1 - i);
+  }
+  free_count = AOA_DB_MAX_TAG_COUNT;
+  for (uint32_t i = 0; i < AOA_DB_INDEX_SIZE; i++) {
+    handle_index[i] = AOA_DB_INDEX_EMPTY;
+    address_index[i] = AOA_DB_INDEX_EMPTY;
+  }
+  lru_oldest = AOA_DB_INDEX_EMPTY;
+  lru_newest = AOA_DB_INDEX_EMPTY;
+  nodes_initialized = true;
 }
 
 /**************************************************************************//**
  * Weak implementation of tag added callback.
  *****************************************************************************/
-SL_WEAK void aoa_db_on_tag_added(aoa_db_entry_t *tag)
+SL_WEAK sl_status_t aoa_db_on_tag_added(aoa_db_entry_t *tag)
 {
   // Implement this in the application.
+  return SL_STATUS_OK;
 }
 
 /**************************************************************************//**
@@ -347,3 +470,198 @@ SL_WEAK void aoa_db_on_tag_removed(aoa_db_entry_t *tag)
 {
   // Implement this in the application.
 }
+
+// -----------------------------------------------------------------------------
+// Private function definitions.
+
+/**************************************************************************//**
+ * Hashes a connection or sync handle.
+ *****************************************************************************/
+static uint32_t hash_handle(uint16_t handle)
+{
+  return ((uint32_t)handle * 2654435761UL) >> 8;
+}
+
+/**************************************************************************//**
+ * Hashes a 48-bit Bluetooth address.
+ *****************************************************************************/
+static uint32_t hash_address(const bd_addr *address)
+{
+  uint64_t key = 0;
+  memcpy(&key, address->addr, ADR_LEN);
+  return (uint32_t)((key * 0x9E3779B97F4A7C15ULL) >> 32);
+}
+
+/**************************************************************************//**
+ * Hashes the handle of a tag.
+ *****************************************************************************/
+static uint32_t hash_entry_handle(const aoa_db_entry_t *entry)
+{
+  return hash_handle(entry->handle);
+}
+
+/**************************************************************************//**
+ * Hashes the address of a tag.
+ *****************************************************************************/
+static uint32_t hash_entry_address(const aoa_db_entry_t *entry)
+{
+  return hash_address(&entry->address);
+}
+
+/**************************************************************************//**
+ * Puts a tag node id into the first free slot of its probe sequence.
+ *****************************************************************************/
+static void index_insert(uint16_t *index, uint32_t hash, uint16_t id)
+{
+  uint32_t slot = hash % AOA_DB_INDEX_SIZE;
+
+  // Cannot run forever, the index has more slots than the database has tags.
+  while (index[slot] != AOA_DB_INDEX_EMPTY) {
+    slot = (slot + 1) % AOA_DB_INDEX_SIZE;
+  }
+  index[slot] = id;
+}
+
+/**************************************************************************//**
+ * Removes a tag node id from an index.
+ *
+ * The following entries of the probe sequence are shifted back so that no
+ * deleted markers are needed and lookups stop at the first empty slot.
+ *****************************************************************************/
+static void index_remove(uint16_t *index, aoa_db_index_hash_t hash_fn, uint16_t id)
+{
+  uint32_t hole = hash_fn(&tag_nodes[id].entry) % AOA_DB_INDEX_SIZE;
+
+  while (index[hole] != id) {
+    hole = (hole + 1) % AOA_DB_INDEX_SIZE;
+  }
+
+  for (uint32_t slot = (hole + 1) % AOA_DB_INDEX_SIZE;
+       index[slot] != AOA_DB_INDEX_EMPTY;
+       slot = (slot + 1) % AOA_DB_INDEX_SIZE) {
+    uint32_t home = hash_fn(&tag_nodes[index[slot]].entry) % AOA_DB_INDEX_SIZE;
+    // Move the entry into the hole unless its home slot lies cyclically in (hole, slot].
+    bool in_place = (hole <= slot) ? ((hole < home) && (home <= slot))
+                    : ((hole < home) || (home <= slot));
+    if (!in_place) {
+      index[hole] = index[slot];
+      hole = slot;
+    }
+  }
+  index[hole] = AOA_DB_INDEX_EMPTY;
+}
+
+/**************************************************************************//**
+ * Removes a tag node from the indexes and the tag list and frees it.
+ *****************************************************************************/
+static void remove_node(uint16_t id)
+{
+  uint16_t position = tag_nodes[id].position;
+
+  if (AOA_DB_HANDLE_NONE != tag_nodes[id].entry.handle) {
+    index_remove(handle_index, hash_entry_handle, id);
+  }
+  index_remove(address_index, hash_entry_address, id);
+  lru_unlink(id);
+
+  // Keep the tag list dense by moving the last tag into the gap.
+  tag_list[position] = tag_list[--tag_count];
+  tag_nodes[tag_list[position]].position = position;
+
+  free_list[free_count++] = id;
+}
+
+/**************************************************************************//**
+ * Links a tag node as the most recently seen one.
+ *****************************************************************************/
+static void lru_append(uint16_t id)
+{
+  tag_nodes[id].lru_prev = lru_newest;
+  tag_nodes[id].lru_next = AOA_DB_INDEX_EMPTY;
+  if (AOA_DB_INDEX_EMPTY == lru_newest) {
+    lru_oldest = id;
+  } else {
+    tag_nodes[lru_newest].lru_next = id;
+  }
+  lru_newest = id;
+}
+
+/**************************************************************************//**
+ * Unlinks a tag node from the recency order.
+ *****************************************************************************/
+static void lru_unlink(uint16_t id)
+{
+  uint16_t prev = tag_nodes[id].lru_prev;
+  uint16_t next = tag_nodes[id].lru_next;
+
+  if (AOA_DB_INDEX_EMPTY == prev) {
+    lru_oldest = next;
+  } else {
+    tag_nodes[prev].lru_next = next;
+  }
+  if (AOA_DB_INDEX_EMPTY == next) {
+    lru_newest = prev;
+  } else {
+    tag_nodes[next].lru_prev = prev;
+  }
+}
+
+/**************************************************************************//**
+ * Packs a 48-bit address into an integer key.
+ *****************************************************************************/
+static uint64_t allowlist_key(const uint8_t address[ADR_LEN])
+{
+  uint64_t key = 0;
+
+  for (uint32_t i = 0; i < ADR_LEN; i++) {
+    key |= (uint64_t)address[i] << (8 * i);
+  }
+  return key;
+}
+
+/**************************************************************************//**
+ * Binary search for the first allowlist position holding a key not less
+ * than the given one.
+ *****************************************************************************/
+static size_t allowlist_lower_bound(uint64_t key)
+{
+  size_t low = 0;
+  size_t high = allowlist_size;
+
+  while (low < high) {
+    size_t middle = low + ((high - low) / 2);
+    if (allowlist[middle] < key) {
+      low = middle + 1;
+    } else {
+      high = middle;
+    }
+  }
+  return low;
+}
+
+/**************************************************************************//**
+ * Orders allowlist keys for qsort.
+ *****************************************************************************/
+static int allowlist_compare(const void *a, const void *b)
+{
+  uint64_t key_a = *(const uint64_t *)a;
+  uint64_t key_b = *(const uint64_t *)b;
+
+  return (key_a > key_b) - (key_a < key_b);
+}
+
+/**************************************************************************//**
+ * Sorts the allowlist and drops the duplicate keys.
+ *****************************************************************************/
+static void allowlist_sort(void)
+{
+  size_t unique = 0;
+
+  qsort(allowlist, allowlist_size, sizeof(allowlist[0]), allowlist_compare);
+  for (size_t i = 0; i < allowlist_size; i++) {
+    if ((0 == unique) || (allowlist[unique - 1] != allowlist[i])) {
+      allowlist[unique++] = allowlist[i];
+    }
+  }
+  allowlist_size = unique;
+}
@@ -44,6 +44,9 @@ extern "C" {
 // Bluetooth address length
 #define ADR_LEN 6
 
+// Handle of the tags that are only looked up by address (Silabs mode)
+#define AOA_DB_HANDLE_NONE UINT16_MAX
+
 // -----------------------------------------------------------------------------
 // Type definitions.
 
@@ -63,6 +66,7 @@ typedef struct {
   uint16_t cte_enable_char_handle;  // Connection only
   aoa_db_state_t connection_state;  // Connection only
   int32_t sequence;                 // RTL lib only
+  uint32_t last_seen;               // Time of the latest activity, see aoa_db_touch_tag
   void *user_data;
 } aoa_db_entry_t;
 
@@ -72,13 +76,15 @@ typedef struct {
 /**************************************************************************//**
  * Add a tag to the database list.
  *
- * @param[in] handle Connection or sync handle.
+ * @param[in] handle Connection or sync handle, or AOA_DB_HANDLE_NONE.
  * @param[in] address Bluetooth address in reverse byte order.
  * @param[in] address_type Address type.
  * @param[out] tag Pointer to the created tag properties structure.
  *
- * @retval SL_STATUS_ALLOCATION_FAILED - Memory allocation failure.
+ * @retval SL_STATUS_ALLOCATION_FAILED - Database is full.
  * @retval SL_STATUS_OK - Tag added.
+ * @return Status returned by aoa_db_on_tag_added if the application rejected
+ *         the tag, the tag is not added then.
  *****************************************************************************/
 sl_status_t aoa_db_add_tag(uint16_t handle,
                            bd_addr *address,
@@ -96,9 +102,44 @@ sl_status_t aoa_db_add_tag(uint16_t handle,
  *****************************************************************************/
 sl_status_t aoa_db_remove_tag(uint16_t handle);
 
+/**************************************************************************//**
+ * Marks a tag as the most recently seen one.
+ *
+ * The time base is up to the caller, it has to be the same for every call
+ * and for aoa_db_remove_stale_tags. Wrap around is handled.
+ *
+ * @param[in] tag Pointer to tag.
+ * @param[in] now Current time.
+ *****************************************************************************/
+void aoa_db_touch_tag(aoa_db_entry_t *tag, uint32_t now);
+
+/**************************************************************************//**
+ * Removes the tags that were not seen for longer than the given age.
+ *
+ * Tags that were never touched are aged from the time they were added,
+ * taken as the latest time given to the database.
+ *
+ * @param[in] now Current time.
+ * @param[in] max_age Maximum time since the latest activity.
+ *
+ * @return Number of removed tags.
+ *****************************************************************************/
+size_t aoa_db_remove_stale_tags(uint32_t now, uint32_t max_age);
+
+/**************************************************************************//**
+ * Removes the least recently seen tag.
+ *
+ * @retval SL_STATUS_EMPTY - No tag in the list.
+ * @retval SL_STATUS_OK - Tag removed.
+ *****************************************************************************/
+sl_status_t aoa_db_remove_lru_tag(void);
+
 /**************************************************************************//**
  * Returns a tag from the tag list by its handle.
  *
+ * If several tags have the same handle, the most recently added one is
+ * returned. Tags added with AOA_DB_HANDLE_NONE are never found by handle.
+ *
  * @param[in] handle Connection or sync handle.
  * @param[out] tag Pointer to tag structure.
  *
@@ -109,7 +150,9 @@ sl_status_t aoa_db_get_tag_by_handle(uint16_t handle,
                                      aoa_db_entry_t **tag);
 
 /**************************************************************************//**
- * Returns a tag from the tag list by its handle.
+ * Returns a tag from the tag list by its index.
+ *
+ * @note Removing a tag may change the index of other tags.
  *
  * @param[in] index index of the tag.
  * @param[out] tag Pointer to tag structure.
@@ -146,11 +189,25 @@ size_t aoa_db_get_number_of_tags(void);
  * @param[in] address Address to be added to the allowlist.
  *
  * @retval SL_STATUS_ALREADY_EXISTS - Address already on the list.
- * @retval SL_STATUS_ALLOCATION_FAILED - Allocation error.
+ * @retval SL_STATUS_ALLOCATION_FAILED - Allowlist is full.
  * @retval SL_STATUS_OK - Address added to the allowlist.
  *****************************************************************************/
 sl_status_t aoa_db_allowlist_add(uint8_t address[ADR_LEN]);
 
+/**************************************************************************//**
+ * Adds multiple addresses to the allowlist at once.
+ *
+ * Addresses already on the allowlist or repeated in the input are stored once.
+ *
+ * @param[in] addresses Packed array of count addresses, ADR_LEN bytes each.
+ * @param[in] count Number of addresses.
+ *
+ * @retval SL_STATUS_ALLOCATION_FAILED - Allowlist is full, only a part of
+ *                                       the addresses was added.
+ * @retval SL_STATUS_OK - Addresses added to the allowlist.
+ *****************************************************************************/
+sl_status_t aoa_db_allowlist_add_bulk(const uint8_t *addresses, size_t count);
+
 /**************************************************************************//**
  * Removes all tags from the allowlist.
  *****************************************************************************/
@@ -185,6 +242,17 @@ sl_status_t aoa_db_allowlist_find(uint8_t address[ADR_LEN]);
  *****************************************************************************/
 size_t aoa_db_allowlist_get_size(void);
 
+/**************************************************************************//**
+ * Copies an address from the allowlist.
+ *
+ * @param[in] index Position on the allowlist, below aoa_db_allowlist_get_size().
+ * @param[out] address Address at the given position.
+ *
+ * @retval SL_STATUS_INVALID_INDEX - No address at the given position.
+ * @retval SL_STATUS_OK - Address copied.
+ *****************************************************************************/
+sl_status_t aoa_db_allowlist_get(size_t index, uint8_t address[ADR_LEN]);
+
 /**************************************************************************//**
  * Deletes every tags.
  *****************************************************************************/
@@ -195,8 +263,12 @@ void aoa_db_remove_all(void);
  * @note To be implemented in user code.
  *
  * @param[in] tag Pointer to tag.
+ *
+ * @retval SL_STATUS_OK - Tag accepted.
+ * @return Any other value rejects the tag, aoa_db_on_tag_removed is not
+ *         called for it then.
  *****************************************************************************/
-void aoa_db_on_tag_added(aoa_db_entry_t *tag);
+sl_status_t aoa_db_on_tag_added(aoa_db_entry_t *tag);
 
 /**************************************************************************//**
  * Tag removed callback.
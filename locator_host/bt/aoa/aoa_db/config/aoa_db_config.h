@@ -0,0 +1,45 @@
+/***************************************************************************//**
+ * @file
+ * @brief Default configuration values for the tag database.
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2024 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ ******************************************************************************/
+
+#ifndef AOA_DB_CONFIG_H
+#define AOA_DB_CONFIG_H
+
+#include "sl_system_config.h"
+
+// Maximum number of tags stored in the database, storage is allocated statically.
+// Can be overridden by the build, e.g. by the host side benchmark.
+#ifndef AOA_DB_MAX_TAG_COUNT
+#define AOA_DB_MAX_TAG_COUNT               SYSTEM_BT_AOA_MAX_TAG_COUNT
+#endif
+
+// Maximum number of addresses on the allowlist, storage is allocated statically.
+#define AOA_DB_MAX_ALLOWLIST_SIZE          256
+
+#endif // AOA_DB_CONFIG_H
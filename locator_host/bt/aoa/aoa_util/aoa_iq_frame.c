@@ -0,0 +1,111 @@
+/***************************************************************************//**
+ * @file
+ * @brief Binary IQ frame encoder and decoder, free of the JSON dependency.
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2024 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ ******************************************************************************/
+
+#include <stddef.h>
+#include <string.h>
+#include "aoa_iq_frame.h"
+
+/***************************************************************************//**
+ * Serialize IQ report data structure into a binary IQ frame.
+ ******************************************************************************/
+sl_status_t aoa_serialize_iq_frame(const aoa_iq_report_t *iq_report,
+                                   const uint8_t *tag_address,
+                                   const uint8_t *locator_address,
+                                   uint8_t *frame,
+                                   size_t size,
+                                   size_t *frame_size)
+{
+  if ((iq_report == NULL) || (tag_address == NULL) || (locator_address == NULL)
+      || (frame == NULL) || (frame_size == NULL)) {
+    return SL_STATUS_NULL_POINTER;
+  }
+  if (size < AOA_IQ_FRAME_HEADER_SIZE) {
+    return SL_STATUS_INVALID_PARAMETER;
+  }
+  size_t length = iq_report->length;
+  if (length > (size - AOA_IQ_FRAME_HEADER_SIZE)) {
+    length = size - AOA_IQ_FRAME_HEADER_SIZE;
+  }
+  length &= ~(size_t)1;
+
+  frame[AOA_IQ_FRAME_OFFSET_VERSION] = AOA_IQ_FRAME_VERSION;
+  frame[AOA_IQ_FRAME_OFFSET_HEADER_SIZE] = AOA_IQ_FRAME_HEADER_SIZE;
+  frame[AOA_IQ_FRAME_OFFSET_CHANNEL] = iq_report->channel;
+  frame[AOA_IQ_FRAME_OFFSET_RSSI] = (uint8_t)iq_report->rssi;
+  frame[AOA_IQ_FRAME_OFFSET_EVENT_COUNTER] = (uint8_t)iq_report->event_counter;
+  frame[AOA_IQ_FRAME_OFFSET_EVENT_COUNTER + 1] = (uint8_t)(iq_report->event_counter >> 8);
+  memcpy(&frame[AOA_IQ_FRAME_OFFSET_TAG_ADDRESS], tag_address, AOA_IQ_FRAME_ADDRESS_SIZE);
+  memcpy(&frame[AOA_IQ_FRAME_OFFSET_LOCATOR_ADDRESS], locator_address, AOA_IQ_FRAME_ADDRESS_SIZE);
+  frame[AOA_IQ_FRAME_OFFSET_LENGTH] = (uint8_t)length;
+  frame[AOA_IQ_FRAME_OFFSET_FLAGS] = 0;
+  if (length > 0) {
+    memcpy(&frame[AOA_IQ_FRAME_HEADER_SIZE], iq_report->samples, length);
+  }
+  *frame_size = AOA_IQ_FRAME_HEADER_SIZE + length;
+  return SL_STATUS_OK;
+}
+
+/***************************************************************************//**
+ * Deserialize IQ report data structure from a binary IQ frame.
+ ******************************************************************************/
+sl_status_t aoa_deserialize_iq_frame(const uint8_t *frame,
+                                     size_t size,
+                                     uint8_t *tag_address,
+                                     uint8_t *locator_address,
+                                     aoa_iq_report_t *iq_report)
+{
+  if ((frame == NULL) || (iq_report == NULL) || (iq_report->samples == NULL)) {
+    return SL_STATUS_NULL_POINTER;
+  }
+  if (size < AOA_IQ_FRAME_HEADER_SIZE) {
+    return SL_STATUS_INVALID_PARAMETER;
+  }
+  if (frame[AOA_IQ_FRAME_OFFSET_VERSION] != AOA_IQ_FRAME_VERSION) {
+    return SL_STATUS_NOT_SUPPORTED;
+  }
+  size_t header_size = frame[AOA_IQ_FRAME_OFFSET_HEADER_SIZE];
+  uint8_t length = frame[AOA_IQ_FRAME_OFFSET_LENGTH];
+  if ((header_size < AOA_IQ_FRAME_HEADER_SIZE) || (size < (header_size + length))) {
+    return SL_STATUS_INVALID_PARAMETER;
+  }
+  iq_report->channel = frame[AOA_IQ_FRAME_OFFSET_CHANNEL];
+  iq_report->rssi = (int8_t)frame[AOA_IQ_FRAME_OFFSET_RSSI];
+  iq_report->event_counter = (uint16_t)(frame[AOA_IQ_FRAME_OFFSET_EVENT_COUNTER]
+                                        | (frame[AOA_IQ_FRAME_OFFSET_EVENT_COUNTER + 1] << 8));
+  if (tag_address != NULL) {
+    memcpy(tag_address, &frame[AOA_IQ_FRAME_OFFSET_TAG_ADDRESS], AOA_IQ_FRAME_ADDRESS_SIZE);
+  }
+  if (locator_address != NULL) {
+    memcpy(locator_address, &frame[AOA_IQ_FRAME_OFFSET_LOCATOR_ADDRESS], AOA_IQ_FRAME_ADDRESS_SIZE);
+  }
+  memcpy(iq_report->samples, &frame[header_size], length);
+  iq_report->length = length;
+  return SL_STATUS_OK;
+}
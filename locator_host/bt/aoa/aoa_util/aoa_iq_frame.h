@@ -0,0 +1,94 @@
+/***************************************************************************//**
+ * @file
+ * @brief Binary IQ frame encoder and decoder, free of the JSON dependency.
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2024 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ ******************************************************************************/
+
+#ifndef AOA_IQ_FRAME_H
+#define AOA_IQ_FRAME_H
+
+#include <stddef.h>
+#include "sl_status.h"
+#include "aoa_types.h"
+
+// Binary IQ frame, all multi-byte fields are little-endian.
+// Decoders shall skip header bytes beyond the known header size, so fields
+// can be appended to the header without changing the version.
+#define AOA_IQ_FRAME_VERSION                1
+#define AOA_IQ_FRAME_ADDRESS_SIZE           6
+#define AOA_IQ_FRAME_OFFSET_VERSION         0  // uint8_t
+#define AOA_IQ_FRAME_OFFSET_HEADER_SIZE     1  // uint8_t, offset of the samples
+#define AOA_IQ_FRAME_OFFSET_CHANNEL         2  // uint8_t
+#define AOA_IQ_FRAME_OFFSET_RSSI            3  // int8_t
+#define AOA_IQ_FRAME_OFFSET_EVENT_COUNTER   4  // uint16_t
+#define AOA_IQ_FRAME_OFFSET_TAG_ADDRESS     6  // uint8_t[6]
+#define AOA_IQ_FRAME_OFFSET_LOCATOR_ADDRESS 12 // uint8_t[6]
+#define AOA_IQ_FRAME_OFFSET_LENGTH          18 // uint8_t, number of sample bytes
+#define AOA_IQ_FRAME_OFFSET_FLAGS           19 // uint8_t, reserved, 0
+#define AOA_IQ_FRAME_HEADER_SIZE            20
+#define AOA_IQ_FRAME_MAX_SIZE               (AOA_IQ_FRAME_HEADER_SIZE + UINT8_MAX)
+
+/***************************************************************************//**
+ * Serialize IQ report data structure into a binary IQ frame.
+ *
+ * Only whole IQ pairs are written, an odd sample byte and the samples that do
+ * not fit the frame buffer are dropped.
+ *
+ * @param[in] iq_report IQ report data structure.
+ * @param[in] tag_address Address of the tag, AOA_IQ_FRAME_ADDRESS_SIZE bytes.
+ * @param[in] locator_address Address of the locator,
+ *                            AOA_IQ_FRAME_ADDRESS_SIZE bytes.
+ * @param[out] frame Frame buffer.
+ * @param[in] size Size of the frame buffer, at least AOA_IQ_FRAME_HEADER_SIZE.
+ * @param[out] frame_size Number of bytes written to the frame buffer.
+ ******************************************************************************/
+sl_status_t aoa_serialize_iq_frame(const aoa_iq_report_t *iq_report,
+                                   const uint8_t *tag_address,
+                                   const uint8_t *locator_address,
+                                   uint8_t *frame,
+                                   size_t size,
+                                   size_t *frame_size);
+
+/***************************************************************************//**
+ * Deserialize IQ report data structure from a binary IQ frame.
+ *
+ * @param[in] frame Frame buffer.
+ * @param[in] size Size of the frame buffer.
+ * @param[out] tag_address Address of the tag, AOA_IQ_FRAME_ADDRESS_SIZE bytes.
+ *                         Ignored if NULL.
+ * @param[out] locator_address Address of the locator,
+ *                             AOA_IQ_FRAME_ADDRESS_SIZE bytes. Ignored if NULL.
+ * @param[out] iq_report IQ report data structure, the samples buffer shall
+ *                       hold UINT8_MAX bytes.
+ ******************************************************************************/
+sl_status_t aoa_deserialize_iq_frame(const uint8_t *frame,
+                                     size_t size,
+                                     uint8_t *tag_address,
+                                     uint8_t *locator_address,
+                                     aoa_iq_report_t *iq_report);
+
+#endif // AOA_IQ_FRAME_H
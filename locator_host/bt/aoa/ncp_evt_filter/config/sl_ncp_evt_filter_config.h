@@ -38,10 +38,24 @@
 
 // <<< Use Configuration Wizard in Context Menu >>>
 
-// <o SL_NCP_EVT_FILTER_ARRAY_LENGTH> Array length of the event filter <1-16>
+// <o SL_NCP_EVT_FILTER_ARRAY_LENGTH> Array length of the event filter <1-255>
 // <i> Default: 8
 // <i> Define the length of Bluetooth NCP event filter buffer.
+// <i> The lookup time does not depend on it, the buffer takes 8 bytes per event.
+// Can be overridden by the build, e.g. by the host side benchmark.
+#ifndef SL_NCP_EVT_FILTER_ARRAY_LENGTH
 #define SL_NCP_EVT_FILTER_ARRAY_LENGTH     8
+#endif
+
+// <o SL_NCP_EVT_FILTER_ADDRESS_LIST_LENGTH> Length of the address allowlist <1-1024>
+// <i> Default: 32
+// <i> Scan reports and Silabs IQ reports of other devices are dropped while the allowlist is not empty.
+#define SL_NCP_EVT_FILTER_ADDRESS_LIST_LENGTH     32
+
+// <o SL_NCP_EVT_FILTER_AD_MATCH_LIST_LENGTH> Number of advertisement data match rules <1-8>
+// <i> Default: 2
+// <i> Scan reports matching none of the rules are dropped while there is at least one rule.
+#define SL_NCP_EVT_FILTER_AD_MATCH_LIST_LENGTH    2
 // <<< end of configuration section >>>
 
 /** @} (end addtogroup ncp_evt_filter) */
@@ -40,11 +40,35 @@
 #define SL_NCP_EVT_FILTER_CMD_ADD_ID    0
 #define SL_NCP_EVT_FILTER_CMD_REMOVE_ID 1
 #define SL_NCP_EVT_FILTER_CMD_RESET_ID  2
+// Content rules, evaluated on the NCP before the event is sent to the host
+#define SL_NCP_EVT_FILTER_CMD_ADD_ADDRESS_ID     3
+#define SL_NCP_EVT_FILTER_CMD_RESET_ADDRESS_ID   4
+#define SL_NCP_EVT_FILTER_CMD_ADD_AD_MATCH_ID    5
+#define SL_NCP_EVT_FILTER_CMD_RESET_AD_MATCH_ID  6
+#define SL_NCP_EVT_FILTER_CMD_SET_MIN_RSSI_ID    7
 
 // Manage event filter command payload length
 #define SL_NCP_EVT_FILTER_CMD_ADD_LEN    5
 #define SL_NCP_EVT_FILTER_CMD_REMOVE_LEN 5
 #define SL_NCP_EVT_FILTER_CMD_RESET_LEN  1
+// Command id followed by count addresses
+#define SL_NCP_EVT_FILTER_CMD_ADD_ADDRESS_LEN(count) \
+  (1 + ((count) * SL_NCP_EVT_FILTER_ADDRESS_LEN))
+#define SL_NCP_EVT_FILTER_CMD_RESET_ADDRESS_LEN  1
+// Command id, AD type and the pattern
+#define SL_NCP_EVT_FILTER_CMD_ADD_AD_MATCH_LEN(pattern_len) (2 + (pattern_len))
+#define SL_NCP_EVT_FILTER_CMD_RESET_AD_MATCH_LEN 1
+// Command id and the minimum RSSI in dBm
+#define SL_NCP_EVT_FILTER_CMD_SET_MIN_RSSI_LEN   2
+
+// Length of a Bluetooth address in the add address command
+#define SL_NCP_EVT_FILTER_ADDRESS_LEN            6
+// Maximum number of addresses in one add address command of 255 bytes
+#define SL_NCP_EVT_FILTER_ADDRESS_MAX_COUNT      ((255 - 1) / SL_NCP_EVT_FILTER_ADDRESS_LEN)
+// Maximum pattern length of an AD match rule, a 128-bit UUID
+#define SL_NCP_EVT_FILTER_AD_MATCH_MAX_LEN       16
+// Minimum RSSI that lets every IQ report through
+#define SL_NCP_EVT_FILTER_MIN_RSSI_DISABLED      (-128)
 
 /** @} (end addtogroup ncp_evt_filter) */
 #endif // SL_NCP_EVT_FILTER_COMMON_H
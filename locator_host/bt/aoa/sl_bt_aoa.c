@@ -15,7 +15,7 @@
  * sections of the MSLA applicable to Source Code.
  *
  ******************************************************************************/
-#include <stdlib.h>
+#include <string.h>
 #include "sl_common.h"
 #include "sl_bt_api.h"
 #include "sl_bt_ncp_host.h"
@@ -26,16 +26,53 @@
 #include "app_log.h"
 #include "sl_system_config.h"
 #include "sl_timer.h"
+#include "sl_latency_trace.h"
+#include "sl_ncp_host_com.h"
+#include "sl_sleeptimer.h"
 
 //macros -----------------------------------------------------------------------
 ///Set to 1 if you wish to report angles instead of the raw IQ data.
 #define SL_BT_AOA_CFG_ANGLE_CALCULATION_ENABLED SYSTEM_BT_AOA_ANGLE_CALCULATION_EN
+///Number of estimator states in the pool, one for each tag of the database.
+#define SLI_BT_AOA_STATE_POOL_SIZE              SYSTEM_BT_AOA_MAX_TAG_COUNT
+///Set to 1 to reuse the configured estimator of a removed tag for the next one.
+#define SL_BT_AOA_CFG_ESTIMATOR_RECYCLING_ENABLED SYSTEM_BT_AOA_ESTIMATOR_RECYCLING_EN
+///Reports older than this are not passed to the angle calculation, in ms. 0 disables the deadline.
+#define SL_BT_AOA_CFG_SCHEDULE_DEADLINE_MS      SYSTEM_BT_AOA_SCHEDULE_DEADLINE_MS
+///Maximum number of angle calculations in one sl_bt_aoa_process_action() call.
+#define SL_BT_AOA_CFG_SCHEDULE_MAX_PER_PASS     SYSTEM_BT_AOA_SCHEDULE_MAX_PER_PASS
+///Stride of a tag with weight 1, the pass of a tag advances by this divided by its weight.
+#define SLI_BT_AOA_SCHEDULE_STRIDE_ONE          0x10000UL
 
 //private type definitions -----------------------------------------------------
+#if SL_BT_AOA_CFG_ANGLE_CALCULATION_ENABLED
+///Scheduling data of a tag, one for each estimator state. At most one report
+///is kept for each tag, a newer one overwrites it. The tags are served by
+///stride scheduling: in the lowest priority class the one with the smallest
+///pass goes first.
+typedef struct {
+  bool pending; ///< A report is waiting for the angle calculation
+  uint32_t received; ///< Sleeptimer tick of the reception of the report
+  aoa_iq_report_t iq_report;
+  int8_t samples[UINT8_MAX];
+  sl_bt_aoa_tag_id_t tag_id;
+  uint8_t priority;
+  uint32_t stride;
+  uint32_t pass;
+} sli_bt_aoa_schedule_slot_t;
+#endif
+
 //private function prototypes --------------------------------------------------
 #if SL_BT_AOA_CFG_ANGLE_CALCULATION_ENABLED
 static inline sl_status_t sli_bt_aoa_calculate_angle(aoa_state_t *state, aoa_iq_report_t *iq, aoa_angle_t *angle);
+static void sli_bt_aoa_state_pool_init(void);
+static aoa_state_t *sli_bt_aoa_state_alloc(bool *configured);
+static void sli_bt_aoa_state_free(aoa_state_t *state, bool configured);
+static void sli_bt_aoa_schedule_add(aoa_state_t *state, const sl_bt_aoa_tag_id_t *tag_id);
+static void sli_bt_aoa_schedule_enqueue(aoa_state_t *state, const aoa_iq_report_t *iq_report);
+static bool sli_bt_aoa_schedule_serve(void);
 #endif
+static void sli_bt_aoa_tag_id_get(const aoa_db_entry_t *tag, sl_bt_aoa_tag_id_t *tag_id);
 
 //private variables ------------------------------------------------------------
 static antenna_array_t sli_bt_aoa_antenna_array;
@@ -43,9 +80,21 @@ static sl_bt_aoa_locator_id_t sli_bt_aoa_locator_id;
 #if SL_BT_AOA_CFG_ANGLE_CALCULATION_ENABLED
 static aoa_angle_config_t *sli_bt_aoa_angle_configuration;
 static aoa_id_t sli_bt_aoa_angle_id = "0";
-SL_TIMER_RUNTIME_STRUCT_DEFINE(sli_bt_aoa_angle_calc_meas);
+SL_TIMER_HIST_STRUCT_DEFINE(sli_bt_aoa_angle_calc_meas);
+///Statically allocated estimator states, the free ones are kept on a stack.
+static aoa_state_t sli_bt_aoa_state_pool[SLI_BT_AOA_STATE_POOL_SIZE];
+static aoa_state_t *sli_bt_aoa_state_free_list[SLI_BT_AOA_STATE_POOL_SIZE];
+static uint32_t sli_bt_aoa_state_free_count;
+///Set for the free states which still hold an initialized estimator.
+static bool sli_bt_aoa_state_configured[SLI_BT_AOA_STATE_POOL_SIZE];
+SL_TIMER_HIST_STRUCT_DEFINE(sli_bt_aoa_tag_admission_meas);
+static sli_bt_aoa_schedule_slot_t sli_bt_aoa_schedule[SLI_BT_AOA_STATE_POOL_SIZE];
+///Pass of the last served tag, the tags becoming pending do not start behind it.
+static uint32_t sli_bt_aoa_schedule_pass;
+static uint32_t sli_bt_aoa_schedule_deadline;
+static sl_bt_aoa_schedule_stats_t sli_bt_aoa_schedule_stats;
 #endif
-SL_TIMER_RUNTIME_STRUCT_DEFINE(sli_bt_aoa_cycle_meas);
+SL_TIMER_HIST_STRUCT_DEFINE(sli_bt_aoa_cycle_meas);
 
 //function definitions----------------------------------------------------------
 void sl_bt_aoa_init(void)
@@ -53,7 +102,13 @@ void sl_bt_aoa_init(void)
   antenna_array_init(&sli_bt_aoa_antenna_array, AOA_ANGLE_ANTENNA_ARRAY_TYPE);
   aoa_cte_config.antenna_array = &sli_bt_aoa_antenna_array;
 
+  sl_timer_hist_register(&sli_bt_aoa_cycle_meas, "bt_aoa_cycle");
+  sl_latency_trace_init();
 #if SL_BT_AOA_CFG_ANGLE_CALCULATION_ENABLED
+  sl_timer_hist_register(&sli_bt_aoa_angle_calc_meas, "bt_aoa_angle_calc");
+  sl_timer_hist_register(&sli_bt_aoa_tag_admission_meas, "bt_aoa_tag_admission");
+  sli_bt_aoa_state_pool_init();
+  (void)sl_sleeptimer_ms32_to_tick(SL_BT_AOA_CFG_SCHEDULE_DEADLINE_MS, &sli_bt_aoa_schedule_deadline);
   sl_status_t status = aoa_angle_add_config(sli_bt_aoa_angle_id, &sli_bt_aoa_angle_configuration);
   SYSTEM_ASSERT(SL_STATUS_OK == status);
   status = aoa_angle_finalize_config(sli_bt_aoa_angle_id);
@@ -63,9 +118,31 @@ void sl_bt_aoa_init(void)
   sl_bt_system_reset(sl_bt_system_boot_mode_normal);
 }
 
+void sl_bt_aoa_process_action(void)
+{
+  aoa_cte_process_action();
+#if SL_BT_AOA_CFG_ANGLE_CALCULATION_ENABLED
+  for (uint32_t i = 0; i < SL_BT_AOA_CFG_SCHEDULE_MAX_PER_PASS; i++) {
+    if (!sli_bt_aoa_schedule_serve()) {
+      break;
+    }
+  }
+#endif
+}
+
+void sl_bt_aoa_get_schedule_stats(sl_bt_aoa_schedule_stats_t *stats)
+{
+#if SL_BT_AOA_CFG_ANGLE_CALCULATION_ENABLED
+  *stats = sli_bt_aoa_schedule_stats;
+#else
+  memset(stats, 0, sizeof(*stats));
+#endif
+}
+
 void sl_bt_on_event(sl_bt_msg_t *evt)
 {
-  sl_timer_runtime_meas_start(&sli_bt_aoa_cycle_meas);
+  sl_timer_hist_start(&sli_bt_aoa_cycle_meas);
+  sl_latency_trace_dispatch();
 
   switch (SL_BT_MSG_ID(evt->header)) {
     case sl_bt_evt_system_boot_id:
@@ -98,22 +175,89 @@ void sl_bt_on_event(sl_bt_msg_t *evt)
   }
 
   aoa_cte_bt_on_event(evt);
-  sl_timer_runtime_meas_stop(&sli_bt_aoa_cycle_meas);
+  sl_timer_hist_stop(&sli_bt_aoa_cycle_meas);
 }
 
 /**************************************************************************//**
  * Tag added callback (will be called before IQ report)
  *
+ * The tag is rejected if no estimator can be set up for it, the locator keeps
+ * serving the tags it already has.
+ *
  * @param[in] tag Pointer to tag.
  *****************************************************************************/
-void aoa_db_on_tag_added(aoa_db_entry_t *tag)
+sl_status_t aoa_db_on_tag_added(aoa_db_entry_t *tag)
 {
 #if SL_BT_AOA_CFG_ANGLE_CALCULATION_ENABLED
-  tag->user_data = malloc(sizeof(aoa_state_t));
-  SYSTEM_ASSERT(NULL != tag->user_data, "Failed to allocate memory for aoa state.");
+  bool configured;
+  enum sl_rtl_error_code ec;
+  sl_bt_aoa_tag_id_t tag_id;
+  sl_status_t sc = SL_STATUS_OK;
 
-  enum sl_rtl_error_code ec = aoa_init_rtl(tag->user_data, sli_bt_aoa_angle_id, false);
-  SYSTEM_ASSERT(ec == SL_RTL_ERROR_SUCCESS, "aoa_init_rtl failed (%d)", ec);
+  sl_timer_hist_start(&sli_bt_aoa_tag_admission_meas);
+  aoa_state_t *state = sli_bt_aoa_state_alloc(&configured);
+  if (NULL == state) {
+    app_log_debug("No estimator state left, tag rejected." APP_LOG_NL);
+    sc = SL_STATUS_ALLOCATION_FAILED;
+    goto stop;
+  }
+
+  if (configured) {
+    ec = aoa_reset_rtl(state, sli_bt_aoa_angle_id);
+    if (SL_RTL_ERROR_SUCCESS != ec) {
+      //config changed or the reset failed, build the estimator from scratch
+      (void)aoa_deinit_rtl(state, sli_bt_aoa_angle_id);
+      memset(state, 0, sizeof(*state));
+      configured = false;
+    }
+  }
+
+  if (!configured) {
+    ec = aoa_init_rtl(state, sli_bt_aoa_angle_id, false);
+    if (SL_RTL_ERROR_SUCCESS != ec) {
+      app_log_debug("aoa_init_rtl failed (%d), tag rejected." APP_LOG_NL, ec);
+      sli_bt_aoa_state_free(state, false);
+      sc = SL_STATUS_ALLOCATION_FAILED;
+      goto stop;
+    }
+  }
+  tag->user_data = state;
+  sli_bt_aoa_tag_id_get(tag, &tag_id);
+  sli_bt_aoa_schedule_add(state, &tag_id);
+
+stop:
+  //rejected tags are measured as well, every start needs its stop
+  sl_timer_hist_stop(&sli_bt_aoa_tag_admission_meas);
+  return sc;
+#else
+  (void)tag;
+  return SL_STATUS_OK;
+#endif
+}
+
+/**************************************************************************//**
+ * Tag removed callback
+ *
+ * @param[in] tag Pointer to tag.
+ *****************************************************************************/
+void aoa_db_on_tag_removed(aoa_db_entry_t *tag)
+{
+#if SL_BT_AOA_CFG_ANGLE_CALCULATION_ENABLED
+  if (NULL != tag->user_data) {
+    //a report still waiting is dropped with the tag
+    sli_bt_aoa_schedule[(aoa_state_t *)tag->user_data - sli_bt_aoa_state_pool].pending = false;
+#if SL_BT_AOA_CFG_ESTIMATOR_RECYCLING_ENABLED
+    //keep the estimator configured, the next tag only resets it
+    sli_bt_aoa_state_free(tag->user_data, true);
+#else
+    enum sl_rtl_error_code ec = aoa_deinit_rtl(tag->user_data, sli_bt_aoa_angle_id);
+    if (SL_RTL_ERROR_SUCCESS != ec) {
+      app_log_warning("aoa_deinit_rtl failed (%d)" APP_LOG_NL, ec);
+    }
+    sli_bt_aoa_state_free(tag->user_data, false);
+#endif
+    tag->user_data = NULL;
+  }
 #else
   (void)tag;
 #endif
@@ -128,19 +272,13 @@ void aoa_db_on_tag_added(aoa_db_entry_t *tag)
 void aoa_cte_on_iq_report(aoa_db_entry_t *tag,
                           aoa_iq_report_t *iq_report)
 {
-  const sl_bt_aoa_tag_id_t tag_id = {
-    .mac_addr = {
-      tag->address.addr[0], tag->address.addr[1], tag->address.addr[2],
-      tag->address.addr[3], tag->address.addr[4], tag->address.addr[5]
-    }
-  };
+  sl_bt_aoa_tag_id_t tag_id;
 
+  sli_bt_aoa_tag_id_get(tag, &tag_id);
+  sl_latency_trace_open(tag_id.system_id, iq_report->event_counter);
 #if SL_BT_AOA_CFG_ANGLE_CALCULATION_ENABLED
-  aoa_angle_t angle = { 0 };
-  sl_status_t sc = sli_bt_aoa_calculate_angle(tag->user_data, iq_report, &angle);
-  if (SL_STATUS_OK == sc) {
-    sl_bt_aoa_on_angle_report(&sli_bt_aoa_locator_id, &tag_id, &angle);
-  }
+  //the angle is calculated from sl_bt_aoa_process_action()
+  sli_bt_aoa_schedule_enqueue(tag->user_data, iq_report);
 #else
   sl_bt_aoa_on_iq_report(&sli_bt_aoa_locator_id, &tag_id, iq_report);
 #endif
@@ -149,13 +287,129 @@ void aoa_cte_on_iq_report(aoa_db_entry_t *tag,
 #if SL_BT_AOA_CFG_ANGLE_CALCULATION_ENABLED
 static inline sl_status_t sli_bt_aoa_calculate_angle(aoa_state_t *state, aoa_iq_report_t *iq, aoa_angle_t *angle)
 {
-  sl_timer_runtime_meas_start(&sli_bt_aoa_angle_calc_meas);
+  sl_timer_hist_start(&sli_bt_aoa_angle_calc_meas);
   enum sl_rtl_error_code sc = aoa_calculate(state, iq, angle, sli_bt_aoa_angle_id);
-  sl_timer_runtime_meas_stop(&sli_bt_aoa_angle_calc_meas);
+  sl_timer_hist_stop(&sli_bt_aoa_angle_calc_meas);
   return sc; //TODO convert to sl_status_t (indifferent at the moment because we only check success/0)
 }
+
+static void sli_bt_aoa_schedule_add(aoa_state_t *state, const sl_bt_aoa_tag_id_t *tag_id)
+{
+  sli_bt_aoa_schedule_slot_t *slot = &sli_bt_aoa_schedule[state - sli_bt_aoa_state_pool];
+  sl_bt_aoa_schedule_t schedule = { .priority = 0, .weight = 1 };
+
+  sl_bt_aoa_on_tag_schedule(tag_id, &schedule);
+  slot->pending = false;
+  slot->tag_id = *tag_id;
+  slot->priority = schedule.priority;
+  slot->stride = SLI_BT_AOA_SCHEDULE_STRIDE_ONE / ((schedule.weight > 0) ? schedule.weight : 1);
+  slot->pass = sli_bt_aoa_schedule_pass;
+}
+
+static void sli_bt_aoa_schedule_enqueue(aoa_state_t *state, const aoa_iq_report_t *iq_report)
+{
+  sli_bt_aoa_schedule_slot_t *slot = &sli_bt_aoa_schedule[state - sli_bt_aoa_state_pool];
+
+  if (slot->pending) {
+    sli_bt_aoa_schedule_stats.replaced++;
+  } else if ((int32_t)(slot->pass - sli_bt_aoa_schedule_pass) < 0) {
+    //an idle tag does not collect credit for a burst later
+    slot->pass = sli_bt_aoa_schedule_pass;
+  }
+  slot->pending = true;
+  slot->received = sl_sleeptimer_get_tick_count();
+  slot->iq_report = *iq_report;
+  slot->iq_report.samples = slot->samples;
+  memcpy(slot->samples, iq_report->samples, iq_report->length);
+}
+
+//serves one pending report, returns false if there was none
+static bool sli_bt_aoa_schedule_serve(void)
+{
+  uint32_t now = sl_sleeptimer_get_tick_count();
+  sli_bt_aoa_schedule_slot_t *next = NULL;
+
+  for (uint32_t i = 0; i < SLI_BT_AOA_STATE_POOL_SIZE; i++) {
+    sli_bt_aoa_schedule_slot_t *slot = &sli_bt_aoa_schedule[i];
+    if (!slot->pending) {
+      continue;
+    }
+    if ((sli_bt_aoa_schedule_deadline > 0) && ((now - slot->received) > sli_bt_aoa_schedule_deadline)) {
+      slot->pending = false;
+      sli_bt_aoa_schedule_stats.expired++;
+      continue;
+    }
+    if ((NULL == next)
+        || (slot->priority < next->priority)
+        || ((slot->priority == next->priority) && ((int32_t)(slot->pass - next->pass) < 0))) {
+      next = slot;
+    }
+  }
+  if (NULL == next) {
+    return false;
+  }
+
+  next->pending = false;
+  sli_bt_aoa_schedule_pass = next->pass;
+  next->pass += next->stride;
+  sli_bt_aoa_schedule_stats.served++;
+
+  aoa_angle_t angle = { 0 };
+  aoa_state_t *state = &sli_bt_aoa_state_pool[next - sli_bt_aoa_schedule];
+  sl_status_t sc = sli_bt_aoa_calculate_angle(state, &next->iq_report, &angle);
+  sl_latency_trace_mark(next->tag_id.system_id, next->iq_report.event_counter, SL_LATENCY_TRACE_STAGE_ANGLE);
+  if (SL_STATUS_OK == sc) {
+    sl_bt_aoa_on_angle_report(&sli_bt_aoa_locator_id, &next->tag_id, &angle);
+  }
+  return true;
+}
+
+static void sli_bt_aoa_state_pool_init(void)
+{
+  for (uint32_t i = 0; i < SLI_BT_AOA_STATE_POOL_SIZE; i++) {
+    sli_bt_aoa_state_free_list[i] = &sli_bt_aoa_state_pool[SLI_BT_AOA_STATE_POOL_SIZE - 1 - i];
+  }
+  sli_bt_aoa_state_free_count = SLI_BT_AOA_STATE_POOL_SIZE;
+}
+
+static aoa_state_t *sli_bt_aoa_state_alloc(bool *configured)
+{
+  if (0 == sli_bt_aoa_state_free_count) {
+    return NULL;
+  }
+  aoa_state_t *state = sli_bt_aoa_state_free_list[--sli_bt_aoa_state_free_count];
+  *configured = sli_bt_aoa_state_configured[state - sli_bt_aoa_state_pool];
+  if (!*configured) {
+    memset(state, 0, sizeof(*state));
+  }
+  return state;
+}
+
+//the stack hands out the most recently freed, thus configured, states first
+static void sli_bt_aoa_state_free(aoa_state_t *state, bool configured)
+{
+  sli_bt_aoa_state_configured[state - sli_bt_aoa_state_pool] = configured;
+  sli_bt_aoa_state_free_list[sli_bt_aoa_state_free_count++] = state;
+}
 #endif
 
+static void sli_bt_aoa_tag_id_get(const aoa_db_entry_t *tag, sl_bt_aoa_tag_id_t *tag_id)
+{
+  memset(tag_id, 0, sizeof(*tag_id));
+  memcpy(tag_id->mac_addr, tag->address.addr, sizeof(tag_id->mac_addr));
+}
+
+/**************************************************************************//**
+ * Data received from the NCP, the start of the latency trace of the reports.
+ *
+ * @param[in] len Received message length
+ *****************************************************************************/
+void sl_ncp_host_com_on_receive(uint32_t len)
+{
+  (void)len;
+  sl_latency_trace_uart_rx();
+}
+
 SL_WEAK void sl_bt_aoa_on_iq_report(const sl_bt_aoa_locator_id_t *locator_id,
                                     const sl_bt_aoa_tag_id_t *tag_id,
                                     const aoa_iq_report_t *iq)
@@ -165,6 +419,13 @@ SL_WEAK void sl_bt_aoa_on_iq_report(const sl_bt_aoa_locator_id_t *locator_id,
   (void)iq;
 }
 
+SL_WEAK void sl_bt_aoa_on_tag_schedule(const sl_bt_aoa_tag_id_t *tag_id,
+                                       sl_bt_aoa_schedule_t *schedule)
+{
+  (void)tag_id;
+  (void)schedule;
+}
+
 SL_WEAK void sl_bt_aoa_on_angle_report(const sl_bt_aoa_locator_id_t *locator_id,
                                        const sl_bt_aoa_tag_id_t *tag_id,
                                        const aoa_angle_t *angle)
@@ -34,6 +34,19 @@ typedef struct {
 //< MAC address of the locator board. (The last 2 byte will be always 0.)
 typedef sl_bt_aoa_tag_id_t sl_bt_aoa_locator_id_t;
 
+//< Scheduling parameters of a tag for the angle calculation.
+typedef struct {
+  uint8_t priority; //< Class of the tag, the pending reports of class 0 are served first.
+  uint8_t weight;   //< Share of the tag within its class, a tag with weight 2 is served twice as often as one with 1.
+} sl_bt_aoa_schedule_t;
+
+//< Statistics of the angle calculation scheduler.
+typedef struct {
+  uint32_t served;   //< Reports passed to the angle calculation.
+  uint32_t replaced; //< Reports overwritten by a newer one of the same tag before they were served.
+  uint32_t expired;  //< Reports dropped after waiting longer than the deadline.
+} sl_bt_aoa_schedule_stats_t;
+
 //global variables -------------------------------------------------------------
 //function prototypes ----------------------------------------------------------
 
@@ -42,6 +55,33 @@ typedef sl_bt_aoa_tag_id_t sl_bt_aoa_locator_id_t;
  ******************************************************************************/
 void sl_bt_aoa_init(void);
 
+/***************************************************************************//**
+ * Periodic processing of the BT AOA component, e.g. the removal of the tags
+ * that went out of range and the angle calculation of the pending reports.
+ * Shall be called from the main loop.
+ ******************************************************************************/
+void sl_bt_aoa_process_action(void);
+
+/***************************************************************************//**
+ * Gets the statistics of the angle calculation scheduler.
+ *
+ * @param[out] stats Statistics since the start.
+ ******************************************************************************/
+void sl_bt_aoa_get_schedule_stats(sl_bt_aoa_schedule_stats_t *stats);
+
+/***************************************************************************//**
+ * Weekly defined function which will be called when a tag is added, to set
+ * its scheduling parameters. The default is priority 0 and weight 1 for all
+ * tags, that is round-robin.
+ *
+ * @param[in] tag_id Identification of the new tag.
+ * @param[in,out] schedule Scheduling parameters of the tag.
+ *
+ * @note Won't be called if @ref SL_BT_AOA_CFG_ANGLE_CALCULATION_ENABLED is 0
+ ******************************************************************************/
+void sl_bt_aoa_on_tag_schedule(const sl_bt_aoa_tag_id_t *tag_id,
+                               sl_bt_aoa_schedule_t *schedule);
+
 /***************************************************************************//**
  * Weekly defined function which will be called when an IQ report is received
  * from an AOA tag.
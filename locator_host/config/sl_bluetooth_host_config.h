@@ -0,0 +1,52 @@
+/***************************************************************************//**
+ * @file
+ * @brief Bluetooth NCP host event dispatch configuration
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2024 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Zlib
+ *
+ * The licensor of this software is Silicon Laboratories Inc.
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty. In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ ******************************************************************************/
+#ifndef SL_BLUETOOTH_HOST_CONFIG_H
+#define SL_BLUETOOTH_HOST_CONFIG_H
+
+// <<< Use Configuration Wizard in Context Menu >>>
+
+// <h> Event dispatch
+
+// <o SL_BT_HOST_STEP_MAX_EVENTS> Maximum events processed per sl_bt_step() call <1-255>
+// <i> Default: 8
+// <i> Number of queued BGAPI events drained in one pass of the super loop.
+#define SL_BT_HOST_STEP_MAX_EVENTS      (8)
+
+// <o SL_BT_HOST_STEP_TIME_BUDGET_US> Time budget per sl_bt_step() call (us) <0-1000000>
+// <i> Default: 2000
+// <i> Stop draining events once this much time has elapsed. 0 disables the limit.
+// <i> The resolution is one sleeptimer tick.
+#define SL_BT_HOST_STEP_TIME_BUDGET_US  (2000)
+
+// </h>
+
+// <<< end of configuration section >>>
+
+#endif // SL_BLUETOOTH_HOST_CONFIG_H
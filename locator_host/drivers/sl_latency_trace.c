@@ -0,0 +1,197 @@
+/***************************************************************************//**
+ * @file
+ * @brief Per report latency trace of the host pipeline
+ * @version 1.0.0
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2024 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * The licensor of this software is Silicon Laboratories Inc. Your use of this
+ * software is governed by the terms of Silicon Labs Master Software License
+ * Agreement (MSLA) available at
+ * www.silabs.com/about-us/legal/master-software-license-agreement. This
+ * software is distributed to you in Source Code format and is governed by the
+ * sections of the MSLA applicable to Source Code.
+ *
+ ******************************************************************************/
+#include <stdbool.h>
+#include "em_core.h"
+#include "sl_latency_trace.h"
+#include "sl_timer.h"
+#include "sl_sleeptimer.h"
+#include "app_log.h"
+
+#if SL_LATENCY_TRACE_EN
+//macros -----------------------------------------------------------------------
+///Number of stage histograms, the last one holds the total latency.
+#define SLI_LATENCY_TRACE_HIST_COUNT      (SL_LATENCY_TRACE_STAGE_COUNT + 1)
+#define SLI_LATENCY_TRACE_HIST_TOTAL      SL_LATENCY_TRACE_STAGE_COUNT
+
+//private type definitions -----------------------------------------------------
+//private function prototypes --------------------------------------------------
+static sl_latency_trace_record_t *sli_latency_trace_find(uint64_t tag_id, uint16_t sequence);
+static void sli_latency_trace_stamp(sl_latency_trace_record_t *record,
+                                    sl_latency_trace_stage_t stage,
+                                    uint32_t now);
+
+//private variables ------------------------------------------------------------
+///Ring of the records, head is the next one to be written.
+static sl_latency_trace_record_t sli_latency_trace_ring[SL_LATENCY_TRACE_RECORD_COUNT];
+static uint32_t sli_latency_trace_head;
+static uint32_t sli_latency_trace_count;
+///Receive time noted by the UART interrupt, taken over by the next dispatch.
+static volatile uint32_t sli_latency_trace_rx_time;
+static volatile bool sli_latency_trace_rx_pending;
+///Timestamps of the event being dispatched, the receive time is used by one record only.
+static uint32_t sli_latency_trace_event_rx_time;
+static bool sli_latency_trace_event_rx_valid;
+static uint32_t sli_latency_trace_event_dispatch_time;
+#if SL_TIMER_RUNTIME_MEASUREMENT_API_EN
+///Time spent reaching each stage from the previous stamped one, and the total.
+static sl_timer_hist_t sli_latency_trace_hist[SLI_LATENCY_TRACE_HIST_COUNT];
+#endif
+
+//function definitions----------------------------------------------------------
+void sli_latency_trace_init(void)
+{
+  sl_timer_hist_register(&sli_latency_trace_hist[SL_LATENCY_TRACE_STAGE_DISPATCH], "trace_queue");
+  sl_timer_hist_register(&sli_latency_trace_hist[SL_LATENCY_TRACE_STAGE_IQ_REPORT], "trace_parse");
+  sl_timer_hist_register(&sli_latency_trace_hist[SL_LATENCY_TRACE_STAGE_ANGLE], "trace_angle");
+  sl_timer_hist_register(&sli_latency_trace_hist[SL_LATENCY_TRACE_STAGE_PUBLISH], "trace_publish");
+  sl_timer_hist_register(&sli_latency_trace_hist[SLI_LATENCY_TRACE_HIST_TOTAL], "trace_total");
+}
+
+void sli_latency_trace_uart_rx(void)
+{
+  if (!sli_latency_trace_rx_pending) {
+    sli_latency_trace_rx_time = sl_timer_get();
+    sli_latency_trace_rx_pending = true;
+  }
+}
+
+void sli_latency_trace_dispatch(void)
+{
+  CORE_DECLARE_IRQ_STATE;
+
+  sli_latency_trace_event_dispatch_time = sl_timer_get();
+  //the UART interrupt shall not note a new receive time between the read and the clear
+  CORE_ENTER_ATOMIC();
+  if (sli_latency_trace_rx_pending) {
+    sli_latency_trace_event_rx_time = sli_latency_trace_rx_time;
+    sli_latency_trace_event_rx_valid = true;
+    sli_latency_trace_rx_pending = false;
+  }
+  CORE_EXIT_ATOMIC();
+}
+
+void sli_latency_trace_open(uint64_t tag_id, uint16_t sequence)
+{
+  uint32_t now = sl_timer_get();
+  sl_latency_trace_record_t *record = &sli_latency_trace_ring[sli_latency_trace_head];
+
+  sli_latency_trace_head = (sli_latency_trace_head + 1) % SL_LATENCY_TRACE_RECORD_COUNT;
+  if (sli_latency_trace_count < SL_LATENCY_TRACE_RECORD_COUNT) {
+    sli_latency_trace_count++;
+  }
+
+  record->tag_id = tag_id;
+  record->sequence = sequence;
+  record->stamped = 0;
+  if (sli_latency_trace_event_rx_valid) {
+    sli_latency_trace_stamp(record, SL_LATENCY_TRACE_STAGE_UART_RX, sli_latency_trace_event_rx_time);
+    sli_latency_trace_event_rx_valid = false;
+  }
+  sli_latency_trace_stamp(record, SL_LATENCY_TRACE_STAGE_DISPATCH, sli_latency_trace_event_dispatch_time);
+  sli_latency_trace_stamp(record, SL_LATENCY_TRACE_STAGE_IQ_REPORT, now);
+}
+
+void sli_latency_trace_mark(uint64_t tag_id, uint16_t sequence, sl_latency_trace_stage_t stage)
+{
+  uint32_t now = sl_timer_get();
+  sl_latency_trace_record_t *record = sli_latency_trace_find(tag_id, sequence);
+
+  if ((NULL != record) && (0 == (record->stamped & (1U << stage)))) {
+    sli_latency_trace_stamp(record, stage, now);
+  }
+}
+
+void sli_latency_trace_dump(void)
+{
+  uint32_t index = (sli_latency_trace_head + SL_LATENCY_TRACE_RECORD_COUNT - sli_latency_trace_count)
+                   % SL_LATENCY_TRACE_RECORD_COUNT;
+
+  app_log_info("latency_trace_begin,%lu" APP_LOG_NL, (unsigned long)sl_timer_get_frequency());
+  for (uint32_t i = 0; i < sli_latency_trace_count; i++) {
+    const sl_latency_trace_record_t *record = &sli_latency_trace_ring[index];
+    app_log_info("latency_trace,%012llX,%u", (unsigned long long)record->tag_id, (unsigned)record->sequence);
+    for (uint32_t stage = 0; stage < SL_LATENCY_TRACE_STAGE_COUNT; stage++) {
+      if (record->stamped & (1U << stage)) {
+        app_log_info(",%lu", (unsigned long)record->time[stage]);
+      } else {
+        app_log_info(",");
+      }
+    }
+    app_log_info(APP_LOG_NL);
+    index = (index + 1) % SL_LATENCY_TRACE_RECORD_COUNT;
+  }
+  app_log_info("latency_trace_end" APP_LOG_NL);
+}
+
+void sli_latency_trace_process_action(void)
+{
+#if SL_LATENCY_TRACE_DUMP_PERIOD_MS
+  static uint32_t period = 0;
+  static uint32_t last_dump = 0;
+  uint32_t now = sl_sleeptimer_get_tick_count();
+
+  if (0 == period) {
+    (void)sl_sleeptimer_ms32_to_tick(SL_LATENCY_TRACE_DUMP_PERIOD_MS, &period);
+    last_dump = now;
+  }
+  if ((now - last_dump) >= period) {
+    last_dump = now;
+    sli_latency_trace_dump();
+  }
+#endif
+}
+
+//newest first, the later stages usually follow the opening closely
+static sl_latency_trace_record_t *sli_latency_trace_find(uint64_t tag_id, uint16_t sequence)
+{
+  uint32_t index = sli_latency_trace_head;
+
+  for (uint32_t i = 0; i < sli_latency_trace_count; i++) {
+    index = (index + SL_LATENCY_TRACE_RECORD_COUNT - 1) % SL_LATENCY_TRACE_RECORD_COUNT;
+    sl_latency_trace_record_t *record = &sli_latency_trace_ring[index];
+    if ((record->tag_id == tag_id) && (record->sequence == sequence)) {
+      return record;
+    }
+  }
+  return NULL;
+}
+
+//stamps the stage and records the time spent since the previous stamped one
+static void sli_latency_trace_stamp(sl_latency_trace_record_t *record,
+                                    sl_latency_trace_stage_t stage,
+                                    uint32_t now)
+{
+  record->time[stage] = now;
+  record->stamped |= (uint8_t)(1U << stage);
+
+  for (int32_t prev = (int32_t)stage - 1; prev >= 0; prev--) {
+    if (record->stamped & (1U << prev)) {
+      sl_timer_hist_add(&sli_latency_trace_hist[stage], now - record->time[prev]);
+      break;
+    }
+  }
+  if (SL_LATENCY_TRACE_STAGE_PUBLISH == stage) {
+    for (uint32_t first = 0; first < stage; first++) {
+      if (record->stamped & (1U << first)) {
+        sl_timer_hist_add(&sli_latency_trace_hist[SLI_LATENCY_TRACE_HIST_TOTAL], now - record->time[first]);
+        break;
+      }
+    }
+  }
+}
+#endif
@@ -0,0 +1,137 @@
+/***************************************************************************//**
+ * @file
+ * @brief Per report latency trace of the host pipeline
+ * @version 1.0.0
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2024 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * The licensor of this software is Silicon Laboratories Inc. Your use of this
+ * software is governed by the terms of Silicon Labs Master Software License
+ * Agreement (MSLA) available at
+ * www.silabs.com/about-us/legal/master-software-license-agreement. This
+ * software is distributed to you in Source Code format and is governed by the
+ * sections of the MSLA applicable to Source Code.
+ *
+ ******************************************************************************/
+#ifndef SL_LATENCY_TRACE_H
+#define SL_LATENCY_TRACE_H
+#ifdef __cplusplus
+extern "C" {
+#endif
+#include <stdint.h>
+
+//macros -----------------------------------------------------------------------
+#if DEBUG
+  #define SL_LATENCY_TRACE_EN 1
+#endif
+
+///Number of reports kept in the trace ring, the oldest one is overwritten.
+#define SL_LATENCY_TRACE_RECORD_COUNT     64
+///Period of the raw trace dump in ms, 0 disables the periodic dump.
+#define SL_LATENCY_TRACE_DUMP_PERIOD_MS   0
+
+#if SL_LATENCY_TRACE_EN
+  #define sl_latency_trace_init(...)           sli_latency_trace_init(__VA_ARGS__)
+  #define sl_latency_trace_uart_rx(...)        sli_latency_trace_uart_rx(__VA_ARGS__)
+  #define sl_latency_trace_dispatch(...)       sli_latency_trace_dispatch(__VA_ARGS__)
+  #define sl_latency_trace_open(...)           sli_latency_trace_open(__VA_ARGS__)
+  #define sl_latency_trace_mark(...)           sli_latency_trace_mark(__VA_ARGS__)
+  #define sl_latency_trace_dump(...)           sli_latency_trace_dump(__VA_ARGS__)
+  #define sl_latency_trace_process_action(...) sli_latency_trace_process_action(__VA_ARGS__)
+#else
+  #define sl_latency_trace_init(...)
+  #define sl_latency_trace_uart_rx(...)
+  #define sl_latency_trace_dispatch(...)
+  #define sl_latency_trace_open(...)
+  #define sl_latency_trace_mark(...)
+  #define sl_latency_trace_dump(...)
+  #define sl_latency_trace_process_action(...)
+#endif
+
+//type definitions -------------------------------------------------------------
+///Trace points of a report, in the order the report passes them.
+typedef enum {
+  SL_LATENCY_TRACE_STAGE_UART_RX,   ///< First UART chunk of the event received
+  SL_LATENCY_TRACE_STAGE_DISPATCH,  ///< Event left the BGAPI queue
+  SL_LATENCY_TRACE_STAGE_IQ_REPORT, ///< IQ report parsed, the record is opened here
+  SL_LATENCY_TRACE_STAGE_ANGLE,     ///< Angle calculation finished
+  SL_LATENCY_TRACE_STAGE_PUBLISH,   ///< Message handed to the publisher
+  SL_LATENCY_TRACE_STAGE_COUNT
+} sl_latency_trace_stage_t;
+
+///Trace of one report.
+typedef struct {
+  uint64_t tag_id; ///< Tag the report came from
+  uint16_t sequence; ///< Event counter of the report
+  uint8_t stamped; ///< Bit mask of the stages that have a timestamp
+  uint32_t time[SL_LATENCY_TRACE_STAGE_COUNT]; ///< Timestamps in sl_timer ticks
+} sl_latency_trace_record_t;
+
+//global variables -------------------------------------------------------------
+//function prototypes ----------------------------------------------------------
+/***************************************************************************//**
+ * Registers the stage histograms for the sl_timer histogram dump.
+ *
+ * @warning Internal function DO NOT use directly, use the macro with the "sl" prefix!
+ ******************************************************************************/
+void sli_latency_trace_init(void);
+
+/***************************************************************************//**
+ * Notes that data was received from the NCP. Can be called from interrupt.
+ * The first record opened after the next pop is stamped with the time of the
+ * first call since the previous pop. Further records of events received in the
+ * same chunk have no receive stamp, their trace starts at the dispatch.
+ *
+ * @warning Internal function DO NOT use directly, use the macro with the "sl" prefix!
+ ******************************************************************************/
+void sli_latency_trace_uart_rx(void);
+
+/***************************************************************************//**
+ * Notes that an event left the BGAPI queue and is being dispatched.
+ *
+ * @warning Internal function DO NOT use directly, use the macro with the "sl" prefix!
+ ******************************************************************************/
+void sli_latency_trace_dispatch(void);
+
+/***************************************************************************//**
+ * Opens the record of a report from the event being dispatched.
+ * @param tag_id: Tag the report came from.
+ * @param sequence: Event counter of the report.
+ *
+ * @warning Internal function DO NOT use directly, use the macro with the "sl" prefix!
+ ******************************************************************************/
+void sli_latency_trace_open(uint64_t tag_id, uint16_t sequence);
+
+/***************************************************************************//**
+ * Stamps a stage of an open record. Does nothing if the record is not in the
+ * ring anymore.
+ * @param tag_id: Tag the report came from.
+ * @param sequence: Event counter of the report.
+ * @param stage: Stage reached by the report.
+ *
+ * @warning Internal function DO NOT use directly, use the macro with the "sl" prefix!
+ ******************************************************************************/
+void sli_latency_trace_mark(uint64_t tag_id, uint16_t sequence, sl_latency_trace_stage_t stage);
+
+/***************************************************************************//**
+ * Logs the records of the ring, oldest first, for the trace converter
+ * in tools/latency_trace.
+ *
+ * @warning Internal function DO NOT use directly, use the macro with the "sl" prefix!
+ ******************************************************************************/
+void sli_latency_trace_dump(void);
+
+/***************************************************************************//**
+ * Dumps the ring in every SL_LATENCY_TRACE_DUMP_PERIOD_MS.
+ * Shall be called from the main loop.
+ *
+ * @warning Internal function DO NOT use directly, use the macro with the "sl" prefix!
+ ******************************************************************************/
+void sli_latency_trace_process_action(void);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* SL_LATENCY_TRACE_H */
@@ -31,16 +31,42 @@ extern "C" {
 /// Exponential moving average factor (higher value "prefers" fresh data). A commonly used value is factor=2/(N+1), where N is the number of samples for a SMA.
 #define SL_TIMER_RUNTIME_MEAS_AVG_EMA_COEFF (0.005F)
 
+///Linear sub-buckets in each power of two range of a histogram, given in bits. 2 bits keeps the bucket width below 25% of the value.
+#define SL_TIMER_HIST_SUB_BUCKET_BITS       2
+#define SL_TIMER_HIST_SUB_BUCKET_COUNT      (1UL << SL_TIMER_HIST_SUB_BUCKET_BITS)
+///Number of buckets to cover the whole 32 bit tick range.
+#define SL_TIMER_HIST_BUCKET_COUNT          ((32 - SL_TIMER_HIST_SUB_BUCKET_BITS + 1) * SL_TIMER_HIST_SUB_BUCKET_COUNT)
+///Period of the histogram dump in ms, 0 disables the periodic dump.
+#define SL_TIMER_HIST_DUMP_PERIOD_MS        10000
+
 #if SL_TIMER_RUNTIME_MEASUREMENT_API_EN
   #define SL_TIMER_RUNTIME_STRUCT_DEFINE(name) static sl_timer_runtime_t name
   #define sl_timer_runtime_meas_start(...)     sli_timer_runtime_meas_start(__VA_ARGS__)
   #define sl_timer_runtime_meas_stop(...)      sli_timer_runtime_meas_stop(__VA_ARGS__)
   #define sl_timer_runtime_meas_reset(...)     sli_timer_runtime_meas_reset(__VA_ARGS__)
+  #define SL_TIMER_HIST_STRUCT_DEFINE(name)    static sl_timer_hist_t name
+  #define sl_timer_hist_register(...)          sli_timer_hist_register(__VA_ARGS__)
+  #define sl_timer_hist_start(...)             sli_timer_hist_start(__VA_ARGS__)
+  #define sl_timer_hist_stop(...)              sli_timer_hist_stop(__VA_ARGS__)
+  #define sl_timer_hist_add(...)               sli_timer_hist_add(__VA_ARGS__)
+  #define sl_timer_hist_reset(...)             sli_timer_hist_reset(__VA_ARGS__)
+  #define sl_timer_hist_get_percentile(...)    sli_timer_hist_get_percentile(__VA_ARGS__)
+  #define sl_timer_hist_dump()                 sli_timer_hist_dump()
+  #define sl_timer_hist_process_action()       sli_timer_hist_process_action()
 #else
   #define SL_TIMER_RUNTIME_STRUCT_DEFINE(name)
   #define sl_timer_runtime_meas_start(...)
   #define sl_timer_runtime_meas_stop(...)
   #define sl_timer_runtime_meas_reset(...)
+  #define SL_TIMER_HIST_STRUCT_DEFINE(name)
+  #define sl_timer_hist_register(...)
+  #define sl_timer_hist_start(...)
+  #define sl_timer_hist_stop(...)
+  #define sl_timer_hist_add(...)
+  #define sl_timer_hist_reset(...)
+  #define sl_timer_hist_get_percentile(...)    (0UL)
+  #define sl_timer_hist_dump()
+  #define sl_timer_hist_process_action()
 #endif
 
 //type definitions -------------------------------------------------------------
@@ -54,6 +80,18 @@ typedef struct {
   float avg_us; ///< Average runtime in us
 } sl_timer_runtime_t;
 
+///Runtime histogram, the buckets are log2 ranges split into linear sub-buckets.
+typedef struct sl_timer_hist_s {
+  const char *name; ///< Name in the dump, set by the registration
+  struct sl_timer_hist_s *next; ///< Next registered histogram
+  uint32_t start; ///< Start time of the running measurement in ticks
+  uint32_t count; ///< Number of measurements
+  uint32_t min; ///< Minimum runtime in ticks
+  uint32_t max; ///< Maximum runtime in ticks
+  uint64_t sum; ///< Sum of the runtimes in ticks, for the mean
+  uint32_t buckets[SL_TIMER_HIST_BUCKET_COUNT]; ///< Number of measurements in each bucket
+} sl_timer_hist_t;
+
 //global variables -------------------------------------------------------------
 //function prototypes ----------------------------------------------------------
 
@@ -124,6 +162,109 @@ static inline void sli_timer_runtime_meas_reset(sl_timer_runtime_t *meas)
   memset(meas, 0, sizeof(*meas));
 }
 
+/***************************************************************************//**
+ * Gets the histogram bucket of a runtime.
+ * @param ticks: Runtime in ticks.
+ *
+ * @warning Internal function DO NOT use directly!
+ ******************************************************************************/
+static inline uint32_t sli_timer_hist_bucket(uint32_t ticks)
+{
+  if (ticks < SL_TIMER_HIST_SUB_BUCKET_COUNT) {
+    return ticks;
+  }
+  uint32_t msb = 31 - (uint32_t)__builtin_clz(ticks);
+  uint32_t sub = (ticks >> (msb - SL_TIMER_HIST_SUB_BUCKET_BITS)) & (SL_TIMER_HIST_SUB_BUCKET_COUNT - 1);
+  return ((msb - SL_TIMER_HIST_SUB_BUCKET_BITS + 1) * SL_TIMER_HIST_SUB_BUCKET_COUNT) + sub;
+}
+
+/***************************************************************************//**
+ * Starts a histogram measurement.
+ * @param hist: Histogram of the measured code.
+ *
+ * @warning Internal function DO NOT use directly, use the macro with the "sl" prefix!
+ ******************************************************************************/
+static inline void sli_timer_hist_start(sl_timer_hist_t *hist)
+{
+  hist->start = sl_timer_get();
+}
+
+/***************************************************************************//**
+ * Records a runtime measured elsewhere, integer only.
+ * @param hist: Histogram of the measured code.
+ * @param ticks: Runtime in ticks.
+ *
+ * @warning Internal function DO NOT use directly, use the macro with the "sl" prefix!
+ ******************************************************************************/
+static inline void sli_timer_hist_add(sl_timer_hist_t *hist, uint32_t ticks)
+{
+  if ((0 == hist->count) || (ticks < hist->min)) {
+    hist->min = ticks;
+  }
+  if (ticks > hist->max) {
+    hist->max = ticks;
+  }
+  hist->sum += ticks;
+  hist->count++;
+  hist->buckets[sli_timer_hist_bucket(ticks)]++;
+}
+
+/***************************************************************************//**
+ * Stops a histogram measurement and records the runtime, integer only.
+ * @param hist: Histogram of the measured code.
+ *
+ * @warning Internal function DO NOT use directly, use the macro with the "sl" prefix!
+ ******************************************************************************/
+static inline void sli_timer_hist_stop(sl_timer_hist_t *hist)
+{
+  sli_timer_hist_add(hist, sl_timer_get() - hist->start);
+}
+
+/***************************************************************************//**
+ * Registers a histogram for the dump. Registering it again does nothing.
+ * @param hist: Histogram to register.
+ * @param name: Name in the dump, the string shall be static.
+ *
+ * @warning Internal function DO NOT use directly, use the macro with the "sl" prefix!
+ ******************************************************************************/
+void sli_timer_hist_register(sl_timer_hist_t *hist, const char *name);
+
+/***************************************************************************//**
+ * Clears the measurements of a histogram, the registration is kept.
+ * @param hist: Histogram to clear.
+ *
+ * @warning Internal function DO NOT use directly, use the macro with the "sl" prefix!
+ ******************************************************************************/
+void sli_timer_hist_reset(sl_timer_hist_t *hist);
+
+/***************************************************************************//**
+ * Gets a percentile of the recorded runtimes.
+ * @param hist: Histogram to query.
+ * @param per_mille: Percentile in 0.1% units, e.g. 999 for p99.9.
+ *
+ * @return Upper bound of the bucket holding the percentile in ticks, clamped
+ *         to the measured min and max. 0 if nothing was measured.
+ *
+ * @warning Internal function DO NOT use directly, use the macro with the "sl" prefix!
+ ******************************************************************************/
+uint32_t sli_timer_hist_get_percentile(const sl_timer_hist_t *hist, uint32_t per_mille);
+
+/***************************************************************************//**
+ * Logs count, min, mean, p50, p90, p99, p99.9 and max of every registered
+ * histogram.
+ *
+ * @warning Internal function DO NOT use directly, use the macro with the "sl" prefix!
+ ******************************************************************************/
+void sli_timer_hist_dump(void);
+
+/***************************************************************************//**
+ * Dumps the histograms in every SL_TIMER_HIST_DUMP_PERIOD_MS.
+ * Shall be called from the main loop.
+ *
+ * @warning Internal function DO NOT use directly, use the macro with the "sl" prefix!
+ ******************************************************************************/
+void sli_timer_hist_process_action(void);
+
 #ifdef __cplusplus
 }
 #endif
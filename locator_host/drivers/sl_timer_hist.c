@@ -0,0 +1,144 @@
+/***************************************************************************//**
+ * @file
+ * @brief Runtime histograms of the timer driver
+ * @version 1.0.0
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2024 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * The licensor of this software is Silicon Laboratories Inc. Your use of this
+ * software is governed by the terms of Silicon Labs Master Software License
+ * Agreement (MSLA) available at
+ * www.silabs.com/about-us/legal/master-software-license-agreement. This
+ * software is distributed to you in Source Code format and is governed by the
+ * sections of the MSLA applicable to Source Code.
+ *
+ ******************************************************************************/
+#include "sl_timer.h"
+#include "sl_sleeptimer.h"
+#include "app_log.h"
+
+#if SL_TIMER_RUNTIME_MEASUREMENT_API_EN
+//macros -----------------------------------------------------------------------
+//private type definitions -----------------------------------------------------
+//private function prototypes --------------------------------------------------
+static uint32_t sli_timer_hist_bucket_upper(uint32_t bucket);
+static uint32_t sli_timer_hist_ticks_to_ns(uint32_t ticks);
+
+//private variables ------------------------------------------------------------
+///Registered histograms in the order of registration.
+static sl_timer_hist_t *sli_timer_hist_head;
+static sl_timer_hist_t *sli_timer_hist_tail;
+static uint32_t sli_timer_hist_last_dump;
+
+//function definitions----------------------------------------------------------
+void sli_timer_hist_register(sl_timer_hist_t *hist, const char *name)
+{
+  for (sl_timer_hist_t *it = sli_timer_hist_head; it != NULL; it = it->next) {
+    if (it == hist) {
+      return;
+    }
+  }
+  hist->name = name;
+  hist->next = NULL;
+  if (NULL == sli_timer_hist_tail) {
+    sli_timer_hist_head = hist;
+  } else {
+    sli_timer_hist_tail->next = hist;
+  }
+  sli_timer_hist_tail = hist;
+}
+
+void sli_timer_hist_reset(sl_timer_hist_t *hist)
+{
+  hist->count = 0;
+  hist->min = 0;
+  hist->max = 0;
+  hist->sum = 0;
+  memset(hist->buckets, 0, sizeof(hist->buckets));
+}
+
+uint32_t sli_timer_hist_get_percentile(const sl_timer_hist_t *hist, uint32_t per_mille)
+{
+  if (0 == hist->count) {
+    return 0;
+  }
+  //rank of the percentile, rounded up
+  uint64_t rank = (((uint64_t)hist->count * per_mille) + 999) / 1000;
+  if (0 == rank) {
+    rank = 1;
+  }
+
+  uint64_t seen = 0;
+  uint32_t bucket;
+  for (bucket = 0; bucket < SL_TIMER_HIST_BUCKET_COUNT - 1; bucket++) {
+    seen += hist->buckets[bucket];
+    if (seen >= rank) {
+      break;
+    }
+  }
+
+  uint32_t ticks = sli_timer_hist_bucket_upper(bucket);
+  if (ticks > hist->max) {
+    ticks = hist->max;
+  }
+  if (ticks < hist->min) {
+    ticks = hist->min;
+  }
+  return ticks;
+}
+
+void sli_timer_hist_dump(void)
+{
+  for (sl_timer_hist_t *it = sli_timer_hist_head; it != NULL; it = it->next) {
+    uint32_t mean = (0 == it->count) ? 0 : (uint32_t)(it->sum / it->count);
+
+    app_log_info("%-24s n: %lu min: %lu mean: %lu p50: %lu p90: %lu p99: %lu p99.9: %lu max: %lu ns" APP_LOG_NL,
+                 it->name,
+                 (unsigned long)it->count,
+                 (unsigned long)sli_timer_hist_ticks_to_ns(it->min),
+                 (unsigned long)sli_timer_hist_ticks_to_ns(mean),
+                 (unsigned long)sli_timer_hist_ticks_to_ns(sli_timer_hist_get_percentile(it, 500)),
+                 (unsigned long)sli_timer_hist_ticks_to_ns(sli_timer_hist_get_percentile(it, 900)),
+                 (unsigned long)sli_timer_hist_ticks_to_ns(sli_timer_hist_get_percentile(it, 990)),
+                 (unsigned long)sli_timer_hist_ticks_to_ns(sli_timer_hist_get_percentile(it, 999)),
+                 (unsigned long)sli_timer_hist_ticks_to_ns(it->max));
+  }
+}
+
+void sli_timer_hist_process_action(void)
+{
+#if SL_TIMER_HIST_DUMP_PERIOD_MS
+  static uint32_t period = 0;
+  uint32_t now = sl_sleeptimer_get_tick_count();
+
+  if (0 == period) {
+    (void)sl_sleeptimer_ms32_to_tick(SL_TIMER_HIST_DUMP_PERIOD_MS, &period);
+    sli_timer_hist_last_dump = now;
+  }
+  if ((now - sli_timer_hist_last_dump) >= period) {
+    sli_timer_hist_last_dump = now;
+    sli_timer_hist_dump();
+  }
+#endif
+}
+
+static uint32_t sli_timer_hist_bucket_upper(uint32_t bucket)
+{
+  if (bucket < SL_TIMER_HIST_SUB_BUCKET_COUNT) {
+    return bucket;
+  }
+  uint32_t msb = (bucket / SL_TIMER_HIST_SUB_BUCKET_COUNT) + SL_TIMER_HIST_SUB_BUCKET_BITS - 1;
+  uint32_t sub = bucket % SL_TIMER_HIST_SUB_BUCKET_COUNT;
+  uint32_t shift = msb - SL_TIMER_HIST_SUB_BUCKET_BITS;
+  uint64_t lower = (uint64_t)(SL_TIMER_HIST_SUB_BUCKET_COUNT + sub) << shift;
+  return (uint32_t)(lower + (1ULL << shift) - 1);
+}
+
+static uint32_t sli_timer_hist_ticks_to_ns(uint32_t ticks)
+{
+  uint64_t ns = ((uint64_t)ticks * 1000000000ULL) / sl_timer_get_frequency();
+  return (ns > UINT32_MAX) ? UINT32_MAX : (uint32_t)ns;
+}
+#endif
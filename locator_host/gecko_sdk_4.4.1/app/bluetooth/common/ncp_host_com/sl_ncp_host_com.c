@@ -29,6 +29,7 @@
  ******************************************************************************/
 #include <stdbool.h>
 #include "em_core.h"
+#include "sl_common.h"
 #include "sl_bt_ncp_host.h"
 #include "sl_simple_com.h"
 #include "sl_ncp_host_com.h"
@@ -38,22 +39,32 @@
 #include "sl_wake_lock.h"
 #endif // SL_CATALOG_WAKE_LOCK_PRESENT
 
-// Uart reception buffer
+// Uart reception ring buffer.
+// Single producer (receive callback) and single consumer (BGAPI reader): the
+// producer only moves the head, the consumer only moves the tail, so no data is
+// ever shifted and no critical section is needed. Indices run over twice the
+// buffer size so that a full buffer can be told apart from an empty one.
 typedef struct {
-  uint16_t len;
+  volatile uint32_t head;
+  volatile uint32_t tail;
   uint8_t buf[SL_NCP_HOST_COM_BUF_SIZE];
-  bool available;
 } buf_t;
 
+#define RING_INDEX_LIMIT    (2 * SL_NCP_HOST_COM_BUF_SIZE)
+
 static volatile bool write_completed = false;
 static buf_t buf = { 0 };
 
+static uint32_t ring_used(uint32_t head, uint32_t tail);
+static uint32_t ring_advance(uint32_t index, uint32_t len);
+
 /**************************************************************************//**
  * NCP host communication initialization.
  *****************************************************************************/
 void sl_ncp_host_com_init(void)
 {
-  buf.len = 0;
+  buf.head = 0;
+  buf.tail = 0;
   // Register communication interface functions in adaptation layer
   sl_status_t sc = sl_bt_api_initialize_nonblock(sl_ncp_host_com_write,
                                                  sl_ncp_host_com_read,
@@ -100,19 +111,26 @@ void sl_ncp_host_com_write(uint32_t len, uint8_t *data)
  *****************************************************************************/
 int32_t sl_ncp_host_com_read(uint32_t len, uint8_t *data)
 {
-  (void)data;
-  CORE_DECLARE_IRQ_STATE;
-  CORE_ENTER_ATOMIC();
+  uint32_t tail = buf.tail;
   // Check if there is data in the buffer from Uart
-  if (len <= buf.len) {
-    // Copy data to adaptation layer
-    memcpy((void *)data, (void *)buf.buf, (size_t)len);
-    buf.len -= len;
-    memmove((void *)buf.buf, (void *)&buf.buf[len], buf.len);
-  } else {
-    len = -1;
+  if (len > ring_used(buf.head, tail)) {
+    return -1;
   }
-  CORE_EXIT_ATOMIC();
+  // Head was sampled before the data it covers is read
+  __DMB();
+
+  // Copy data to adaptation layer, in two chunks if it wraps around
+  uint32_t offset = tail % SL_NCP_HOST_COM_BUF_SIZE;
+  uint32_t chunk = SL_NCP_HOST_COM_BUF_SIZE - offset;
+  if (chunk > len) {
+    chunk = len;
+  }
+  memcpy((void *)data, (void *)&buf.buf[offset], (size_t)chunk);
+  memcpy((void *)&data[chunk], (void *)buf.buf, (size_t)(len - chunk));
+
+  // Release the space only after the data has been copied out
+  __DMB();
+  buf.tail = ring_advance(tail, len);
   return len;
 }
 
@@ -129,7 +147,7 @@ int32_t sl_ncp_host_com_read(uint32_t len, uint8_t *data)
  *****************************************************************************/
 int32_t sl_ncp_host_com_peek(void)
 {
-  return buf.len;
+  return ring_used(buf.head, buf.tail);
 }
 
 /**************************************************************************//**
@@ -166,21 +184,56 @@ void sl_simple_com_receive_cb(sl_status_t status,
                               uint8_t *data)
 {
   (void)status;
-  CORE_DECLARE_IRQ_STATE;
-  CORE_ENTER_ATOMIC();
+  uint32_t head = buf.head;
   // command fits into command buffer; otherwise discard it
-  if (len <= (sizeof(buf.buf) - buf.len)) {
-    memcpy((void *)&buf.buf[buf.len], (void *)data, (size_t)len);
-    buf.len += len;
+  if (len > (SL_NCP_HOST_COM_BUF_SIZE - ring_used(head, buf.tail))) {
+    return;
   }
-  CORE_EXIT_ATOMIC();
+  // Tail was sampled before the space it frees is overwritten
+  __DMB();
+
+  // Append data, in two chunks if it wraps around
+  uint32_t offset = head % SL_NCP_HOST_COM_BUF_SIZE;
+  uint32_t chunk = SL_NCP_HOST_COM_BUF_SIZE - offset;
+  if (chunk > len) {
+    chunk = len;
+  }
+  memcpy((void *)&buf.buf[offset], (void *)data, (size_t)chunk);
+  memcpy((void *)buf.buf, (void *)&data[chunk], (size_t)(len - chunk));
+
+  // Publish the data only after it has been written
+  __DMB();
+  buf.head = ring_advance(head, len);
+  sl_ncp_host_com_on_receive(len);
+}
+
+SL_WEAK void sl_ncp_host_com_on_receive(uint32_t len)
+{
+  (void)len;
 }
 
 bool sl_ncp_host_is_ok_to_sleep(void)
 {
-  if (buf.len != 0) {
+  if (ring_used(buf.head, buf.tail) != 0) {
     return false;
   } else {
     return true;
   }
 }
+
+/**************************************************************************//**
+ * Number of bytes stored between the tail and the head of the ring buffer.
+ *****************************************************************************/
+static uint32_t ring_used(uint32_t head, uint32_t tail)
+{
+  return (head >= tail) ? (head - tail) : (head + RING_INDEX_LIMIT - tail);
+}
+
+/**************************************************************************//**
+ * Moves a ring buffer index forward by len bytes.
+ *****************************************************************************/
+static uint32_t ring_advance(uint32_t index, uint32_t len)
+{
+  index += len;
+  return (index >= RING_INDEX_LIMIT) ? (index - RING_INDEX_LIMIT) : index;
+}
@@ -58,5 +58,13 @@ int32_t sl_ncp_host_com_read(uint32_t len, uint8_t *data);
 int32_t sl_ncp_host_com_peek(void);
 
 bool sl_ncp_host_is_ok_to_sleep(void);
+
+/**************************************************************************//**
+ * Called from the receive callback after the data was put to the buffer.
+ * Weak, does nothing by default.
+ *
+ * @param[in] len Received message length
+ *****************************************************************************/
+void sl_ncp_host_com_on_receive(uint32_t len);
 /** @} (end addtogroup ncp_host_com) */
 #endif // SL_NCP_HOST_COM_H
@@ -160,6 +160,34 @@ void sl_bt_host_handle_command();
 void sl_bt_host_handle_command_noresponse();
 sl_status_t sl_bt_wait_event(sl_bt_msg_t *p);
 
+/**
+ * Non-blocking zero-copy variant of sl_bt_pop_event.
+ *
+ * Points event to the oldest event in the queue without copying it. The slot
+ * stays reserved until sl_bt_release_event is called, commands may be issued
+ * in the meantime. Only one event may be borrowed at a time.
+ *
+ * @param[out] event Set to the borrowed event
+ * @return SL_STATUS_OK if an event was borrowed, SL_STATUS_WOULD_BLOCK if there
+ *         is no event, SL_STATUS_BUSY if another device type has pending events
+ */
+sl_status_t sl_bt_borrow_event(sl_bt_msg_t **event);
+
+/**
+ * Frees the queue slot of the event obtained with sl_bt_borrow_event.
+ * The event must not be accessed after this call.
+ *
+ * @return SL_STATUS_OK, or SL_STATUS_INVALID_STATE if no event is borrowed
+ */
+sl_status_t sl_bt_release_event(void);
+
 sl_bt_msg_t* sli_wait_for_bgapi_message(sl_bt_msg_t *response_buf);
 
+/**
+ * Get the number of events discarded because the event queue was full.
+ *
+ * @return Number of discarded events since startup
+ */
+uint32_t sl_bt_get_discarded_event_count(void);
+
 #endif
@@ -31,6 +31,8 @@ void (*sl_bt_api_output)(uint32_t len1, uint8_t* data1);
 int32_t (*sl_bt_api_input)(uint32_t len1, uint8_t* data1);
 int32_t (*sl_bt_api_peek)(void);
 uint8_t _sl_bt_queue_buffer[SL_BT_API_QUEUE_LEN * (SL_BGAPI_MSG_HEADER_LEN + SL_BGAPI_MAX_PAYLOAD_SIZE)];
+static volatile uint32_t sli_bgapi_discarded_event_count = 0;
+static bool sli_bgapi_event_borrowed = false;
 
 bgapi_device_type_queue_t sl_bt_api_queue = {
   sl_bgapi_dev_type_bt,
@@ -155,6 +157,7 @@ sl_bt_msg_t* sli_wait_for_bgapi_message(sl_bt_msg_t *response_buffer)
     //received event
     if (((queue->write_offset + 1) % queue->len == queue->read_offset)) {
       // Would write over the next item we'd due to read - queue full!
+      sli_bgapi_discarded_event_count++;
       if (msg_length) {
         // Discard payload if it exists
         uint8_t discard_buf[SL_BGAPI_MAX_PAYLOAD_SIZE];
@@ -192,6 +195,11 @@ sl_bt_msg_t* sli_wait_for_bgapi_message(sl_bt_msg_t *response_buffer)
   return retVal;
 }
 
+uint32_t sl_bt_get_discarded_event_count(void)
+{
+  return sli_bgapi_discarded_event_count;
+}
+
 bool sl_bt_event_pending(void)
 {
   if (sli_bgapi_device_queue_has_events(&sl_bt_api_queue)) {//event is waiting in queue
@@ -249,6 +257,41 @@ sl_status_t sli_bgapi_get_event(int block, sl_bt_msg_t *event, bgapi_device_type
   }
 }
 
+sl_status_t sl_bt_borrow_event(sl_bt_msg_t **event)
+{
+  while (1) {
+    if (sli_bgapi_device_queue_has_events(&sl_bt_api_queue)) {
+      // Hand out the slot in place, the read offset is moved by sl_bt_release_event().
+      // The writer keeps treating the slot as occupied until then.
+      *event = &sl_bt_api_queue.buffer[sl_bt_api_queue.read_offset];
+      sli_bgapi_event_borrowed = true;
+      return SL_STATUS_OK;
+    } else if (sli_bgapi_other_events_in_queue(sl_bt_api_queue.device_type)) {
+      return SL_STATUS_BUSY;
+    }
+
+    //if nothing in uart -> out
+    if (sl_bt_api_peek && sl_bt_api_peek() == 0) {
+      return SL_STATUS_WOULD_BLOCK;
+    }
+
+    // Responses are consumed by the command that is waiting for them, a stray one
+    // would be overwritten by the next command so it is not handed out.
+    (void)sli_wait_for_bgapi_message(sl_bt_rsp_msg);
+  }
+}
+
+sl_status_t sl_bt_release_event(void)
+{
+  // A second release would silently drop the next event.
+  if (!sli_bgapi_event_borrowed) {
+    return SL_STATUS_INVALID_STATE;
+  }
+  sli_bgapi_event_borrowed = false;
+  sl_bt_api_queue.read_offset = (sl_bt_api_queue.read_offset + 1) % sl_bt_api_queue.len;
+  return SL_STATUS_OK;
+}
+
 sl_status_t sl_bt_wait_event(sl_bt_msg_t* event)
 {
   return sli_bgapi_get_event(1, event, &sl_bt_api_queue);
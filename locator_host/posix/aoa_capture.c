@@ -0,0 +1,371 @@
+/***************************************************************************//**
+ * @file
+ * @brief Binary capture file of the BGAPI events consumed by the AoA pipeline.
+ * @version 1.0.0
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2024 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * The licensor of this software is Silicon Laboratories Inc. Your use of this
+ * software is governed by the terms of Silicon Labs Master Software License
+ * Agreement (MSLA) available at
+ * www.silabs.com/about-us/legal/master-software-license-agreement. This
+ * software is distributed to you in Source Code format and is governed by the
+ * sections of the MSLA applicable to Source Code.
+ *
+ ******************************************************************************/
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+#include "aoa_capture.h"
+
+//macros -----------------------------------------------------------------------
+#define SLI_AOA_CAPTURE_MAGIC         "AOAC"
+#define SLI_AOA_CAPTURE_TRAILER_MAGIC "AOAX"
+#define SLI_AOA_CAPTURE_MAGIC_SIZE    4
+
+//private type definitions -----------------------------------------------------
+//private function prototypes --------------------------------------------------
+static void sli_aoa_capture_put_u16(uint8_t *buffer, uint16_t value);
+static void sli_aoa_capture_put_u32(uint8_t *buffer, uint32_t value);
+static void sli_aoa_capture_put_u64(uint8_t *buffer, uint64_t value);
+static uint16_t sli_aoa_capture_get_u16(const uint8_t *buffer);
+static uint32_t sli_aoa_capture_get_u32(const uint8_t *buffer);
+static uint64_t sli_aoa_capture_get_u64(const uint8_t *buffer);
+static sl_status_t sli_aoa_capture_read_trailer(aoa_capture_reader_t *reader, uint64_t file_size);
+
+//private variables ------------------------------------------------------------
+//function definitions----------------------------------------------------------
+bool aoa_capture_is_recorded(const sl_bt_msg_t *evt)
+{
+  switch (SL_BT_MSG_ID(evt->header)) {
+    case sl_bt_evt_system_boot_id:
+    case sl_bt_evt_scanner_legacy_advertisement_report_id:
+    case sl_bt_evt_scanner_extended_advertisement_report_id:
+    case sl_bt_evt_periodic_sync_opened_id:
+    case sl_bt_evt_sync_closed_id:
+    case sl_bt_evt_connection_opened_id:
+    case sl_bt_evt_connection_closed_id:
+    case sl_bt_evt_gatt_service_id:
+    case sl_bt_evt_gatt_characteristic_id:
+    case sl_bt_evt_gatt_procedure_completed_id:
+    case sl_bt_evt_cte_receiver_silabs_iq_report_id:
+    case sl_bt_evt_cte_receiver_connectionless_iq_report_id:
+    case sl_bt_evt_cte_receiver_connection_iq_report_id:
+      return true;
+    default:
+      return false;
+  }
+}
+
+sl_status_t aoa_capture_writer_open(aoa_capture_writer_t *writer, const char *path)
+{
+  uint8_t header[AOA_CAPTURE_FILE_HEADER_SIZE];
+  struct timeval now;
+
+  if (writer == NULL || path == NULL) {
+    return SL_STATUS_NULL_POINTER;
+  }
+  memset(writer, 0, sizeof(*writer));
+
+  writer->file = fopen(path, "wb");
+  if (writer->file == NULL) {
+    return SL_STATUS_FAIL;
+  }
+
+  gettimeofday(&now, NULL);
+  memcpy(header, SLI_AOA_CAPTURE_MAGIC, SLI_AOA_CAPTURE_MAGIC_SIZE);
+  sli_aoa_capture_put_u16(&header[4], AOA_CAPTURE_VERSION);
+  sli_aoa_capture_put_u16(&header[6], AOA_CAPTURE_FILE_HEADER_SIZE);
+  sli_aoa_capture_put_u64(&header[8], ((uint64_t)now.tv_sec * 1000000) + (uint64_t)now.tv_usec);
+  if (fwrite(header, sizeof(header), 1, writer->file) != 1) {
+    fclose(writer->file);
+    writer->file = NULL;
+    return SL_STATUS_FAIL;
+  }
+  writer->offset = AOA_CAPTURE_FILE_HEADER_SIZE;
+  return SL_STATUS_OK;
+}
+
+sl_status_t aoa_capture_writer_write(aoa_capture_writer_t *writer,
+                                     uint64_t time_us,
+                                     const sl_bt_msg_t *evt)
+{
+  uint8_t header[AOA_CAPTURE_RECORD_HEADER_SIZE];
+  uint32_t length = SL_BT_MSG_LEN(evt->header);
+  uint64_t delta;
+
+  if (writer->file == NULL) {
+    return SL_STATUS_INVALID_STATE;
+  }
+
+  if (writer->record_count == 0) {
+    writer->start_us = time_us;
+  }
+  time_us -= writer->start_us;
+  delta = time_us - writer->last_us;
+
+  if ((writer->record_count % AOA_CAPTURE_INDEX_INTERVAL) == 0) {
+    if (writer->index_count == writer->index_capacity) {
+      uint32_t capacity = (writer->index_capacity == 0) ? 64 : (writer->index_capacity * 2);
+      aoa_capture_index_entry_t *index = realloc(writer->index, capacity * sizeof(*index));
+      if (index == NULL) {
+        return SL_STATUS_ALLOCATION_FAILED;
+      }
+      writer->index = index;
+      writer->index_capacity = capacity;
+    }
+    writer->index[writer->index_count].offset = writer->offset;
+    writer->index[writer->index_count].time_us = writer->last_us;
+    writer->index_count++;
+    //a crash loses at most one index interval
+    fflush(writer->file);
+  }
+
+  sli_aoa_capture_put_u32(&header[0], (delta > UINT32_MAX) ? UINT32_MAX : (uint32_t)delta);
+  sli_aoa_capture_put_u32(&header[4], evt->header);
+  if ((fwrite(header, sizeof(header), 1, writer->file) != 1)
+      || ((length > 0) && (fwrite(evt->data.payload, length, 1, writer->file) != 1))) {
+    return SL_STATUS_FAIL;
+  }
+
+  writer->last_us += (delta > UINT32_MAX) ? UINT32_MAX : delta;
+  writer->offset += sizeof(header) + length;
+  writer->record_count++;
+  return SL_STATUS_OK;
+}
+
+sl_status_t aoa_capture_writer_close(aoa_capture_writer_t *writer)
+{
+  uint8_t buffer[AOA_CAPTURE_TRAILER_SIZE];
+  sl_status_t sc = SL_STATUS_OK;
+
+  if (writer->file == NULL) {
+    return SL_STATUS_INVALID_STATE;
+  }
+
+  for (uint32_t i = 0; i < writer->index_count; i++) {
+    sli_aoa_capture_put_u64(&buffer[0], writer->index[i].offset);
+    sli_aoa_capture_put_u64(&buffer[8], writer->index[i].time_us);
+    if (fwrite(buffer, AOA_CAPTURE_INDEX_ENTRY_SIZE, 1, writer->file) != 1) {
+      sc = SL_STATUS_FAIL;
+    }
+  }
+
+  sli_aoa_capture_put_u64(&buffer[0], writer->offset);
+  sli_aoa_capture_put_u32(&buffer[8], writer->index_count);
+  sli_aoa_capture_put_u32(&buffer[12], writer->record_count);
+  sli_aoa_capture_put_u64(&buffer[16], writer->last_us);
+  memcpy(&buffer[24], SLI_AOA_CAPTURE_TRAILER_MAGIC, SLI_AOA_CAPTURE_MAGIC_SIZE);
+  if (fwrite(buffer, AOA_CAPTURE_TRAILER_SIZE, 1, writer->file) != 1) {
+    sc = SL_STATUS_FAIL;
+  }
+
+  if (fclose(writer->file) != 0) {
+    sc = SL_STATUS_FAIL;
+  }
+  writer->file = NULL;
+  free(writer->index);
+  writer->index = NULL;
+  return sc;
+}
+
+sl_status_t aoa_capture_reader_open(aoa_capture_reader_t *reader, const char *path)
+{
+  uint8_t header[AOA_CAPTURE_FILE_HEADER_SIZE];
+
+  if (reader == NULL || path == NULL) {
+    return SL_STATUS_NULL_POINTER;
+  }
+  memset(reader, 0, sizeof(*reader));
+
+  reader->file = fopen(path, "rb");
+  if (reader->file == NULL) {
+    return SL_STATUS_FAIL;
+  }
+
+  if ((fread(header, sizeof(header), 1, reader->file) != 1)
+      || (memcmp(header, SLI_AOA_CAPTURE_MAGIC, SLI_AOA_CAPTURE_MAGIC_SIZE) != 0)
+      || (sli_aoa_capture_get_u16(&header[4]) != AOA_CAPTURE_VERSION)
+      || (sli_aoa_capture_get_u16(&header[6]) < AOA_CAPTURE_FILE_HEADER_SIZE)) {
+    aoa_capture_reader_close(reader);
+    return SL_STATUS_INVALID_SIGNATURE;
+  }
+  reader->start_unix_us = sli_aoa_capture_get_u64(&header[8]);
+
+  if (fseek(reader->file, 0, SEEK_END) != 0) {
+    aoa_capture_reader_close(reader);
+    return SL_STATUS_FAIL;
+  }
+  uint64_t file_size = (uint64_t)ftell(reader->file);
+  if (sli_aoa_capture_read_trailer(reader, file_size) != SL_STATUS_OK) {
+    //no index, the records last until the end of the file
+    reader->end_offset = file_size;
+  }
+
+  //the header can be extended by later versions
+  if (fseek(reader->file, sli_aoa_capture_get_u16(&header[6]), SEEK_SET) != 0) {
+    aoa_capture_reader_close(reader);
+    return SL_STATUS_FAIL;
+  }
+  return SL_STATUS_OK;
+}
+
+sl_status_t aoa_capture_reader_read(aoa_capture_reader_t *reader,
+                                    uint64_t *time_us,
+                                    sl_bt_msg_t *evt)
+{
+  uint8_t header[AOA_CAPTURE_RECORD_HEADER_SIZE];
+
+  long offset = ftell(reader->file);
+  if ((offset < 0) || ((uint64_t)offset + sizeof(header) > reader->end_offset)) {
+    return SL_STATUS_EMPTY;
+  }
+  if (fread(header, sizeof(header), 1, reader->file) != 1) {
+    return SL_STATUS_EMPTY;
+  }
+
+  evt->header = sli_aoa_capture_get_u32(&header[4]);
+  uint32_t length = SL_BT_MSG_LEN(evt->header);
+  if (length > SL_BGAPI_MAX_PAYLOAD_SIZE) {
+    return SL_STATUS_INVALID_SIGNATURE;
+  }
+  if ((uint64_t)offset + sizeof(header) + length > reader->end_offset) {
+    return SL_STATUS_EMPTY; //truncated last record
+  }
+  if ((length > 0) && (fread(evt->data.payload, length, 1, reader->file) != 1)) {
+    return SL_STATUS_EMPTY;
+  }
+
+  reader->time_us += sli_aoa_capture_get_u32(&header[0]);
+  *time_us = reader->time_us;
+  return SL_STATUS_OK;
+}
+
+sl_status_t aoa_capture_reader_seek(aoa_capture_reader_t *reader, uint64_t time_us)
+{
+  sl_bt_msg_t evt;
+  uint64_t record_time_us;
+  uint64_t offset = AOA_CAPTURE_FILE_HEADER_SIZE;
+
+  reader->time_us = 0;
+  for (uint32_t i = 0; i < reader->index_count; i++) {
+    if (reader->index[i].time_us >= time_us) {
+      break;
+    }
+    offset = reader->index[i].offset;
+    reader->time_us = reader->index[i].time_us;
+  }
+  if (reader->index_count == 0) {
+    rewind(reader->file);
+    uint8_t header[AOA_CAPTURE_FILE_HEADER_SIZE];
+    if (fread(header, sizeof(header), 1, reader->file) != 1) {
+      return SL_STATUS_FAIL;
+    }
+    offset = sli_aoa_capture_get_u16(&header[6]);
+  }
+  if (fseek(reader->file, (long)offset, SEEK_SET) != 0) {
+    return SL_STATUS_FAIL;
+  }
+
+  while (1) {
+    long position = ftell(reader->file);
+    uint64_t previous_time_us = reader->time_us;
+    sl_status_t sc = aoa_capture_reader_read(reader, &record_time_us, &evt);
+    if (sc != SL_STATUS_OK) {
+      return sc;
+    }
+    if (record_time_us >= time_us) {
+      reader->time_us = previous_time_us;
+      return (fseek(reader->file, position, SEEK_SET) == 0) ? SL_STATUS_OK : SL_STATUS_FAIL;
+    }
+  }
+}
+
+void aoa_capture_reader_close(aoa_capture_reader_t *reader)
+{
+  if (reader->file != NULL) {
+    fclose(reader->file);
+    reader->file = NULL;
+  }
+  free(reader->index);
+  reader->index = NULL;
+  reader->index_count = 0;
+}
+
+static sl_status_t sli_aoa_capture_read_trailer(aoa_capture_reader_t *reader, uint64_t file_size)
+{
+  uint8_t buffer[AOA_CAPTURE_TRAILER_SIZE];
+
+  if (file_size < AOA_CAPTURE_FILE_HEADER_SIZE + AOA_CAPTURE_TRAILER_SIZE) {
+    return SL_STATUS_NOT_FOUND;
+  }
+  if ((fseek(reader->file, (long)(file_size - AOA_CAPTURE_TRAILER_SIZE), SEEK_SET) != 0)
+      || (fread(buffer, sizeof(buffer), 1, reader->file) != 1)
+      || (memcmp(&buffer[24], SLI_AOA_CAPTURE_TRAILER_MAGIC, SLI_AOA_CAPTURE_MAGIC_SIZE) != 0)) {
+    return SL_STATUS_NOT_FOUND;
+  }
+
+  uint64_t index_offset = sli_aoa_capture_get_u64(&buffer[0]);
+  uint32_t index_count = sli_aoa_capture_get_u32(&buffer[8]);
+  if (index_offset + ((uint64_t)index_count * AOA_CAPTURE_INDEX_ENTRY_SIZE) + AOA_CAPTURE_TRAILER_SIZE != file_size) {
+    return SL_STATUS_NOT_FOUND;
+  }
+
+  reader->end_offset = index_offset;
+  reader->record_count = sli_aoa_capture_get_u32(&buffer[12]);
+  reader->duration_us = sli_aoa_capture_get_u64(&buffer[16]);
+  if (index_count == 0) {
+    return SL_STATUS_OK;
+  }
+
+  reader->index = malloc(index_count * sizeof(*reader->index));
+  if ((reader->index == NULL) || (fseek(reader->file, (long)index_offset, SEEK_SET) != 0)) {
+    return SL_STATUS_OK; //the records are still usable without the index
+  }
+  for (uint32_t i = 0; i < index_count; i++) {
+    if (fread(buffer, AOA_CAPTURE_INDEX_ENTRY_SIZE, 1, reader->file) != 1) {
+      free(reader->index);
+      reader->index = NULL;
+      return SL_STATUS_OK;
+    }
+    reader->index[i].offset = sli_aoa_capture_get_u64(&buffer[0]);
+    reader->index[i].time_us = sli_aoa_capture_get_u64(&buffer[8]);
+  }
+  reader->index_count = index_count;
+  return SL_STATUS_OK;
+}
+
+static void sli_aoa_capture_put_u16(uint8_t *buffer, uint16_t value)
+{
+  buffer[0] = (uint8_t)value;
+  buffer[1] = (uint8_t)(value >> 8);
+}
+
+static void sli_aoa_capture_put_u32(uint8_t *buffer, uint32_t value)
+{
+  sli_aoa_capture_put_u16(&buffer[0], (uint16_t)value);
+  sli_aoa_capture_put_u16(&buffer[2], (uint16_t)(value >> 16));
+}
+
+static void sli_aoa_capture_put_u64(uint8_t *buffer, uint64_t value)
+{
+  sli_aoa_capture_put_u32(&buffer[0], (uint32_t)value);
+  sli_aoa_capture_put_u32(&buffer[4], (uint32_t)(value >> 32));
+}
+
+static uint16_t sli_aoa_capture_get_u16(const uint8_t *buffer)
+{
+  return (uint16_t)(buffer[0] | (buffer[1] << 8));
+}
+
+static uint32_t sli_aoa_capture_get_u32(const uint8_t *buffer)
+{
+  return sli_aoa_capture_get_u16(&buffer[0]) | ((uint32_t)sli_aoa_capture_get_u16(&buffer[2]) << 16);
+}
+
+static uint64_t sli_aoa_capture_get_u64(const uint8_t *buffer)
+{
+  return sli_aoa_capture_get_u32(&buffer[0]) | ((uint64_t)sli_aoa_capture_get_u32(&buffer[4]) << 32);
+}
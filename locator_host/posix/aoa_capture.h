@@ -0,0 +1,171 @@
+/***************************************************************************//**
+ * @file
+ * @brief Binary capture file of the BGAPI events consumed by the AoA pipeline.
+ * @version 1.0.0
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2024 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * The licensor of this software is Silicon Laboratories Inc. Your use of this
+ * software is governed by the terms of Silicon Labs Master Software License
+ * Agreement (MSLA) available at
+ * www.silabs.com/about-us/legal/master-software-license-agreement. This
+ * software is distributed to you in Source Code format and is governed by the
+ * sections of the MSLA applicable to Source Code.
+ *
+ ******************************************************************************/
+#ifndef AOA_CAPTURE_H
+#define AOA_CAPTURE_H
+#ifdef __cplusplus
+extern "C" {
+#endif
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include "sl_status.h"
+#include "sl_bt_api.h"
+
+//macros -----------------------------------------------------------------------
+/*
+ * File layout, every field is little endian:
+ *  - File header: magic "AOAC", version (u16), header size (u16),
+ *    start time (u64, us since the epoch).
+ *  - Records: time since the previous record (u32, us), BGAPI header (u32),
+ *    BGAPI payload (length from the header).
+ *  - Index, written when the capture is closed: one entry per
+ *    AOA_CAPTURE_INDEX_INTERVAL records, file offset (u64) and time of the
+ *    preceding record (u64, us since the start).
+ *  - Trailer: index offset (u64), index entry count (u32), record count (u32),
+ *    duration (u64, us), magic "AOAX".
+ * A capture without trailer (e.g. the recorder was killed) is still readable
+ * up to its last complete record, only seeking is slower.
+ */
+#define AOA_CAPTURE_VERSION             1
+#define AOA_CAPTURE_FILE_HEADER_SIZE    16
+#define AOA_CAPTURE_RECORD_HEADER_SIZE  8
+#define AOA_CAPTURE_INDEX_ENTRY_SIZE    16
+#define AOA_CAPTURE_TRAILER_SIZE        28
+///Number of records between two index entries
+#define AOA_CAPTURE_INDEX_INTERVAL      1024
+
+//type definitions -------------------------------------------------------------
+///Index entry, the reading can be started at any of them.
+typedef struct {
+  uint64_t offset;  ///< File offset of the record.
+  uint64_t time_us; ///< Time of the preceding record.
+} aoa_capture_index_entry_t;
+
+///Capture writer.
+typedef struct {
+  FILE *file;                        ///< Capture file.
+  uint64_t start_us;                 ///< Time of the first record.
+  uint64_t last_us;                  ///< Time of the last record, relative to start.
+  uint64_t offset;                   ///< End of the written records.
+  uint32_t record_count;             ///< Number of written records.
+  aoa_capture_index_entry_t *index;  ///< Index entries collected until close.
+  uint32_t index_count;              ///< Number of index entries.
+  uint32_t index_capacity;           ///< Allocated index entries.
+} aoa_capture_writer_t;
+
+///Capture reader.
+typedef struct {
+  FILE *file;                        ///< Capture file.
+  uint64_t start_unix_us;            ///< Start of the capture, us since the epoch.
+  uint64_t time_us;                  ///< Time of the last read record, relative to start.
+  uint64_t end_offset;               ///< End of the records.
+  uint32_t record_count;             ///< Number of records, 0 if unknown.
+  uint64_t duration_us;              ///< Duration of the capture, 0 if unknown.
+  aoa_capture_index_entry_t *index;  ///< Index entries, NULL if there is no index.
+  uint32_t index_count;              ///< Number of index entries.
+} aoa_capture_reader_t;
+
+//global variables -------------------------------------------------------------
+//function prototypes ----------------------------------------------------------
+/***************************************************************************//**
+ * Tells whether an event is stored in captures: the IQ reports and every
+ * event the CTE handlers use to track the tags.
+ *
+ * @param[in] evt BGAPI event.
+ *
+ * @return true if the event shall be recorded.
+ ******************************************************************************/
+bool aoa_capture_is_recorded(const sl_bt_msg_t *evt);
+
+/***************************************************************************//**
+ * Creates a capture file, an existing file is overwritten.
+ *
+ * @param[out] writer Writer to initialize.
+ * @param[in] path Path of the capture file.
+ *
+ * @return SL_STATUS_OK if successful. Error code otherwise.
+ ******************************************************************************/
+sl_status_t aoa_capture_writer_open(aoa_capture_writer_t *writer, const char *path);
+
+/***************************************************************************//**
+ * Appends an event to the capture.
+ *
+ * @param[in] writer Capture writer.
+ * @param[in] time_us Receive time of the event, monotonic in us.
+ * @param[in] evt BGAPI event.
+ *
+ * @return SL_STATUS_OK if successful. Error code otherwise.
+ ******************************************************************************/
+sl_status_t aoa_capture_writer_write(aoa_capture_writer_t *writer,
+                                     uint64_t time_us,
+                                     const sl_bt_msg_t *evt);
+
+/***************************************************************************//**
+ * Writes the index and closes the capture file.
+ *
+ * @param[in] writer Capture writer.
+ *
+ * @return SL_STATUS_OK if successful. Error code otherwise.
+ ******************************************************************************/
+sl_status_t aoa_capture_writer_close(aoa_capture_writer_t *writer);
+
+/***************************************************************************//**
+ * Opens a capture file for reading.
+ *
+ * @param[out] reader Reader to initialize.
+ * @param[in] path Path of the capture file.
+ *
+ * @return SL_STATUS_OK if successful. Error code otherwise.
+ ******************************************************************************/
+sl_status_t aoa_capture_reader_open(aoa_capture_reader_t *reader, const char *path);
+
+/***************************************************************************//**
+ * Reads the next event from the capture.
+ *
+ * @param[in] reader Capture reader.
+ * @param[out] time_us Time of the event relative to the start of the capture.
+ * @param[out] evt BGAPI event.
+ *
+ * @return SL_STATUS_OK if successful, SL_STATUS_EMPTY at the end of the
+ *         capture. Error code otherwise.
+ ******************************************************************************/
+sl_status_t aoa_capture_reader_read(aoa_capture_reader_t *reader,
+                                    uint64_t *time_us,
+                                    sl_bt_msg_t *evt);
+
+/***************************************************************************//**
+ * Moves the reader before the first record not earlier than time_us.
+ *
+ * @param[in] reader Capture reader.
+ * @param[in] time_us Time relative to the start of the capture.
+ *
+ * @return SL_STATUS_OK if successful. Error code otherwise.
+ ******************************************************************************/
+sl_status_t aoa_capture_reader_seek(aoa_capture_reader_t *reader, uint64_t time_us);
+
+/***************************************************************************//**
+ * Closes the capture file.
+ *
+ * @param[in] reader Capture reader.
+ ******************************************************************************/
+void aoa_capture_reader_close(aoa_capture_reader_t *reader);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* AOA_CAPTURE_H */
@@ -0,0 +1,211 @@
+/***************************************************************************//**
+ * @file
+ * @brief Lookup time of the tag database against the number of tags.
+ * @version 1.0.0
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2024 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * The licensor of this software is Silicon Laboratories Inc. Your use of this
+ * software is governed by the terms of Silicon Labs Master Software License
+ * Agreement (MSLA) available at
+ * www.silabs.com/about-us/legal/master-software-license-agreement. This
+ * software is distributed to you in Source Code format and is governed by the
+ * sections of the MSLA applicable to Source Code.
+ *
+ ******************************************************************************/
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "aoa_db.h"
+#include "aoa_db_config.h"
+
+//macros -----------------------------------------------------------------------
+#define SLI_AOA_DB_BENCH_DEFAULT_LOOKUPS 1000000
+///tags looked up per round, in random order
+#define SLI_AOA_DB_BENCH_STREAM          1024
+
+//private function prototypes --------------------------------------------------
+static void sli_aoa_db_bench_usage(const char *name);
+static void sli_aoa_db_bench_address(uint32_t n, bd_addr *address);
+static aoa_db_entry_t *sli_aoa_db_bench_linear(const bd_addr *address, uint32_t count);
+static uint32_t sli_aoa_db_bench_random(uint32_t *state);
+static double sli_aoa_db_bench_now(void);
+
+//private variables ------------------------------------------------------------
+static bd_addr sli_addresses[AOA_DB_MAX_TAG_COUNT];
+///the list walk before the indexes, over the same tags
+static aoa_db_entry_t *sli_entries[AOA_DB_MAX_TAG_COUNT];
+static uint32_t sli_stream[SLI_AOA_DB_BENCH_STREAM];
+///keeps the timed loops from being optimized away
+static volatile uintptr_t sli_sink;
+
+//function definitions----------------------------------------------------------
+int main(int argc, char *argv[])
+{
+  uint64_t lookups = SLI_AOA_DB_BENCH_DEFAULT_LOOKUPS;
+  uint64_t rounds;
+  uint32_t random_state = 1;
+  uint32_t next_tag = AOA_DB_MAX_TAG_COUNT;
+  int opt;
+
+  while ((opt = getopt(argc, argv, "n:h")) != -1) {
+    switch (opt) {
+      case 'n':
+        lookups = strtoull(optarg, NULL, 10);
+        break;
+      default:
+        sli_aoa_db_bench_usage(argv[0]);
+        return (opt == 'h') ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+  }
+  rounds = lookups / SLI_AOA_DB_BENCH_STREAM;
+  if (rounds == 0) {
+    sli_aoa_db_bench_usage(argv[0]);
+    return EXIT_FAILURE;
+  }
+
+  printf("Lookups: %llu, ns per operation\n", (unsigned long long)(rounds * SLI_AOA_DB_BENCH_STREAM));
+  printf("   tags      handle     address      linear       churn\n");
+  for (uint32_t count = 1; count <= AOA_DB_MAX_TAG_COUNT; count *= 2) {
+    aoa_db_entry_t *tag;
+    uintptr_t sum = 0;
+    double start;
+    double handle_ns;
+    double address_ns;
+    double linear_ns;
+    double churn_ns;
+
+    //connection handles start from 1
+    aoa_db_remove_all();
+    for (uint32_t n = 0; n < count; n++) {
+      sli_aoa_db_bench_address(n, &sli_addresses[n]);
+      if (aoa_db_add_tag((uint16_t)(n + 1), &sli_addresses[n], 0, &sli_entries[n]) != SL_STATUS_OK) {
+        fprintf(stderr, "Failed to add tag %u\n", n);
+        return EXIT_FAILURE;
+      }
+    }
+    for (uint32_t n = 0; n < SLI_AOA_DB_BENCH_STREAM; n++) {
+      sli_stream[n] = sli_aoa_db_bench_random(&random_state) % count;
+    }
+    for (uint32_t n = 0; n < count; n++) {
+      aoa_db_entry_t *by_address;
+      if ((aoa_db_get_tag_by_handle((uint16_t)(n + 1), &tag) != SL_STATUS_OK)
+          || (aoa_db_get_tag_by_address(&sli_addresses[n], &by_address) != SL_STATUS_OK)
+          || (tag != by_address) || (tag != sli_aoa_db_bench_linear(&sli_addresses[n], count))) {
+        fprintf(stderr, "Lookups of tag %u disagree\n", n);
+        return EXIT_FAILURE;
+      }
+    }
+
+    start = sli_aoa_db_bench_now();
+    for (uint64_t r = 0; r < rounds; r++) {
+      for (uint32_t n = 0; n < SLI_AOA_DB_BENCH_STREAM; n++) {
+        if (aoa_db_get_tag_by_handle((uint16_t)(sli_stream[n] + 1), &tag) == SL_STATUS_OK) {
+          sum += (uintptr_t)tag;
+        }
+      }
+    }
+    handle_ns = (sli_aoa_db_bench_now() - start) * 1e9;
+
+    start = sli_aoa_db_bench_now();
+    for (uint64_t r = 0; r < rounds; r++) {
+      for (uint32_t n = 0; n < SLI_AOA_DB_BENCH_STREAM; n++) {
+        if (aoa_db_get_tag_by_address(&sli_addresses[sli_stream[n]], &tag) == SL_STATUS_OK) {
+          sum -= (uintptr_t)tag;
+        }
+      }
+    }
+    address_ns = (sli_aoa_db_bench_now() - start) * 1e9;
+
+    start = sli_aoa_db_bench_now();
+    for (uint64_t r = 0; r < rounds; r++) {
+      for (uint32_t n = 0; n < SLI_AOA_DB_BENCH_STREAM; n++) {
+        sum += (uintptr_t)sli_aoa_db_bench_linear(&sli_addresses[sli_stream[n]], count);
+      }
+    }
+    linear_ns = (sli_aoa_db_bench_now() - start) * 1e9;
+
+    sli_sink = sum;
+
+    //Silabs mode tags going out of and coming into range
+    aoa_db_remove_all();
+    for (uint32_t n = 0; n < count; n++) {
+      if (aoa_db_add_tag(AOA_DB_HANDLE_NONE, &sli_addresses[n], 0, &tag) != SL_STATUS_OK) {
+        fprintf(stderr, "Failed to add tag %u\n", n);
+        return EXIT_FAILURE;
+      }
+    }
+    start = sli_aoa_db_bench_now();
+    for (uint64_t r = 0; r < rounds; r++) {
+      bd_addr address;
+      sli_aoa_db_bench_address(next_tag++, &address);
+      (void)aoa_db_remove_lru_tag();
+      if (aoa_db_add_tag(AOA_DB_HANDLE_NONE, &address, 0, &tag) != SL_STATUS_OK) {
+        fprintf(stderr, "Failed to add tag %u\n", next_tag);
+        return EXIT_FAILURE;
+      }
+    }
+    churn_ns = (sli_aoa_db_bench_now() - start) * 1e9;
+
+    printf("%7u  %10.2f  %10.2f  %10.2f  %10.2f\n", count,
+           handle_ns / (double)(rounds * SLI_AOA_DB_BENCH_STREAM),
+           address_ns / (double)(rounds * SLI_AOA_DB_BENCH_STREAM),
+           linear_ns / (double)(rounds * SLI_AOA_DB_BENCH_STREAM),
+           churn_ns / (double)rounds);
+  }
+
+  aoa_db_remove_all();
+  return EXIT_SUCCESS;
+}
+
+static void sli_aoa_db_bench_usage(const char *name)
+{
+  printf("Usage: %s [options]\n", name);
+  printf("  -n  Number of timed lookups, default: %u\n", SLI_AOA_DB_BENCH_DEFAULT_LOOKUPS);
+}
+
+///random static addresses, derived from the tag number
+static void sli_aoa_db_bench_address(uint32_t n, bd_addr *address)
+{
+  uint32_t random_state = (n + 1) * 2654435761U;
+
+  for (uint32_t i = 0; i < sizeof(address->addr); i++) {
+    address->addr[i] = (uint8_t)sli_aoa_db_bench_random(&random_state);
+  }
+  address->addr[5] |= 0xc0;
+}
+
+static aoa_db_entry_t *sli_aoa_db_bench_linear(const bd_addr *address, uint32_t count)
+{
+  for (uint32_t n = 0; n < count; n++) {
+    if (memcmp(&sli_entries[n]->address, address, sizeof(bd_addr)) == 0) {
+      return sli_entries[n];
+    }
+  }
+  return NULL;
+}
+
+///xorshift32
+static uint32_t sli_aoa_db_bench_random(uint32_t *state)
+{
+  uint32_t x = (*state != 0) ? *state : 1;
+
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+  *state = x;
+  return x;
+}
+
+static double sli_aoa_db_bench_now(void)
+{
+  struct timespec now;
+
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (double)now.tv_sec + ((double)now.tv_nsec * 1e-9);
+}
@@ -0,0 +1,554 @@
+/***************************************************************************//**
+ * @file
+ * @brief Accuracy and speed of the float and the fixed point IQ preprocessing,
+ *        of the cached phase rotation and of the pinned angle config.
+ * @version 1.0.0
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2024 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * The licensor of this software is Silicon Laboratories Inc. Your use of this
+ * software is governed by the terms of Silicon Labs Master Software License
+ * Agreement (MSLA) available at
+ * www.silabs.com/about-us/legal/master-software-license-agreement. This
+ * software is distributed to you in Source Code format and is governed by the
+ * sections of the MSLA applicable to Source Code.
+ *
+ ******************************************************************************/
+#include <math.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "antenna_array.h"
+#include "aoa_angle.h"
+#include "aoa_iq_gen.h"
+#include "aoa_iq_preprocess.h"
+
+//macros -----------------------------------------------------------------------
+#define SLI_AOA_IQ_BENCH_DEFAULT_REPORTS 1000
+#define SLI_AOA_IQ_BENCH_DEFAULT_ROUNDS  100
+#define SLI_AOA_IQ_BENCH_DEFAULT_SEED    1
+///IQ report buffer, the samples of a report fit in a BGAPI event
+#define SLI_AOA_IQ_BENCH_MAX_SAMPLES     128
+///scale of the raw samples in aoa_angle.c
+#define SLI_AOA_IQ_BENCH_SCALE           (1.0f / 127.0f)
+///reference period samples in aoa_angle.c
+#define SLI_AOA_IQ_BENCH_REF_SAMPLES     8
+#define SLI_AOA_IQ_BENCH_RAD_TO_DEG      (180.0 / M_PI)
+///largest accepted sample error of the Q15 path, in Q15 LSBs
+#define SLI_AOA_IQ_BENCH_MAX_ERROR_LSB   2.0
+///tags of the phase rotation cache comparison, one state each
+#define SLI_AOA_IQ_BENCH_TAGS            4
+#define SLI_AOA_IQ_BENCH_DEFAULT_CFO     20000.0f
+#define SLI_AOA_IQ_BENCH_DEFAULT_DRIFT   2.0f
+///CTE tone and measurement sample spacing of aoa_iq_gen.c
+#define SLI_AOA_IQ_BENCH_TONE_HZ         250000.0
+#define SLI_AOA_IQ_BENCH_SPACING_S       2e-6
+///configs ahead of the timed one in the config list, one per locator
+#define SLI_AOA_IQ_BENCH_DEFAULT_CONFIGS 16
+
+//private type definitions -----------------------------------------------------
+typedef struct {
+  int8_t samples[2 * SLI_AOA_IQ_BENCH_MAX_SAMPLES];
+  size_t count;
+} sli_aoa_iq_bench_report_t;
+
+typedef struct {
+  int8_t samples[2 * SLI_AOA_IQ_BENCH_MAX_SAMPLES];
+  aoa_iq_report_t iq_report;
+  uint8_t tag;
+  float rotation;  ///<true phase rotation between two measurement samples
+} sli_aoa_iq_bench_packet_t;
+
+//private function prototypes --------------------------------------------------
+static void sli_aoa_iq_bench_usage(const char *name);
+static float sli_aoa_iq_bench_rotation(const float *i_samples, const float *q_samples, size_t count);
+static void sli_aoa_iq_bench_divide(const int8_t *samples, size_t length, float *i_samples, float *q_samples);
+static double sli_aoa_iq_bench_now(void);
+static int sli_aoa_iq_bench_cache(aoa_iq_gen_config_t *config,
+                                  antenna_array_t *antenna_array,
+                                  uint32_t *random_state,
+                                  uint32_t count,
+                                  uint32_t rounds,
+                                  float cfo,
+                                  float drift);
+static int sli_aoa_iq_bench_lookup(aoa_iq_gen_config_t *config,
+                                   antenna_array_t *antenna_array,
+                                   uint32_t *random_state,
+                                   uint32_t count,
+                                   uint32_t rounds,
+                                   uint32_t configs);
+
+//private variables ------------------------------------------------------------
+static float sli_i_float[SLI_AOA_IQ_BENCH_MAX_SAMPLES];
+static float sli_q_float[SLI_AOA_IQ_BENCH_MAX_SAMPLES];
+static float sli_i_fixed[SLI_AOA_IQ_BENCH_MAX_SAMPLES];
+static float sli_q_fixed[SLI_AOA_IQ_BENCH_MAX_SAMPLES];
+static int16_t sli_i_q15[SLI_AOA_IQ_BENCH_MAX_SAMPLES];
+static int16_t sli_q_q15[SLI_AOA_IQ_BENCH_MAX_SAMPLES];
+///keeps the timed loops from being optimized away
+static volatile float sli_sink;
+
+//function definitions----------------------------------------------------------
+int main(int argc, char *argv[])
+{
+  aoa_iq_gen_config_t config;
+  antenna_array_t antenna_array;
+  aoa_iq_report_t iq_report;
+  aoa_iq_factor_t factor;
+  aoa_iq_factor_q15_t factor_q15;
+  sli_aoa_iq_bench_report_t *reports;
+  uint32_t count = SLI_AOA_IQ_BENCH_DEFAULT_REPORTS;
+  uint32_t rounds = SLI_AOA_IQ_BENCH_DEFAULT_ROUNDS;
+  uint32_t random_state = SLI_AOA_IQ_BENCH_DEFAULT_SEED;
+  float phase = 0.0f;
+  float cfo = SLI_AOA_IQ_BENCH_DEFAULT_CFO;
+  float drift = SLI_AOA_IQ_BENCH_DEFAULT_DRIFT;
+  uint32_t configs = SLI_AOA_IQ_BENCH_DEFAULT_CONFIGS;
+  sl_status_t sc;
+  int opt;
+
+  aoa_iq_gen_get_default_config(&config);
+
+  while ((opt = getopt(argc, argv, "n:r:s:p:S:c:d:l:h")) != -1) {
+    switch (opt) {
+      case 'n':
+        count = (uint32_t)strtoul(optarg, NULL, 10);
+        break;
+      case 'r':
+        rounds = (uint32_t)strtoul(optarg, NULL, 10);
+        break;
+      case 's':
+        config.snr_db = (strcmp(optarg, "inf") == 0) ? INFINITY : strtof(optarg, NULL);
+        break;
+      case 'p':
+        phase = strtof(optarg, NULL);
+        break;
+      case 'S':
+        random_state = (uint32_t)strtoul(optarg, NULL, 0);
+        break;
+      case 'c':
+        cfo = strtof(optarg, NULL);
+        break;
+      case 'd':
+        drift = strtof(optarg, NULL);
+        break;
+      case 'l':
+        configs = (uint32_t)strtoul(optarg, NULL, 10);
+        break;
+      default:
+        sli_aoa_iq_bench_usage(argv[0]);
+        return (opt == 'h') ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+  }
+  if ((count == 0) || (rounds == 0) || (random_state == 0)) {
+    sli_aoa_iq_bench_usage(argv[0]);
+    return EXIT_FAILURE;
+  }
+
+  aoa_iq_factor_init(&factor, SLI_AOA_IQ_BENCH_SCALE, phase);
+  sc = aoa_iq_factor_to_q15(&factor, &factor_q15);
+  if (sc != SL_STATUS_OK) {
+    fprintf(stderr, "Factor not representable in Q15: 0x%04x\n", (unsigned)sc);
+    return EXIT_FAILURE;
+  }
+
+  reports = malloc(count * sizeof(*reports));
+  if (reports == NULL) {
+    fprintf(stderr, "Failed to allocate %u reports\n", count);
+    return EXIT_FAILURE;
+  }
+
+  //tags all around the locator, on every channel
+  antenna_array_init(&antenna_array, ANTENNA_ARRAY_TYPE_4x4_URA);
+  for (uint32_t n = 0; n < count; n++) {
+    config.azimuth = (float)(n * 37 % 360);
+    config.elevation = (float)(n * 11 % 90);
+    config.channel = (uint8_t)(n % 40);
+    config.phase = (float)n;
+    sc = aoa_iq_gen_generate(&config, &antenna_array, &random_state,
+                             reports[n].samples, sizeof(reports[n].samples), &iq_report);
+    if (sc != SL_STATUS_OK) {
+      fprintf(stderr, "Failed to generate report %u: 0x%04x\n", n, (unsigned)sc);
+      free(reports);
+      return EXIT_FAILURE;
+    }
+    reports[n].count = iq_report.length / 2;
+  }
+
+  //accuracy of the fixed point path against the float reference
+  double error_sum = 0.0;
+  double error_max = 0.0;
+  double rotation_max = 0.0;
+  uint64_t error_count = 0;
+
+  for (uint32_t n = 0; n < count; n++) {
+    size_t pairs = reports[n].count;
+    float rotation_q15;
+
+    aoa_iq_preprocess_reference(reports[n].samples, pairs, &factor, sli_i_float, sli_q_float);
+    aoa_iq_preprocess_q15(reports[n].samples, pairs, &factor_q15, sli_i_q15, sli_q_q15);
+    aoa_iq_q15_to_float(sli_i_q15, pairs, sli_i_fixed);
+    aoa_iq_q15_to_float(sli_q_q15, pairs, sli_q_fixed);
+    for (size_t k = 0; k < pairs; k++) {
+      double di = fabs((double)sli_i_fixed[k] - sli_i_float[k]);
+      double dq = fabs((double)sli_q_fixed[k] - sli_q_float[k]);
+      error_sum += (di * di) + (dq * dq);
+      error_max = fmax(error_max, fmax(di, dq));
+    }
+    error_count += 2 * pairs;
+
+    float rotation_float = sli_aoa_iq_bench_rotation(sli_i_float, sli_q_float, SLI_AOA_IQ_BENCH_REF_SAMPLES);
+    aoa_iq_get_phase_rotation_q15(sli_i_q15, sli_q_q15, SLI_AOA_IQ_BENCH_REF_SAMPLES, &rotation_q15);
+    rotation_max = fmax(rotation_max, fabs(remainder((double)rotation_q15 - rotation_float, 2.0 * M_PI)));
+  }
+
+  printf("Reports: %u, %zu IQ sample pairs each, Q15 factor %d/%d, shift %d\n",
+         count, reports[0].count, factor_q15.real, factor_q15.imag, factor_q15.shift);
+  printf("Sample error: rms %.3g, max %.3g (Q15 LSB %.3g)\n",
+         sqrt(error_sum / (double)error_count), error_max, 1.0 / 32768.0);
+  printf("Reference rotation error: max %.3g deg\n", rotation_max * SLI_AOA_IQ_BENCH_RAD_TO_DEG);
+  if (error_max > (SLI_AOA_IQ_BENCH_MAX_ERROR_LSB / 32768.0)) {
+    fprintf(stderr, "Q15 sample error above %.0f LSB\n", SLI_AOA_IQ_BENCH_MAX_ERROR_LSB);
+    free(reports);
+    return EXIT_FAILURE;
+  }
+
+  //conversion throughput, the divide per sample of the former get_samples()
+  //against the float kernel and the Q15 kernel
+  double convert_ns[3];
+  uint64_t samples = 0;
+  for (uint32_t n = 0; n < count; n++) {
+    samples += 2 * reports[n].count;
+  }
+  for (int mode = 0; mode < 3; mode++) {
+    double start = sli_aoa_iq_bench_now();
+    for (uint32_t r = 0; r < rounds; r++) {
+      for (uint32_t n = 0; n < count; n++) {
+        if (mode == 0) {
+          sli_aoa_iq_bench_divide(reports[n].samples, 2 * reports[n].count, sli_i_float, sli_q_float);
+        } else if (mode == 1) {
+          aoa_iq_preprocess_reference(reports[n].samples, reports[n].count, &factor, sli_i_float, sli_q_float);
+        } else {
+          aoa_iq_preprocess_q15(reports[n].samples, reports[n].count, &factor_q15, sli_i_q15, sli_q_q15);
+        }
+      }
+      sli_sink = sli_i_float[0] + sli_q_float[0] + sli_i_q15[0];
+    }
+    convert_ns[mode] = (sli_aoa_iq_bench_now() - start) * 1e9 / ((double)rounds * samples);
+  }
+  printf("conversion  ns/sample  Msample/s\n");
+  printf("divide     %10.2f %10.1f\n", convert_ns[0], 1e3 / convert_ns[0]);
+  printf("float      %10.2f %10.1f\n", convert_ns[1], 1e3 / convert_ns[1]);
+  printf("q15        %10.2f %10.1f\n", convert_ns[2], 1e3 / convert_ns[2]);
+
+  //speed, the whole preprocessing of a report as done per CTE
+  double start = sli_aoa_iq_bench_now();
+  for (uint32_t r = 0; r < rounds; r++) {
+    for (uint32_t n = 0; n < count; n++) {
+      aoa_iq_preprocess_reference(reports[n].samples, reports[n].count, &factor, sli_i_float, sli_q_float);
+      sli_sink = sli_aoa_iq_bench_rotation(sli_i_float, sli_q_float, SLI_AOA_IQ_BENCH_REF_SAMPLES);
+    }
+  }
+  double float_ns = (sli_aoa_iq_bench_now() - start) * 1e9 / ((double)rounds * count);
+
+  start = sli_aoa_iq_bench_now();
+  for (uint32_t r = 0; r < rounds; r++) {
+    for (uint32_t n = 0; n < count; n++) {
+      float rotation;
+      aoa_iq_preprocess_q15(reports[n].samples, reports[n].count, &factor_q15, sli_i_q15, sli_q_q15);
+      aoa_iq_get_phase_rotation_q15(sli_i_q15, sli_q_q15, SLI_AOA_IQ_BENCH_REF_SAMPLES, &rotation);
+      aoa_iq_q15_to_float(sli_i_q15, reports[n].count, sli_i_fixed);
+      aoa_iq_q15_to_float(sli_q_q15, reports[n].count, sli_q_fixed);
+      sli_sink = rotation;
+    }
+  }
+  double fixed_ns = (sli_aoa_iq_bench_now() - start) * 1e9 / ((double)rounds * count);
+
+  printf("path       ns/packet\n");
+  printf("float     %10.1f\n", float_ns);
+  printf("q15       %10.1f\n", fixed_ns);
+
+  free(reports);
+  if (sli_aoa_iq_bench_cache(&config, &antenna_array, &random_state,
+                             count, rounds, cfo, drift) != EXIT_SUCCESS) {
+    return EXIT_FAILURE;
+  }
+  return sli_aoa_iq_bench_lookup(&config, &antenna_array, &random_state,
+                                 count, rounds, configs);
+}
+
+static void sli_aoa_iq_bench_usage(const char *name)
+{
+  printf("Usage: %s [options]\n", name);
+  printf("  -n  Number of generated IQ reports, default: %u\n", SLI_AOA_IQ_BENCH_DEFAULT_REPORTS);
+  printf("  -r  Timed rounds over the reports, default: %u\n", SLI_AOA_IQ_BENCH_DEFAULT_ROUNDS);
+  printf("  -s  SNR in dB or inf, default: 30\n");
+  printf("  -p  Derotation phase in radians, default: 0\n");
+  printf("  -S  Seed of the noise, default: %u\n", SLI_AOA_IQ_BENCH_DEFAULT_SEED);
+  printf("  -c  Largest CFO of the tags in Hz, default: %.0f\n", SLI_AOA_IQ_BENCH_DEFAULT_CFO);
+  printf("  -d  CFO drift of the tags in Hz per packet, default: %.1f\n", SLI_AOA_IQ_BENCH_DEFAULT_DRIFT);
+  printf("  -l  Configs ahead of the timed one, default: %u\n", SLI_AOA_IQ_BENCH_DEFAULT_CONFIGS);
+}
+
+///per packet against cached phase rotation, the same reports through both
+static int sli_aoa_iq_bench_cache(aoa_iq_gen_config_t *config,
+                                  antenna_array_t *antenna_array,
+                                  uint32_t *random_state,
+                                  uint32_t count,
+                                  uint32_t rounds,
+                                  float cfo,
+                                  float drift)
+{
+  static aoa_state_t states[2][SLI_AOA_IQ_BENCH_TAGS];
+  static aoa_id_t ids[2] = { "per_packet", "cached" };
+  sli_aoa_iq_bench_packet_t *packets;
+  aoa_angle_config_t *angle_config;
+  aoa_angle_t angle[2];
+  double rotation_sum[2] = { 0.0, 0.0 };
+  double azimuth_sum = 0.0;
+  double azimuth_max = 0.0;
+  double ns[2];
+  uint32_t estimated = 0;
+  uint32_t refreshed = 0;
+  uint32_t compared = 0;
+  sl_status_t sc;
+
+  packets = malloc(count * sizeof(*packets));
+  if (packets == NULL) {
+    fprintf(stderr, "Failed to allocate %u packets\n", count);
+    return EXIT_FAILURE;
+  }
+
+  //the tags hop over the channels, the CFO of each drifts slowly
+  for (uint32_t n = 0; n < count; n++) {
+    uint32_t tag = n % SLI_AOA_IQ_BENCH_TAGS;
+    uint32_t packet = n / SLI_AOA_IQ_BENCH_TAGS;
+    double tone;
+
+    config->azimuth = (float)(tag * 90 + 30);
+    config->elevation = 45.0f;
+    config->channel = (uint8_t)(packet * 7 % 40);
+    config->cfo_hz = cfo * (2.0f * (float)tag / (SLI_AOA_IQ_BENCH_TAGS - 1) - 1.0f)
+                     + (drift * (float)packet);
+    config->phase = (float)n;
+    sc = aoa_iq_gen_generate(config, antenna_array, random_state,
+                             packets[n].samples, sizeof(packets[n].samples),
+                             &packets[n].iq_report);
+    if (sc != SL_STATUS_OK) {
+      fprintf(stderr, "Failed to generate packet %u: 0x%04x\n", n, (unsigned)sc);
+      free(packets);
+      return EXIT_FAILURE;
+    }
+    packets[n].iq_report.event_counter = (uint16_t)packet;
+    packets[n].tag = (uint8_t)tag;
+    tone = 2.0 * M_PI * (SLI_AOA_IQ_BENCH_TONE_HZ + config->cfo_hz) * SLI_AOA_IQ_BENCH_SPACING_S;
+    packets[n].rotation = (float)remainder(tone, 2.0 * M_PI);
+  }
+
+  for (int mode = 0; mode < 2; mode++) {
+    sc = aoa_angle_add_config(ids[mode], &angle_config);
+    if (sc != SL_STATUS_OK) {
+      fprintf(stderr, "Failed to add config %s: 0x%04x\n", ids[mode], (unsigned)sc);
+      free(packets);
+      return EXIT_FAILURE;
+    }
+    angle_config->estimator = &aoa_estimator_portable;
+    angle_config->phase_rotation_cache = (mode == 1);
+  }
+
+  //accuracy, both against the true rotation and against each other
+  for (int mode = 0; mode < 2; mode++) {
+    for (uint32_t tag = 0; tag < SLI_AOA_IQ_BENCH_TAGS; tag++) {
+      aoa_init_rtl(&states[mode][tag], ids[mode], false);
+    }
+  }
+  for (uint32_t n = 0; n < count; n++) {
+    sli_aoa_iq_bench_packet_t *p = &packets[n];
+    enum sl_rtl_error_code ec[2];
+
+    for (int mode = 0; mode < 2; mode++) {
+      aoa_state_t *state = &states[mode][p->tag];
+      ec[mode] = aoa_calculate(state, &p->iq_report, &angle[mode], ids[mode]);
+      rotation_sum[mode] += pow(remainder((double)state->portable.phase_rotation - p->rotation,
+                                          2.0 * M_PI), 2);
+    }
+    if (states[1][p->tag].phase_rotation_cache[p->iq_report.channel].age == 1) {
+      refreshed++;
+    }
+    estimated++;
+    if ((ec[0] == SL_RTL_ERROR_SUCCESS) && (ec[1] == SL_RTL_ERROR_SUCCESS)) {
+      double d = fabs(remainder((double)angle[1].azimuth - angle[0].azimuth, 360.0));
+      azimuth_sum += d * d;
+      azimuth_max = fmax(azimuth_max, d);
+      compared++;
+    }
+  }
+
+  //speed of the whole angle calculation, the caches stay warm between rounds
+  for (int mode = 0; mode < 2; mode++) {
+    double start = sli_aoa_iq_bench_now();
+    for (uint32_t r = 0; r < rounds; r++) {
+      for (uint32_t n = 0; n < count; n++) {
+        aoa_calculate(&states[mode][packets[n].tag], &packets[n].iq_report, &angle[0], ids[mode]);
+      }
+    }
+    ns[mode] = (sli_aoa_iq_bench_now() - start) * 1e9 / ((double)rounds * count);
+  }
+  for (int mode = 0; mode < 2; mode++) {
+    for (uint32_t tag = 0; tag < SLI_AOA_IQ_BENCH_TAGS; tag++) {
+      aoa_deinit_rtl(&states[mode][tag], ids[mode]);
+    }
+  }
+
+  printf("Phase rotation cache: %u tags, CFO up to %.0f Hz, drift %.1f Hz/packet\n",
+         SLI_AOA_IQ_BENCH_TAGS, cfo, drift);
+  printf("Full estimations: %u of %u packets\n", refreshed, estimated);
+  printf("Azimuth difference to per packet: rms %.3g, max %.3g deg over %u angles\n",
+         (compared > 0) ? sqrt(azimuth_sum / compared) : 0.0, azimuth_max, compared);
+  printf("rotation   rms error deg   ns/packet\n");
+  for (int mode = 0; mode < 2; mode++) {
+    printf("%-10s %13.3f %11.1f\n", ids[mode],
+           sqrt(rotation_sum[mode] / count) * SLI_AOA_IQ_BENCH_RAD_TO_DEG, ns[mode]);
+  }
+
+  free(packets);
+  return EXIT_SUCCESS;
+}
+
+///pinned config against a config lookup by id on every packet
+static int sli_aoa_iq_bench_lookup(aoa_iq_gen_config_t *config,
+                                   antenna_array_t *antenna_array,
+                                   uint32_t *random_state,
+                                   uint32_t count,
+                                   uint32_t rounds,
+                                   uint32_t configs)
+{
+  static aoa_state_t state;
+  static aoa_id_t id = "ble-pd-000000000000";
+  sli_aoa_iq_bench_packet_t *packets;
+  aoa_angle_config_t *angle_config;
+  aoa_angle_t angle;
+  aoa_id_t other;
+  double ns[2];
+  sl_status_t sc;
+
+  packets = malloc(count * sizeof(*packets));
+  if (packets == NULL) {
+    fprintf(stderr, "Failed to allocate %u packets\n", count);
+    return EXIT_FAILURE;
+  }
+
+  //one tag, as seen by the locator of the timed config
+  config->azimuth = 30.0f;
+  config->elevation = 45.0f;
+  config->cfo_hz = 0.0f;
+  for (uint32_t n = 0; n < count; n++) {
+    config->channel = (uint8_t)(n * 7 % 40);
+    config->phase = (float)n;
+    sc = aoa_iq_gen_generate(config, antenna_array, random_state,
+                             packets[n].samples, sizeof(packets[n].samples),
+                             &packets[n].iq_report);
+    if (sc != SL_STATUS_OK) {
+      fprintf(stderr, "Failed to generate packet %u: 0x%04x\n", n, (unsigned)sc);
+      free(packets);
+      return EXIT_FAILURE;
+    }
+    packets[n].iq_report.event_counter = (uint16_t)n;
+  }
+
+  //the list is searched from the newest config, the timed one is the oldest
+  sc = aoa_angle_add_config(id, &angle_config);
+  if (sc != SL_STATUS_OK) {
+    fprintf(stderr, "Failed to add config %s: 0x%04x\n", id, (unsigned)sc);
+    free(packets);
+    return EXIT_FAILURE;
+  }
+  angle_config->estimator = &aoa_estimator_portable;
+  angle_config->phase_rotation_cache = false;
+  for (uint32_t n = 1; n <= configs; n++) {
+    snprintf(other, sizeof(other), "ble-pd-%012X", n);
+    sc = aoa_angle_add_config(other, NULL);
+    if (sc != SL_STATUS_OK) {
+      fprintf(stderr, "Failed to add config %s: 0x%04x\n", other, (unsigned)sc);
+      free(packets);
+      return EXIT_FAILURE;
+    }
+  }
+  aoa_init_rtl(&state, id, false);
+
+  //before: looked up on every packet, after: looked up once and pinned.
+  //The difference is small against the estimator, so the modes alternate and
+  //the fastest round of each is kept.
+  ns[0] = INFINITY;
+  ns[1] = INFINITY;
+  for (uint32_t r = 0; r < rounds; r++) {
+    for (int mode = 0; mode < 2; mode++) {
+      double start = sli_aoa_iq_bench_now();
+      for (uint32_t n = 0; n < count; n++) {
+        if (mode == 0) {
+          state.config = NULL;
+        }
+        aoa_calculate(&state, &packets[n].iq_report, &angle, id);
+      }
+      ns[mode] = fmin(ns[mode], (sli_aoa_iq_bench_now() - start) * 1e9 / count);
+    }
+  }
+
+  //the estimator may only be recycled for the config it was built with
+  if ((aoa_reset_rtl(&state, other) == SL_RTL_ERROR_SUCCESS)
+      || (aoa_reset_rtl(&state, id) != SL_RTL_ERROR_SUCCESS)) {
+    fprintf(stderr, "Estimator of %s reset for %s\n", id, other);
+    aoa_deinit_rtl(&state, id);
+    free(packets);
+    return EXIT_FAILURE;
+  }
+  aoa_deinit_rtl(&state, id);
+
+  printf("Angle config: %u configs ahead in the list\n", configs);
+  printf("config     ns/packet\n");
+  printf("lookup    %10.1f\n", ns[0]);
+  printf("pinned    %10.1f\n", ns[1]);
+
+  free(packets);
+  return EXIT_SUCCESS;
+}
+
+///conversion of the former get_samples(), a double divide and a length check per sample
+static void sli_aoa_iq_bench_divide(const int8_t *samples, size_t length, float *i_samples, float *q_samples)
+{
+  size_t index = 0;
+
+  for (size_t n = 0; index < length; n++) {
+    i_samples[n] = samples[index++] / 127.0;
+    if (index == length) {
+      break;
+    }
+    q_samples[n] = samples[index++] / 127.0;
+  }
+}
+
+///float counterpart of aoa_iq_get_phase_rotation_q15
+static float sli_aoa_iq_bench_rotation(const float *i_samples, const float *q_samples, size_t count)
+{
+  float sum_i = 0.0f;
+  float sum_q = 0.0f;
+
+  for (size_t n = 1; n < count; n++) {
+    sum_i += (i_samples[n] * i_samples[n - 1]) + (q_samples[n] * q_samples[n - 1]);
+    sum_q += (q_samples[n] * i_samples[n - 1]) - (i_samples[n] * q_samples[n - 1]);
+  }
+  return atan2f(sum_q, sum_i);
+}
+
+static double sli_aoa_iq_bench_now(void)
+{
+  struct timespec now;
+
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (double)now.tv_sec + ((double)now.tv_nsec * 1e-9);
+}
@@ -0,0 +1,238 @@
+/***************************************************************************//**
+ * @file
+ * @brief Round trip of the binary IQ frames published by app.c.
+ * @version 1.0.0
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2024 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * The licensor of this software is Silicon Laboratories Inc. Your use of this
+ * software is governed by the terms of Silicon Labs Master Software License
+ * Agreement (MSLA) available at
+ * www.silabs.com/about-us/legal/master-software-license-agreement. This
+ * software is distributed to you in Source Code format and is governed by the
+ * sections of the MSLA applicable to Source Code.
+ *
+ ******************************************************************************/
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "app.h"
+#include "aoa_iq_frame.h"
+
+//macros -----------------------------------------------------------------------
+#define SLI_AOA_IQ_FRAME_CHECK_DEFAULT_REPORTS 10000
+#define SLI_AOA_IQ_FRAME_CHECK_DEFAULT_SEED    1
+///header bytes appended by a later frame version, skipped by the decoder
+#define SLI_AOA_IQ_FRAME_CHECK_EXTRA_HEADER    4
+///the message content app.c builds the frame in
+#define SLI_AOA_IQ_FRAME_CHECK_CONTENT_SIZE    sizeof(((app_mqtt_data_t *)0)->content)
+
+//private function prototypes --------------------------------------------------
+static void sli_aoa_iq_frame_check_usage(const char *name);
+static void sli_aoa_iq_frame_check_report(uint32_t *random_state,
+                                          aoa_iq_report_t *iq,
+                                          uint8_t *tag_address,
+                                          uint8_t *locator_address);
+static int sli_aoa_iq_frame_check_decoded(uint32_t n,
+                                          const aoa_iq_report_t *iq,
+                                          const uint8_t *tag_address,
+                                          const uint8_t *locator_address,
+                                          const aoa_iq_report_t *decoded,
+                                          const uint8_t *decoded_tag_address,
+                                          const uint8_t *decoded_locator_address);
+static uint32_t sli_aoa_iq_frame_check_random(uint32_t *state);
+
+//private variables ------------------------------------------------------------
+static uint8_t sli_frame[SLI_AOA_IQ_FRAME_CHECK_CONTENT_SIZE + SLI_AOA_IQ_FRAME_CHECK_EXTRA_HEADER];
+static uint8_t sli_extended_frame[sizeof(sli_frame)];
+static int8_t sli_samples[UINT8_MAX];
+static int8_t sli_decoded_samples[UINT8_MAX];
+
+//function definitions----------------------------------------------------------
+int main(int argc, char *argv[])
+{
+  uint32_t reports = SLI_AOA_IQ_FRAME_CHECK_DEFAULT_REPORTS;
+  uint32_t random_state = SLI_AOA_IQ_FRAME_CHECK_DEFAULT_SEED;
+  uint32_t odd = 0;
+  uint32_t cut = 0;
+  int opt;
+
+  while ((opt = getopt(argc, argv, "n:S:h")) != -1) {
+    switch (opt) {
+      case 'n':
+        reports = (uint32_t)strtoul(optarg, NULL, 10);
+        break;
+      case 'S':
+        random_state = (uint32_t)strtoul(optarg, NULL, 10);
+        break;
+      default:
+        sli_aoa_iq_frame_check_usage(argv[0]);
+        return (opt == 'h') ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+  }
+
+  for (uint32_t n = 0; n < reports; n++) {
+    aoa_iq_report_t iq = { .samples = sli_samples };
+    aoa_iq_report_t decoded = { .samples = sli_decoded_samples };
+    uint8_t tag_address[AOA_IQ_FRAME_ADDRESS_SIZE];
+    uint8_t locator_address[AOA_IQ_FRAME_ADDRESS_SIZE];
+    uint8_t decoded_tag_address[AOA_IQ_FRAME_ADDRESS_SIZE];
+    uint8_t decoded_locator_address[AOA_IQ_FRAME_ADDRESS_SIZE];
+    size_t frame_size = 0;
+    sl_status_t sc;
+
+    sli_aoa_iq_frame_check_report(&random_state, &iq, tag_address, locator_address);
+    sc = aoa_serialize_iq_frame(&iq, tag_address, locator_address,
+                                sli_frame, SLI_AOA_IQ_FRAME_CHECK_CONTENT_SIZE, &frame_size);
+    if (sc != SL_STATUS_OK) {
+      fprintf(stderr, "Report %u: serialize failed: 0x%04x\n", n, (unsigned)sc);
+      return EXIT_FAILURE;
+    }
+    if (frame_size != (AOA_IQ_FRAME_HEADER_SIZE + sli_frame[AOA_IQ_FRAME_OFFSET_LENGTH])) {
+      fprintf(stderr, "Report %u: frame size %zu, header says %u samples\n",
+              n, frame_size, sli_frame[AOA_IQ_FRAME_OFFSET_LENGTH]);
+      return EXIT_FAILURE;
+    }
+    odd += iq.length & 1;
+    cut += (iq.length > (SLI_AOA_IQ_FRAME_CHECK_CONTENT_SIZE - AOA_IQ_FRAME_HEADER_SIZE));
+
+    sc = aoa_deserialize_iq_frame(sli_frame, frame_size, decoded_tag_address, decoded_locator_address, &decoded);
+    if (sc != SL_STATUS_OK) {
+      fprintf(stderr, "Report %u: deserialize failed: 0x%04x\n", n, (unsigned)sc);
+      return EXIT_FAILURE;
+    }
+    if (sli_aoa_iq_frame_check_decoded(n, &iq, tag_address, locator_address,
+                                       &decoded, decoded_tag_address, decoded_locator_address) != 0) {
+      return EXIT_FAILURE;
+    }
+
+    //a frame cut anywhere before its last sample byte is rejected
+    for (size_t size = 0; size < frame_size; size++) {
+      if (aoa_deserialize_iq_frame(sli_frame, size, NULL, NULL, &decoded) != SL_STATUS_INVALID_PARAMETER) {
+        fprintf(stderr, "Report %u: frame truncated to %zu of %zu bytes accepted\n", n, size, frame_size);
+        return EXIT_FAILURE;
+      }
+    }
+
+    //a longer header of a later frame is skipped, the samples follow it
+    memcpy(sli_extended_frame, sli_frame, AOA_IQ_FRAME_HEADER_SIZE);
+    memset(&sli_extended_frame[AOA_IQ_FRAME_HEADER_SIZE], 0xA5, SLI_AOA_IQ_FRAME_CHECK_EXTRA_HEADER);
+    memcpy(&sli_extended_frame[AOA_IQ_FRAME_HEADER_SIZE + SLI_AOA_IQ_FRAME_CHECK_EXTRA_HEADER],
+           &sli_frame[AOA_IQ_FRAME_HEADER_SIZE],
+           frame_size - AOA_IQ_FRAME_HEADER_SIZE);
+    sli_extended_frame[AOA_IQ_FRAME_OFFSET_HEADER_SIZE] = AOA_IQ_FRAME_HEADER_SIZE + SLI_AOA_IQ_FRAME_CHECK_EXTRA_HEADER;
+    memset(&decoded, 0, sizeof(decoded));
+    decoded.samples = sli_decoded_samples;
+    sc = aoa_deserialize_iq_frame(sli_extended_frame, frame_size + SLI_AOA_IQ_FRAME_CHECK_EXTRA_HEADER,
+                                  decoded_tag_address, decoded_locator_address, &decoded);
+    if (sc != SL_STATUS_OK) {
+      fprintf(stderr, "Report %u: extended header rejected: 0x%04x\n", n, (unsigned)sc);
+      return EXIT_FAILURE;
+    }
+    if (sli_aoa_iq_frame_check_decoded(n, &iq, tag_address, locator_address,
+                                       &decoded, decoded_tag_address, decoded_locator_address) != 0) {
+      return EXIT_FAILURE;
+    }
+
+    //a header shorter than the known one and an unknown version are rejected
+    sli_extended_frame[AOA_IQ_FRAME_OFFSET_HEADER_SIZE] = AOA_IQ_FRAME_HEADER_SIZE - 1;
+    if (aoa_deserialize_iq_frame(sli_extended_frame, sizeof(sli_extended_frame), NULL, NULL, &decoded) != SL_STATUS_INVALID_PARAMETER) {
+      fprintf(stderr, "Report %u: short header accepted\n", n);
+      return EXIT_FAILURE;
+    }
+    sli_frame[AOA_IQ_FRAME_OFFSET_VERSION] = AOA_IQ_FRAME_VERSION + 1;
+    if (aoa_deserialize_iq_frame(sli_frame, frame_size, NULL, NULL, &decoded) != SL_STATUS_NOT_SUPPORTED) {
+      fprintf(stderr, "Report %u: version %u accepted\n", n, AOA_IQ_FRAME_VERSION + 1);
+      return EXIT_FAILURE;
+    }
+  }
+  //the content holds all samples of a report if the angles are not calculated
+  if ((reports >= 100)
+      && ((odd == 0)
+          || ((cut == 0) && (SLI_AOA_IQ_FRAME_CHECK_CONTENT_SIZE < AOA_IQ_FRAME_MAX_SIZE)))) {
+    fprintf(stderr, "Reports did not cover odd lengths (%u) or samples beyond the content (%u)\n", odd, cut);
+    return EXIT_FAILURE;
+  }
+
+  printf("Reports: %u in %zu byte frames, %u odd length, %u cut to fit, all round trips exact\n",
+         reports, (size_t)SLI_AOA_IQ_FRAME_CHECK_CONTENT_SIZE, odd, cut);
+  return EXIT_SUCCESS;
+}
+
+static void sli_aoa_iq_frame_check_usage(const char *name)
+{
+  printf("Usage: %s [options]\n", name);
+  printf("  -n  Number of IQ reports, default: %u\n", SLI_AOA_IQ_FRAME_CHECK_DEFAULT_REPORTS);
+  printf("  -S  Seed of the report contents, default: %u\n", SLI_AOA_IQ_FRAME_CHECK_DEFAULT_SEED);
+}
+
+///random report of any length, odd lengths and the ones not fitting the content included
+static void sli_aoa_iq_frame_check_report(uint32_t *random_state,
+                                          aoa_iq_report_t *iq,
+                                          uint8_t *tag_address,
+                                          uint8_t *locator_address)
+{
+  iq->channel = (uint8_t)(sli_aoa_iq_frame_check_random(random_state) % 40);
+  iq->rssi = (int8_t)sli_aoa_iq_frame_check_random(random_state);
+  iq->event_counter = (uint16_t)sli_aoa_iq_frame_check_random(random_state);
+  iq->length = (uint8_t)sli_aoa_iq_frame_check_random(random_state);
+  for (uint32_t i = 0; i < iq->length; i++) {
+    iq->samples[i] = (int8_t)sli_aoa_iq_frame_check_random(random_state);
+  }
+  for (uint32_t i = 0; i < AOA_IQ_FRAME_ADDRESS_SIZE; i++) {
+    tag_address[i] = (uint8_t)sli_aoa_iq_frame_check_random(random_state);
+    locator_address[i] = (uint8_t)sli_aoa_iq_frame_check_random(random_state);
+  }
+}
+
+///the decoded report holds the whole IQ pairs that fit the content
+static int sli_aoa_iq_frame_check_decoded(uint32_t n,
+                                          const aoa_iq_report_t *iq,
+                                          const uint8_t *tag_address,
+                                          const uint8_t *locator_address,
+                                          const aoa_iq_report_t *decoded,
+                                          const uint8_t *decoded_tag_address,
+                                          const uint8_t *decoded_locator_address)
+{
+  size_t length = iq->length;
+
+  if (length > (SLI_AOA_IQ_FRAME_CHECK_CONTENT_SIZE - AOA_IQ_FRAME_HEADER_SIZE)) {
+    length = SLI_AOA_IQ_FRAME_CHECK_CONTENT_SIZE - AOA_IQ_FRAME_HEADER_SIZE;
+  }
+  length &= ~(size_t)1;
+  if ((decoded->channel != iq->channel)
+      || (decoded->rssi != iq->rssi)
+      || (decoded->event_counter != iq->event_counter)) {
+    fprintf(stderr, "Report %u: channel %u rssi %d counter %u, expected %u %d %u\n", n,
+            decoded->channel, decoded->rssi, decoded->event_counter,
+            iq->channel, iq->rssi, iq->event_counter);
+    return -1;
+  }
+  if ((memcmp(decoded_tag_address, tag_address, AOA_IQ_FRAME_ADDRESS_SIZE) != 0)
+      || (memcmp(decoded_locator_address, locator_address, AOA_IQ_FRAME_ADDRESS_SIZE) != 0)) {
+    fprintf(stderr, "Report %u: addresses differ\n", n);
+    return -1;
+  }
+  if ((decoded->length != length) || (memcmp(decoded->samples, iq->samples, length) != 0)) {
+    fprintf(stderr, "Report %u: %u sample bytes of %u decoded, expected %zu\n",
+            n, decoded->length, iq->length, length);
+    return -1;
+  }
+  return 0;
+}
+
+///xorshift32
+static uint32_t sli_aoa_iq_frame_check_random(uint32_t *state)
+{
+  uint32_t x = (*state != 0) ? *state : 1;
+
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+  *state = x;
+  return x;
+}
@@ -0,0 +1,212 @@
+/***************************************************************************//**
+ * @file
+ * @brief Command line generator of synthetic AoA captures.
+ * @version 1.0.0
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2024 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * The licensor of this software is Silicon Laboratories Inc. Your use of this
+ * software is governed by the terms of Silicon Labs Master Software License
+ * Agreement (MSLA) available at
+ * www.silabs.com/about-us/legal/master-software-license-agreement. This
+ * software is distributed to you in Source Code format and is governed by the
+ * sections of the MSLA applicable to Source Code.
+ *
+ ******************************************************************************/
+#include <math.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "sl_bt_api.h"
+#include "antenna_array.h"
+#include "aoa_iq_gen.h"
+#include "aoa_angle_config.h"
+#include "aoa_capture.h"
+
+//macros -----------------------------------------------------------------------
+#define SLI_AOA_IQ_GEN_DEFAULT_REPORTS 1000
+#define SLI_AOA_IQ_GEN_DEFAULT_RATE    1000.0
+#define SLI_AOA_IQ_GEN_DEFAULT_SEED    1
+///BGAPI header of an event with the given payload length
+#define SLI_AOA_IQ_GEN_HEADER(id, len) ((id) | (((len) & 0xff) << 8) | (((len) >> 8) & 0x7))
+
+//private type definitions -----------------------------------------------------
+//private function prototypes --------------------------------------------------
+static void sli_aoa_iq_gen_usage(const char *name);
+static sl_status_t sli_aoa_iq_gen_parse_pattern(char *text, antenna_array_t *antenna_array);
+
+//private variables ------------------------------------------------------------
+//function definitions----------------------------------------------------------
+int main(int argc, char *argv[])
+{
+  aoa_iq_gen_config_t config;
+  antenna_array_t antenna_array;
+  aoa_capture_writer_t writer;
+  aoa_iq_report_t iq_report;
+  sl_bt_msg_t evt;
+  const char *path = NULL;
+  char *pattern = NULL;
+  uint8_t array_type = ANTENNA_ARRAY_TYPE_4x4_URA;
+  uint32_t reports = SLI_AOA_IQ_GEN_DEFAULT_REPORTS;
+  uint32_t tags = 1;
+  uint32_t random_state = SLI_AOA_IQ_GEN_DEFAULT_SEED;
+  double rate = SLI_AOA_IQ_GEN_DEFAULT_RATE;
+  sl_status_t sc;
+  int opt;
+
+  aoa_iq_gen_get_default_config(&config);
+
+  while ((opt = getopt(argc, argv, "o:a:e:c:s:f:d:t:p:n:T:R:S:h")) != -1) {
+    switch (opt) {
+      case 'o':
+        path = optarg;
+        break;
+      case 'a':
+        config.azimuth = strtof(optarg, NULL);
+        break;
+      case 'e':
+        config.elevation = strtof(optarg, NULL);
+        break;
+      case 'c':
+        config.channel = (uint8_t)strtoul(optarg, NULL, 10);
+        break;
+      case 's':
+        config.snr_db = (strcmp(optarg, "inf") == 0) ? INFINITY : strtof(optarg, NULL);
+        break;
+      case 'f':
+        config.cfo_hz = strtof(optarg, NULL);
+        break;
+      case 'd':
+        config.spacing = strtof(optarg, NULL);
+        break;
+      case 't':
+        array_type = (uint8_t)strtoul(optarg, NULL, 10);
+        break;
+      case 'p':
+        pattern = optarg;
+        break;
+      case 'n':
+        reports = (uint32_t)strtoul(optarg, NULL, 10);
+        break;
+      case 'T':
+        tags = (uint32_t)strtoul(optarg, NULL, 10);
+        break;
+      case 'R':
+        rate = strtod(optarg, NULL);
+        break;
+      case 'S':
+        random_state = (uint32_t)strtoul(optarg, NULL, 0);
+        break;
+      default:
+        sli_aoa_iq_gen_usage(argv[0]);
+        return (opt == 'h') ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+  }
+  if ((path == NULL) || (tags == 0) || (tags > 0xffffff) || (rate <= 0.0) || (random_state == 0)) {
+    sli_aoa_iq_gen_usage(argv[0]);
+    return EXIT_FAILURE;
+  }
+
+  sc = antenna_array_init(&antenna_array, array_type);
+  if ((sc == SL_STATUS_OK) && (pattern != NULL)) {
+    sc = sli_aoa_iq_gen_parse_pattern(pattern, &antenna_array);
+  }
+  if (sc != SL_STATUS_OK) {
+    fprintf(stderr, "Invalid antenna array type or switch pattern: 0x%04x\n", (unsigned)sc);
+    return EXIT_FAILURE;
+  }
+
+  sc = aoa_capture_writer_open(&writer, path);
+  if (sc != SL_STATUS_OK) {
+    fprintf(stderr, "Failed to create capture %s: 0x%04x\n", path, (unsigned)sc);
+    return EXIT_FAILURE;
+  }
+
+  //the pipeline starts with the boot event, like after an NCP reset
+  memset(&evt, 0, sizeof(evt));
+  evt.header = SLI_AOA_IQ_GEN_HEADER(sl_bt_evt_system_boot_id, sizeof(sl_bt_evt_system_boot_t));
+  sc = aoa_capture_writer_write(&writer, 0, &evt);
+
+  sl_bt_evt_cte_receiver_silabs_iq_report_t *report = &evt.data.evt_cte_receiver_silabs_iq_report;
+  size_t capacity = SL_BGAPI_MAX_PAYLOAD_SIZE - sizeof(*report);
+  float azimuth = config.azimuth;
+  uint64_t index = 0;
+
+  for (uint32_t n = 0; (n < reports) && (sc == SL_STATUS_OK); n++) {
+    for (uint32_t tag = 0; (tag < tags) && (sc == SL_STATUS_OK); tag++, index++) {
+      //the tags are spread evenly around the locator
+      config.azimuth = fmodf(azimuth + (360.0f * (float)tag / (float)tags), 360.0f);
+      sc = aoa_iq_gen_generate(&config, &antenna_array, &random_state,
+                               (int8_t *)report->samples.data, capacity, &iq_report);
+      if (sc != SL_STATUS_OK) {
+        break;
+      }
+
+      report->status = 0;
+      report->address.addr[0] = (uint8_t)tag;
+      report->address.addr[1] = (uint8_t)(tag >> 8);
+      report->address.addr[2] = (uint8_t)(tag >> 16);
+      report->address.addr[3] = 0x0b;
+      report->address.addr[4] = 0xa0;
+      report->address.addr[5] = 0x5a;
+      report->address_type = 0;
+      report->phy = 1;
+      report->channel = iq_report.channel;
+      report->rssi = iq_report.rssi;
+      report->rssi_antenna_id = 0;
+      report->cte_type = 0;
+      report->slot_durations = config.slot_duration;
+      report->packet_counter = (uint16_t)n;
+      report->samples.len = iq_report.length;
+      evt.header = SLI_AOA_IQ_GEN_HEADER(sl_bt_evt_cte_receiver_silabs_iq_report_id,
+                                         sizeof(*report) + iq_report.length);
+
+      sc = aoa_capture_writer_write(&writer, (uint64_t)((double)index * 1e6 / rate), &evt);
+    }
+  }
+
+  if (sc != SL_STATUS_OK) {
+    fprintf(stderr, "Failed to generate report %llu: 0x%04x\n", (unsigned long long)index, (unsigned)sc);
+  }
+  if ((aoa_capture_writer_close(&writer) != SL_STATUS_OK) || (sc != SL_STATUS_OK)) {
+    return EXIT_FAILURE;
+  }
+  printf("%llu IQ reports of %u tags written to %s\n", (unsigned long long)index, tags, path);
+  return EXIT_SUCCESS;
+}
+
+static void sli_aoa_iq_gen_usage(const char *name)
+{
+  printf("Usage: %s -o <capture file> [options]\n", name);
+  printf("  -a  Azimuth of the first tag in degrees, default: 0\n");
+  printf("  -e  Elevation in degrees, default: 90\n");
+  printf("  -c  BLE channel, default: 37\n");
+  printf("  -s  SNR in dB or inf, default: 30\n");
+  printf("  -f  Carrier frequency offset in Hz, default: 0\n");
+  printf("  -d  Antenna spacing in meters, default: %.4f\n", AOA_ANGLE_ANTENNA_SPACING);
+  printf("  -t  Antenna array type: 0 4x4 URA, 1 3x3 URA, 2 1x4 ULA, 3 4x4 DP URA\n");
+  printf("  -p  Switch pattern, comma separated antenna numbers starting from 0\n");
+  printf("  -n  IQ reports per tag, default: %u\n", SLI_AOA_IQ_GEN_DEFAULT_REPORTS);
+  printf("  -T  Number of tags, spread evenly in azimuth, default: 1\n");
+  printf("  -R  IQ reports per second of all tags, default: %.0f\n", SLI_AOA_IQ_GEN_DEFAULT_RATE);
+  printf("  -S  Seed of the noise, default: %u\n", SLI_AOA_IQ_GEN_DEFAULT_SEED);
+}
+
+static sl_status_t sli_aoa_iq_gen_parse_pattern(char *text, antenna_array_t *antenna_array)
+{
+  uint8_t pattern[ANTENNA_ARRAY_MAX_PATTERN_SIZE];
+  uint8_t size = 0;
+  char *saveptr = NULL;
+
+  for (char *token = strtok_r(text, ",", &saveptr); token != NULL; token = strtok_r(NULL, ",", &saveptr)) {
+    if (size == ANTENNA_ARRAY_MAX_PATTERN_SIZE) {
+      return SL_STATUS_INVALID_PARAMETER;
+    }
+    pattern[size++] = (uint8_t)strtoul(token, NULL, 10);
+  }
+  return antenna_array_set_pattern(antenna_array, pattern, size);
+}
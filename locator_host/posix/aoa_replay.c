@@ -0,0 +1,367 @@
+/***************************************************************************//**
+ * @file
+ * @brief Replays an AoA capture through the AoA pipeline and reports its throughput.
+ * @version 1.0.0
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2024 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * The licensor of this software is Silicon Laboratories Inc. Your use of this
+ * software is governed by the terms of Silicon Labs Master Software License
+ * Agreement (MSLA) available at
+ * www.silabs.com/about-us/legal/master-software-license-agreement. This
+ * software is distributed to you in Source Code format and is governed by the
+ * sections of the MSLA applicable to Source Code.
+ *
+ ******************************************************************************/
+#include <errno.h>
+#include <math.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "sl_bt_api.h"
+#include "sl_bt_ncp_host.h"
+#include "sl_bluetooth.h"
+#include "sl_bt_aoa.h"
+#include "aoa_cte.h"
+#include "aoa_angle.h"
+#include "aoa_capture.h"
+#include "sl_timer.h"
+#include "sl_latency_trace.h"
+
+//macros -----------------------------------------------------------------------
+///FNV-1a parameters of the output digest
+#define SLI_AOA_REPLAY_DIGEST_OFFSET  0xcbf29ce484222325ULL
+#define SLI_AOA_REPLAY_DIGEST_PRIME   0x100000001b3ULL
+///Angles are rounded to this resolution before hashing
+#define SLI_AOA_REPLAY_DIGEST_SCALE   100.0f
+
+//private type definitions -----------------------------------------------------
+///Measured stages of the pipeline.
+typedef enum {
+  SLI_AOA_REPLAY_STAGE_EVENT,     //sl_bt_on_event()
+  SLI_AOA_REPLAY_STAGE_CTE,       //aoa_cte_bt_on_event()
+  SLI_AOA_REPLAY_STAGE_IQ_REPORT, //aoa_cte_on_iq_report()
+  SLI_AOA_REPLAY_STAGE_ANGLE,     //aoa_calculate()
+  SLI_AOA_REPLAY_STAGE_COUNT
+} sli_aoa_replay_stage_t;
+
+///Latency samples of a stage in ns.
+typedef struct {
+  const char *name;
+  uint32_t *samples;
+  size_t count;
+  size_t capacity;
+} sli_aoa_replay_latency_t;
+
+//private function prototypes --------------------------------------------------
+sl_status_t __real_aoa_cte_bt_on_event(sl_bt_msg_t *evt);
+void __real_aoa_cte_on_iq_report(aoa_db_entry_t *tag, aoa_iq_report_t *iq_report);
+enum sl_rtl_error_code __real_aoa_calculate(aoa_state_t *aoa_state,
+                                            aoa_iq_report_t *iq_report,
+                                            aoa_angle_t *angle,
+                                            aoa_id_t config_id);
+static void sli_aoa_replay_usage(const char *name);
+static uint64_t sli_aoa_replay_now_ns(void);
+static void sli_aoa_replay_add_latency(sli_aoa_replay_stage_t stage, uint64_t start_ns);
+static void sli_aoa_replay_print_latency(void);
+static int sli_aoa_replay_compare(const void *a, const void *b);
+static void sli_aoa_replay_digest(const void *data, size_t size);
+static void sli_aoa_replay_ncp_write(uint32_t len, uint8_t *data);
+static int32_t sli_aoa_replay_ncp_read(uint32_t len, uint8_t *data);
+static int32_t sli_aoa_replay_ncp_peek(void);
+
+//private variables ------------------------------------------------------------
+static sli_aoa_replay_latency_t sli_aoa_replay_latency[SLI_AOA_REPLAY_STAGE_COUNT] = {
+  [SLI_AOA_REPLAY_STAGE_EVENT] = { .name = "event" },
+  [SLI_AOA_REPLAY_STAGE_CTE] = { .name = "cte" },
+  [SLI_AOA_REPLAY_STAGE_IQ_REPORT] = { .name = "iq_report" },
+  [SLI_AOA_REPLAY_STAGE_ANGLE] = { .name = "angle" },
+};
+static uint64_t sli_aoa_replay_digest_value = SLI_AOA_REPLAY_DIGEST_OFFSET;
+static uint32_t sli_aoa_replay_output_count = 0;
+///Response of the last command, there is no NCP to answer it
+static uint8_t sli_aoa_replay_response[SL_BGAPI_MSG_HEADER_LEN + sizeof(uint16_t)];
+static uint32_t sli_aoa_replay_response_length = 0;
+
+//function definitions----------------------------------------------------------
+int main(int argc, char *argv[])
+{
+  aoa_capture_reader_t reader;
+  sl_bt_msg_t evt;
+  uint64_t time_us;
+  double speed = 0.0;
+  double start_s = 0.0;
+  uint32_t event_count = 0;
+  uint32_t iq_report_count = 0;
+  bool dump_trace = false;
+  sl_status_t sc;
+  int opt;
+
+  while ((opt = getopt(argc, argv, "r:s:th")) != -1) {
+    switch (opt) {
+      case 'r':
+        speed = strtod(optarg, NULL);
+        break;
+      case 's':
+        start_s = strtod(optarg, NULL);
+        break;
+      case 't':
+        dump_trace = true;
+        break;
+      default:
+        sli_aoa_replay_usage(argv[0]);
+        return (opt == 'h') ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+  }
+  if ((optind != argc - 1) || (speed < 0.0) || (start_s < 0.0)) {
+    sli_aoa_replay_usage(argv[0]);
+    return EXIT_FAILURE;
+  }
+
+  sc = aoa_capture_reader_open(&reader, argv[optind]);
+  if (sc != SL_STATUS_OK) {
+    fprintf(stderr, "Failed to open capture %s: 0x%04x\n", argv[optind], (unsigned)sc);
+    return EXIT_FAILURE;
+  }
+  if (reader.record_count > 0) {
+    printf("Capture: %u records, %.3f s, %u index entries\n",
+           reader.record_count, (double)reader.duration_us / 1e6, reader.index_count);
+  } else {
+    printf("Capture: no index, the recording was not closed\n");
+  }
+  if (start_s > 0.0) {
+    sc = aoa_capture_reader_seek(&reader, (uint64_t)(start_s * 1e6));
+    if (sc != SL_STATUS_OK) {
+      fprintf(stderr, "Failed to seek to %.3f s: 0x%04x\n", start_s, (unsigned)sc);
+      aoa_capture_reader_close(&reader);
+      return EXIT_FAILURE;
+    }
+  }
+
+  (void)sl_bt_api_initialize_nonblock(sli_aoa_replay_ncp_write,
+                                      sli_aoa_replay_ncp_read,
+                                      sli_aoa_replay_ncp_peek);
+  sl_bt_aoa_init();
+
+  uint64_t first_us = 0;
+  uint64_t replay_start_ns = sli_aoa_replay_now_ns();
+  while ((sc = aoa_capture_reader_read(&reader, &time_us, &evt)) == SL_STATUS_OK) {
+    if (event_count == 0) {
+      first_us = time_us;
+    }
+    if (speed > 0.0) {
+      uint64_t due_ns = replay_start_ns + (uint64_t)((double)(time_us - first_us) * 1000.0 / speed);
+      struct timespec due = { .tv_sec = (time_t)(due_ns / 1000000000), .tv_nsec = (long)(due_ns % 1000000000) };
+      while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &due, NULL) == EINTR) {
+      }
+    }
+
+    switch (SL_BT_MSG_ID(evt.header)) {
+      case sl_bt_evt_cte_receiver_silabs_iq_report_id:
+      case sl_bt_evt_cte_receiver_connectionless_iq_report_id:
+      case sl_bt_evt_cte_receiver_connection_iq_report_id:
+        iq_report_count++;
+        break;
+      default:
+        break;
+    }
+
+    uint64_t start_ns = sli_aoa_replay_now_ns();
+    sl_bt_on_event(&evt);
+    sli_aoa_replay_add_latency(SLI_AOA_REPLAY_STAGE_EVENT, start_ns);
+    sl_bt_aoa_process_action();
+    event_count++;
+  }
+  double elapsed_s = (double)(sli_aoa_replay_now_ns() - replay_start_ns) / 1e9;
+  aoa_capture_reader_close(&reader);
+  if (sc != SL_STATUS_EMPTY) {
+    fprintf(stderr, "Capture is corrupted after %u events: 0x%04x\n", event_count, (unsigned)sc);
+  }
+
+  printf("Replayed %u events, %u IQ reports in %.3f s: %.0f packets/s\n",
+         event_count, iq_report_count, elapsed_s,
+         (elapsed_s > 0.0) ? (double)iq_report_count / elapsed_s : 0.0);
+  sli_aoa_replay_print_latency();
+  sl_timer_hist_dump();
+  if (dump_trace) {
+    sl_latency_trace_dump();
+  }
+  printf("Outputs: %u, digest: %016llx\n",
+         sli_aoa_replay_output_count, (unsigned long long)sli_aoa_replay_digest_value);
+  return (sc == SL_STATUS_EMPTY) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+sl_status_t __wrap_aoa_cte_bt_on_event(sl_bt_msg_t *evt)
+{
+  uint64_t start_ns = sli_aoa_replay_now_ns();
+  sl_status_t sc = __real_aoa_cte_bt_on_event(evt);
+  sli_aoa_replay_add_latency(SLI_AOA_REPLAY_STAGE_CTE, start_ns);
+  return sc;
+}
+
+void __wrap_aoa_cte_on_iq_report(aoa_db_entry_t *tag, aoa_iq_report_t *iq_report)
+{
+  uint64_t start_ns = sli_aoa_replay_now_ns();
+  __real_aoa_cte_on_iq_report(tag, iq_report);
+  sli_aoa_replay_add_latency(SLI_AOA_REPLAY_STAGE_IQ_REPORT, start_ns);
+}
+
+enum sl_rtl_error_code __wrap_aoa_calculate(aoa_state_t *aoa_state,
+                                            aoa_iq_report_t *iq_report,
+                                            aoa_angle_t *angle,
+                                            aoa_id_t config_id)
+{
+  uint64_t start_ns = sli_aoa_replay_now_ns();
+  enum sl_rtl_error_code ec = __real_aoa_calculate(aoa_state, iq_report, angle, config_id);
+  sli_aoa_replay_add_latency(SLI_AOA_REPLAY_STAGE_ANGLE, start_ns);
+  return ec;
+}
+
+void sl_bt_aoa_on_iq_report(const sl_bt_aoa_locator_id_t *locator_id,
+                            const sl_bt_aoa_tag_id_t *tag_id,
+                            const aoa_iq_report_t *iq)
+{
+  (void)locator_id;
+  sli_aoa_replay_digest(tag_id->mac_addr, sizeof(tag_id->mac_addr));
+  sli_aoa_replay_digest(&iq->channel, sizeof(iq->channel));
+  sli_aoa_replay_digest(&iq->rssi, sizeof(iq->rssi));
+  sli_aoa_replay_digest(&iq->event_counter, sizeof(iq->event_counter));
+  sli_aoa_replay_digest(iq->samples, iq->length);
+  sli_aoa_replay_output_count++;
+  //the output is the end of the pipeline here
+  sl_latency_trace_mark(tag_id->system_id, iq->event_counter, SL_LATENCY_TRACE_STAGE_PUBLISH);
+}
+
+void sl_bt_aoa_on_angle_report(const sl_bt_aoa_locator_id_t *locator_id,
+                               const sl_bt_aoa_tag_id_t *tag_id,
+                               const aoa_angle_t *angle)
+{
+  //rounded, so the digest is not sensitive to the last bits of the floats
+  const int32_t values[] = {
+    (int32_t)lroundf(angle->azimuth * SLI_AOA_REPLAY_DIGEST_SCALE),
+    (int32_t)lroundf(angle->elevation * SLI_AOA_REPLAY_DIGEST_SCALE),
+    (int32_t)lroundf(angle->distance * SLI_AOA_REPLAY_DIGEST_SCALE),
+    angle->sequence
+  };
+
+  (void)locator_id;
+  sli_aoa_replay_digest(tag_id->mac_addr, sizeof(tag_id->mac_addr));
+  sli_aoa_replay_digest(values, sizeof(values));
+  sli_aoa_replay_output_count++;
+  sl_latency_trace_mark(tag_id->system_id, (uint16_t)angle->sequence, SL_LATENCY_TRACE_STAGE_PUBLISH);
+}
+
+static void sli_aoa_replay_usage(const char *name)
+{
+  printf("Usage: %s [-r <speed>] [-s <start>] [-t] <capture file>\n", name);
+  printf("  -r  Replay at the recorded rate multiplied by speed, default: as fast as possible\n");
+  printf("  -s  Start the replay at this many seconds into the capture\n");
+  printf("  -t  Print the latency trace of the last reports, debug builds only\n");
+}
+
+static uint64_t sli_aoa_replay_now_ns(void)
+{
+  struct timespec now;
+
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return ((uint64_t)now.tv_sec * 1000000000) + (uint64_t)now.tv_nsec;
+}
+
+static void sli_aoa_replay_add_latency(sli_aoa_replay_stage_t stage, uint64_t start_ns)
+{
+  sli_aoa_replay_latency_t *latency = &sli_aoa_replay_latency[stage];
+  uint64_t elapsed_ns = sli_aoa_replay_now_ns() - start_ns;
+
+  if (latency->count == latency->capacity) {
+    size_t capacity = (latency->capacity == 0) ? 4096 : (latency->capacity * 2);
+    uint32_t *samples = realloc(latency->samples, capacity * sizeof(*samples));
+    if (samples == NULL) {
+      return;
+    }
+    latency->samples = samples;
+    latency->capacity = capacity;
+  }
+  latency->samples[latency->count++] = (elapsed_ns > UINT32_MAX) ? UINT32_MAX : (uint32_t)elapsed_ns;
+}
+
+static void sli_aoa_replay_print_latency(void)
+{
+  static const double percentiles[] = { 50.0, 90.0, 99.0, 99.9 };
+
+  printf("%-10s %10s %10s %10s %10s %10s %10s\n",
+         "stage [us]", "count", "p50", "p90", "p99", "p99.9", "max");
+  for (size_t i = 0; i < SLI_AOA_REPLAY_STAGE_COUNT; i++) {
+    sli_aoa_replay_latency_t *latency = &sli_aoa_replay_latency[i];
+    printf("%-10s %10zu", latency->name, latency->count);
+    if (latency->count == 0) {
+      printf("\n");
+      continue;
+    }
+    qsort(latency->samples, latency->count, sizeof(*latency->samples), sli_aoa_replay_compare);
+    for (size_t p = 0; p < sizeof(percentiles) / sizeof(percentiles[0]); p++) {
+      //nearest rank
+      size_t rank = (size_t)ceil(percentiles[p] / 100.0 * (double)latency->count);
+      printf(" %10.2f", (double)latency->samples[(rank > 0) ? (rank - 1) : 0] / 1e3);
+    }
+    printf(" %10.2f\n", (double)latency->samples[latency->count - 1] / 1e3);
+    free(latency->samples);
+    latency->samples = NULL;
+  }
+}
+
+static int sli_aoa_replay_compare(const void *a, const void *b)
+{
+  uint32_t left = *(const uint32_t *)a;
+  uint32_t right = *(const uint32_t *)b;
+  return (left > right) - (left < right);
+}
+
+static void sli_aoa_replay_digest(const void *data, size_t size)
+{
+  const uint8_t *bytes = data;
+
+  for (size_t i = 0; i < size; i++) {
+    sli_aoa_replay_digest_value ^= bytes[i];
+    sli_aoa_replay_digest_value *= SLI_AOA_REPLAY_DIGEST_PRIME;
+  }
+}
+
+/**************************************************************************//**
+ * Every command is answered with SL_STATUS_OK and zeroed return values, the
+ * captured events drive the pipeline.
+ *****************************************************************************/
+static void sli_aoa_replay_ncp_write(uint32_t len, uint8_t *data)
+{
+  uint32_t header;
+
+  if (len < SL_BGAPI_MSG_HEADER_LEN) {
+    return;
+  }
+  memcpy(&header, data, sizeof(header));
+  //same message ID with a 2 byte payload holding the result
+  header = (header & 0xffff00f8) | (sizeof(uint16_t) << 8);
+  memcpy(sli_aoa_replay_response, &header, sizeof(header));
+  memset(&sli_aoa_replay_response[SL_BGAPI_MSG_HEADER_LEN], 0, sizeof(uint16_t));
+  sli_aoa_replay_response_length = sizeof(sli_aoa_replay_response);
+}
+
+static int32_t sli_aoa_replay_ncp_read(uint32_t len, uint8_t *data)
+{
+  if (len > sli_aoa_replay_response_length) {
+    return -1;
+  }
+  uint32_t offset = sizeof(sli_aoa_replay_response) - sli_aoa_replay_response_length;
+  memcpy(data, &sli_aoa_replay_response[offset], len);
+  sli_aoa_replay_response_length -= len;
+  return (int32_t)len;
+}
+
+static int32_t sli_aoa_replay_ncp_peek(void)
+{
+  return (int32_t)sli_aoa_replay_response_length;
+}
@@ -0,0 +1,219 @@
+/***************************************************************************//**
+ * @file
+ * @brief Copy versus borrow dispatch of the BGAPI event queue.
+ * @version 1.0.0
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2024 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * The licensor of this software is Silicon Laboratories Inc. Your use of this
+ * software is governed by the terms of Silicon Labs Master Software License
+ * Agreement (MSLA) available at
+ * www.silabs.com/about-us/legal/master-software-license-agreement. This
+ * software is distributed to you in Source Code format and is governed by the
+ * sections of the MSLA applicable to Source Code.
+ *
+ ******************************************************************************/
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "sl_bt_api.h"
+#include "sl_bt_ncp_host.h"
+
+//macros -----------------------------------------------------------------------
+#define SLI_BGAPI_EVENT_BENCH_DEFAULT_EVENTS  1000000
+///events in the input stream, replayed until the requested count is reached
+#define SLI_BGAPI_EVENT_BENCH_STREAM_EVENTS   256
+///4x4 URA IQ report, 8 reference and 4 x 16 antenna samples
+#define SLI_BGAPI_EVENT_BENCH_SAMPLES         (2 * (8 + 64))
+#define SLI_BGAPI_EVENT_BENCH_PAYLOAD         (offsetof(struct sl_bt_evt_cte_receiver_silabs_iq_report_s, samples.data) \
+                                               + SLI_BGAPI_EVENT_BENCH_SAMPLES)
+#define SLI_BGAPI_EVENT_BENCH_FRAME           (SL_BGAPI_MSG_HEADER_LEN + SLI_BGAPI_EVENT_BENCH_PAYLOAD)
+
+//private function prototypes --------------------------------------------------
+static void sli_bgapi_event_bench_usage(const char *name);
+static void sli_bgapi_event_bench_output(uint32_t len, uint8_t *data);
+static int32_t sli_bgapi_event_bench_input(uint32_t len, uint8_t *data);
+static int32_t sli_bgapi_event_bench_peek(void);
+static uint32_t sli_bgapi_event_bench_process(const sl_bt_msg_t *evt);
+static double sli_bgapi_event_bench_run(uint32_t count, sl_status_t (*dispatch)(void));
+static sl_status_t sli_bgapi_event_bench_copy(void);
+static sl_status_t sli_bgapi_event_bench_borrow(void);
+static double sli_bgapi_event_bench_now(void);
+
+//private variables ------------------------------------------------------------
+static uint8_t sli_stream[SLI_BGAPI_EVENT_BENCH_STREAM_EVENTS * SLI_BGAPI_EVENT_BENCH_FRAME];
+static size_t sli_stream_offset;
+static size_t sli_stream_left;
+///keeps the dispatched events from being optimized away
+static volatile uint32_t sli_sink;
+
+//function definitions----------------------------------------------------------
+int main(int argc, char *argv[])
+{
+  uint32_t count = SLI_BGAPI_EVENT_BENCH_DEFAULT_EVENTS;
+  double copy_ns;
+  double borrow_ns;
+  sl_status_t sc;
+  int opt;
+
+  while ((opt = getopt(argc, argv, "n:h")) != -1) {
+    switch (opt) {
+      case 'n':
+        count = (uint32_t)strtoul(optarg, NULL, 10);
+        break;
+      default:
+        sli_bgapi_event_bench_usage(argv[0]);
+        return (opt == 'h') ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+  }
+  if (count == 0) {
+    sli_bgapi_event_bench_usage(argv[0]);
+    return EXIT_FAILURE;
+  }
+
+  //Silabs IQ reports as the NCP sends them
+  for (uint32_t n = 0; n < SLI_BGAPI_EVENT_BENCH_STREAM_EVENTS; n++) {
+    uint8_t *frame = &sli_stream[n * SLI_BGAPI_EVENT_BENCH_FRAME];
+    struct sl_bt_evt_cte_receiver_silabs_iq_report_s report = {
+      .address = { .addr = { (uint8_t)n, 0x11, 0x22, 0x33, 0x44, 0x55 } },
+      .channel = (uint8_t)(n % 37),
+      .rssi = -60,
+      .packet_counter = (uint16_t)n,
+      .samples = { .len = SLI_BGAPI_EVENT_BENCH_SAMPLES }
+    };
+    uint32_t header = sl_bt_evt_cte_receiver_silabs_iq_report_id
+                      | ((uint32_t)(SLI_BGAPI_EVENT_BENCH_PAYLOAD & 0xff) << 8)
+                      | ((uint32_t)(SLI_BGAPI_EVENT_BENCH_PAYLOAD >> 8) & 0x7);
+
+    memcpy(frame, &header, SL_BGAPI_MSG_HEADER_LEN);
+    memcpy(&frame[SL_BGAPI_MSG_HEADER_LEN], &report, offsetof(struct sl_bt_evt_cte_receiver_silabs_iq_report_s, samples.data));
+    for (uint32_t k = 0; k < SLI_BGAPI_EVENT_BENCH_SAMPLES; k++) {
+      frame[SLI_BGAPI_EVENT_BENCH_FRAME - SLI_BGAPI_EVENT_BENCH_SAMPLES + k] = (uint8_t)(n + k);
+    }
+  }
+
+  sc = sl_bt_api_initialize_nonblock(sli_bgapi_event_bench_output,
+                                     sli_bgapi_event_bench_input,
+                                     sli_bgapi_event_bench_peek);
+  if (sc != SL_STATUS_OK) {
+    fprintf(stderr, "Failed to initialize BGAPI: 0x%04x\n", (unsigned)sc);
+    return EXIT_FAILURE;
+  }
+  if (sl_bt_release_event() != SL_STATUS_INVALID_STATE) {
+    fprintf(stderr, "Release without a borrowed event was accepted\n");
+    return EXIT_FAILURE;
+  }
+
+  copy_ns = sli_bgapi_event_bench_run(count, sli_bgapi_event_bench_copy);
+  borrow_ns = sli_bgapi_event_bench_run(count, sli_bgapi_event_bench_borrow);
+  if ((copy_ns < 0.0) || (borrow_ns < 0.0)) {
+    return EXIT_FAILURE;
+  }
+
+  printf("Events: %u Silabs IQ reports, %u byte payload, %zu byte sl_bt_msg_t\n",
+         count, (unsigned)SLI_BGAPI_EVENT_BENCH_PAYLOAD, sizeof(sl_bt_msg_t));
+  printf("ns per event (UART read, queue and dispatch)\n");
+  printf("copy      %10.1f\n", copy_ns);
+  printf("borrow    %10.1f\n", borrow_ns);
+  return EXIT_SUCCESS;
+}
+
+static void sli_bgapi_event_bench_usage(const char *name)
+{
+  printf("Usage: %s [options]\n", name);
+  printf("  -n  Number of dispatched events, default: %u\n", SLI_BGAPI_EVENT_BENCH_DEFAULT_EVENTS);
+}
+
+///dispatches count events, returns the time per event in ns or -1 on error
+static double sli_bgapi_event_bench_run(uint32_t count, sl_status_t (*dispatch)(void))
+{
+  double start = sli_bgapi_event_bench_now();
+
+  for (uint32_t n = 0; n < count; n++) {
+    if (sli_stream_left == 0) {
+      sli_stream_offset = 0;
+      sli_stream_left = sizeof(sli_stream);
+    }
+    sl_status_t sc = dispatch();
+    if (sc != SL_STATUS_OK) {
+      fprintf(stderr, "Dispatch failed at event %u: 0x%04x\n", n, (unsigned)sc);
+      return -1.0;
+    }
+  }
+  return (sli_bgapi_event_bench_now() - start) * 1e9 / (double)count;
+}
+
+///the dispatch before zero-copy, the event is copied out of the queue
+static sl_status_t sli_bgapi_event_bench_copy(void)
+{
+  sl_bt_msg_t evt;
+  sl_status_t sc = sl_bt_pop_event(&evt);
+
+  if (sc == SL_STATUS_OK) {
+    sli_sink = sli_bgapi_event_bench_process(&evt);
+  }
+  return sc;
+}
+
+///the dispatch of sl_bt_step(), the event is handled in its queue slot
+static sl_status_t sli_bgapi_event_bench_borrow(void)
+{
+  sl_bt_msg_t *evt;
+  sl_status_t sc = sl_bt_borrow_event(&evt);
+
+  if (sc == SL_STATUS_OK) {
+    sli_sink = sli_bgapi_event_bench_process(evt);
+    sc = sl_bt_release_event();
+  }
+  return sc;
+}
+
+///reads the fields an IQ report handler needs
+static uint32_t sli_bgapi_event_bench_process(const sl_bt_msg_t *evt)
+{
+  const struct sl_bt_evt_cte_receiver_silabs_iq_report_s *report = &evt->data.evt_cte_receiver_silabs_iq_report;
+  uint32_t sum = report->channel + (uint8_t)report->rssi + report->address.addr[0];
+
+  for (uint32_t k = 0; k < report->samples.len; k++) {
+    sum += report->samples.data[k];
+  }
+  return sum;
+}
+
+///commands are not sent by the benchmark
+static void sli_bgapi_event_bench_output(uint32_t len, uint8_t *data)
+{
+  (void)len;
+  (void)data;
+}
+
+///stands in for sl_ncp_host_com_read()
+static int32_t sli_bgapi_event_bench_input(uint32_t len, uint8_t *data)
+{
+  if (len > sli_stream_left) {
+    return -1;
+  }
+  memcpy(data, &sli_stream[sli_stream_offset], len);
+  sli_stream_offset += len;
+  sli_stream_left -= len;
+  return (int32_t)len;
+}
+
+static int32_t sli_bgapi_event_bench_peek(void)
+{
+  return (int32_t)sli_stream_left;
+}
+
+static double sli_bgapi_event_bench_now(void)
+{
+  struct timespec now;
+
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (double)now.tv_sec + ((double)now.tv_nsec * 1e-9);
+}
@@ -0,0 +1,52 @@
+/***************************************************************************//**
+ * @file
+ * @brief POSIX replacement of the emlib core API, there are no interrupts to mask.
+ * @version 1.0.0
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2024 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * The licensor of this software is Silicon Laboratories Inc. Your use of this
+ * software is governed by the terms of Silicon Labs Master Software License
+ * Agreement (MSLA) available at
+ * www.silabs.com/about-us/legal/master-software-license-agreement. This
+ * software is distributed to you in Source Code format and is governed by the
+ * sections of the MSLA applicable to Source Code.
+ *
+ ******************************************************************************/
+#ifndef EM_CORE_H
+#define EM_CORE_H
+#ifdef __cplusplus
+extern "C" {
+#endif
+#include <stdbool.h>
+#include <stdint.h>
+
+//macros -----------------------------------------------------------------------
+#define CORE_DECLARE_IRQ_STATE
+#define CORE_ENTER_ATOMIC()
+#define CORE_EXIT_ATOMIC()
+#define CORE_ENTER_CRITICAL()
+#define CORE_EXIT_CRITICAL()
+///CMSIS data memory barrier, the receive ring buffer is shared between threads
+#define __DMB() __atomic_thread_fence(__ATOMIC_SEQ_CST)
+
+//type definitions -------------------------------------------------------------
+typedef uint32_t CORE_irqState_t;
+
+//function prototypes ----------------------------------------------------------
+static inline CORE_irqState_t CORE_EnterAtomic(void)
+{
+  return 0;
+}
+
+static inline void CORE_ExitAtomic(CORE_irqState_t irqState)
+{
+  (void)irqState;
+}
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* EM_CORE_H */
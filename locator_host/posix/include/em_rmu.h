@@ -0,0 +1,37 @@
+/***************************************************************************//**
+ * @file
+ * @brief POSIX replacement of the emlib reset management unit API.
+ * @version 1.0.0
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2024 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * The licensor of this software is Silicon Laboratories Inc. Your use of this
+ * software is governed by the terms of Silicon Labs Master Software License
+ * Agreement (MSLA) available at
+ * www.silabs.com/about-us/legal/master-software-license-agreement. This
+ * software is distributed to you in Source Code format and is governed by the
+ * sections of the MSLA applicable to Source Code.
+ *
+ ******************************************************************************/
+#ifndef EM_RMU_H
+#define EM_RMU_H
+#ifdef __cplusplus
+extern "C" {
+#endif
+#include <stdint.h>
+
+//function prototypes ----------------------------------------------------------
+/***************************************************************************//**
+ * There is no reset cause on POSIX, the process was started.
+ ******************************************************************************/
+static inline uint32_t RMU_ResetCauseGet(void)
+{
+  return 0;
+}
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* EM_RMU_H */
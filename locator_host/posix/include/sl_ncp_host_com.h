@@ -0,0 +1,22 @@
+/***************************************************************************//**
+ * @file
+ * @brief POSIX replacement of the NCP host communication API.
+ * @version 1.0.0
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2024 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * The licensor of this software is Silicon Laboratories Inc. Your use of this
+ * software is governed by the terms of Silicon Labs Master Software License
+ * Agreement (MSLA) available at
+ * www.silabs.com/about-us/legal/master-software-license-agreement. This
+ * software is distributed to you in Source Code format and is governed by the
+ * sections of the MSLA applicable to Source Code.
+ *
+ ******************************************************************************/
+#ifndef SL_NCP_HOST_COM_H
+#define SL_NCP_HOST_COM_H
+//The interface is implemented over a serial device or a socket on POSIX.
+#include "sl_ncp_host_com_posix.h"
+#endif /* SL_NCP_HOST_COM_H */
@@ -0,0 +1,184 @@
+/***************************************************************************//**
+ * @file
+ * @brief Entry point of the POSIX locator host.
+ * @version 1.0.0
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2024 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * The licensor of this software is Silicon Laboratories Inc. Your use of this
+ * software is governed by the terms of Silicon Labs Master Software License
+ * Agreement (MSLA) available at
+ * www.silabs.com/about-us/legal/master-software-license-agreement. This
+ * software is distributed to you in Source Code format and is governed by the
+ * sections of the MSLA applicable to Source Code.
+ *
+ ******************************************************************************/
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "sl_bt_api.h"
+#include "sl_bt_ncp_host.h"
+#include "sl_bluetooth.h"
+#include "sl_bluetooth_host_config.h"
+#include "sl_ncp_host_com_posix.h"
+#include "aoa_capture.h"
+#include "app.h"
+#include "app_log.h"
+
+//macros -----------------------------------------------------------------------
+///Poll timeout when there is nothing to do
+#define SLI_MAIN_POSIX_IDLE_TIMEOUT_MS 100
+
+//private type definitions -----------------------------------------------------
+//private function prototypes --------------------------------------------------
+static void sli_main_posix_usage(const char *name);
+static void sli_main_posix_on_signal(int signal);
+static void sli_main_posix_bt_step(void);
+static void sli_main_posix_print_stats(void);
+
+//private variables ------------------------------------------------------------
+static volatile sig_atomic_t sli_main_posix_exit = 0;
+static aoa_capture_writer_t sli_main_posix_capture;
+
+//function definitions----------------------------------------------------------
+int main(int argc, char *argv[])
+{
+  const char *device = NULL;
+  char *tcp_host = NULL;
+  const char *capture_path = NULL;
+  uint32_t baudrate = SL_NCP_HOST_COM_POSIX_DEFAULT_BAUDRATE;
+  sl_status_t sc;
+  int opt;
+
+  while ((opt = getopt(argc, argv, "u:b:t:c:h")) != -1) {
+    switch (opt) {
+      case 'u':
+        device = optarg;
+        break;
+      case 'b':
+        baudrate = (uint32_t)strtoul(optarg, NULL, 10);
+        break;
+      case 't':
+        tcp_host = optarg;
+        break;
+      case 'c':
+        capture_path = optarg;
+        break;
+      default:
+        sli_main_posix_usage(argv[0]);
+        return (opt == 'h') ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+  }
+
+  if ((device == NULL) == (tcp_host == NULL)) {
+    sli_main_posix_usage(argv[0]);
+    return EXIT_FAILURE;
+  }
+
+  if (device != NULL) {
+    sc = sl_ncp_host_com_posix_open_serial(device, baudrate);
+  } else {
+    uint16_t port = SL_NCP_HOST_COM_POSIX_DEFAULT_TCP_PORT;
+    char *separator = strrchr(tcp_host, ':');
+    if (separator != NULL) {
+      *separator = '\0';
+      port = (uint16_t)strtoul(separator + 1, NULL, 10);
+    }
+    sc = sl_ncp_host_com_posix_open_tcp(tcp_host, port);
+  }
+  if (sc != SL_STATUS_OK) {
+    return EXIT_FAILURE;
+  }
+
+  if (capture_path != NULL) {
+    sc = aoa_capture_writer_open(&sli_main_posix_capture, capture_path);
+    if (sc != SL_STATUS_OK) {
+      app_log_error("Failed to create capture %s: 0x%04x" APP_LOG_NL, capture_path, (unsigned)sc);
+      sl_ncp_host_com_posix_close();
+      return EXIT_FAILURE;
+    }
+  }
+
+  signal(SIGINT, sli_main_posix_on_signal);
+  signal(SIGTERM, sli_main_posix_on_signal);
+
+  sl_ncp_host_com_init();
+  app_init();
+
+  while (!sli_main_posix_exit) {
+    app_publish_queue_stats_t stats;
+    app_publish_queue_get_stats(&stats);
+    bool publish_pending = (stats.enqueued - stats.dropped) != stats.published;
+
+    sc = sl_ncp_host_com_posix_wait(publish_pending ? 0 : SLI_MAIN_POSIX_IDLE_TIMEOUT_MS);
+    if (sc == SL_STATUS_FAIL) {
+      app_log_error("NCP connection lost" APP_LOG_NL);
+      break;
+    }
+    sli_main_posix_bt_step();
+    app_process_action();
+  }
+
+  sli_main_posix_print_stats();
+  if (sli_main_posix_capture.file != NULL) {
+    (void)aoa_capture_writer_close(&sli_main_posix_capture);
+  }
+  sl_ncp_host_com_posix_close();
+  return EXIT_SUCCESS;
+}
+
+static void sli_main_posix_usage(const char *name)
+{
+  printf("Usage: %s -u <serial device> [-b <baud rate>] | -t <host>[:<port>] [-c <capture file>]" APP_LOG_NL, name);
+  printf("  -u  Serial device or pty of the NCP, e.g. /dev/ttyACM0" APP_LOG_NL);
+  printf("  -b  Baud rate of the serial device, default: %u" APP_LOG_NL, SL_NCP_HOST_COM_POSIX_DEFAULT_BAUDRATE);
+  printf("  -t  TCP address of the NCP, default port: %u" APP_LOG_NL, SL_NCP_HOST_COM_POSIX_DEFAULT_TCP_PORT);
+  printf("  -c  Record the events of the AoA pipeline for locator_host_replay" APP_LOG_NL);
+}
+
+static void sli_main_posix_on_signal(int signal)
+{
+  (void)signal;
+  sli_main_posix_exit = 1;
+}
+
+/**************************************************************************//**
+ * Same as sl_bt_step() of the embedded target without the GATT handling.
+ *****************************************************************************/
+static void sli_main_posix_bt_step(void)
+{
+  sl_bt_msg_t *evt;
+
+  for (uint32_t i = 0; i < SL_BT_HOST_STEP_MAX_EVENTS; i++) {
+    if (sl_bt_borrow_event(&evt) != SL_STATUS_OK) {
+      return;
+    }
+    if ((sli_main_posix_capture.file != NULL) && aoa_capture_is_recorded(evt)) {
+      struct timespec now;
+      clock_gettime(CLOCK_MONOTONIC, &now);
+      if (aoa_capture_writer_write(&sli_main_posix_capture,
+                                   ((uint64_t)now.tv_sec * 1000000) + ((uint64_t)now.tv_nsec / 1000),
+                                   evt) != SL_STATUS_OK) {
+        app_log_error("Capture write failed, recording stopped" APP_LOG_NL);
+        (void)aoa_capture_writer_close(&sli_main_posix_capture);
+      }
+    }
+    sl_bt_on_event(evt);
+    sl_bt_release_event();
+  }
+}
+
+static void sli_main_posix_print_stats(void)
+{
+  app_publish_queue_stats_t stats;
+
+  app_publish_queue_get_stats(&stats);
+  printf("BGAPI events discarded: %u" APP_LOG_NL, sl_bt_get_discarded_event_count());
+  printf("Publish queue: enqueued %u, dropped %u, coalesced %u, published %u" APP_LOG_NL,
+         stats.enqueued, stats.dropped, stats.coalesced, stats.published);
+}
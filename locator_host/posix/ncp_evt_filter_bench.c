@@ -0,0 +1,333 @@
+/***************************************************************************//**
+ * @file
+ * @brief Content rules of the NCP event filter and its lookup time against
+ *        the number of filters.
+ * @version 1.0.0
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2024 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * The licensor of this software is Silicon Laboratories Inc. Your use of this
+ * software is governed by the terms of Silicon Labs Master Software License
+ * Agreement (MSLA) available at
+ * www.silabs.com/about-us/legal/master-software-license-agreement. This
+ * software is distributed to you in Source Code format and is governed by the
+ * sections of the MSLA applicable to Source Code.
+ *
+ ******************************************************************************/
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "sl_bt_api.h"
+#include "sl_ncp_evt_filter.h"
+#include "sl_ncp_evt_filter_common.h"
+#include "sl_ncp_evt_filter_config.h"
+
+//macros -----------------------------------------------------------------------
+#define SLI_NCP_EVT_FILTER_BENCH_DEFAULT_LOOKUPS 10000000
+///events looked up per round, half of them filtered
+#define SLI_NCP_EVT_FILTER_BENCH_STREAM          1024
+///BGAPI event header without the payload length
+#define SLI_NCP_EVT_FILTER_BENCH_ID(class, msg)  (((uint32_t)(msg) << 24) | ((uint32_t)(class) << 16) | 0xa0)
+///addresses in the first allowlist command, the ones after the unique ones are repeated
+#define SLI_NCP_EVT_FILTER_BENCH_BULK_COUNT      SL_NCP_EVT_FILTER_ADDRESS_MAX_COUNT
+#define SLI_NCP_EVT_FILTER_BENCH_BULK_UNIQUE     (SL_NCP_EVT_FILTER_ADDRESS_LIST_LENGTH - 2)
+///AD types of the flags and the complete list of 16-bit UUIDs
+#define SLI_NCP_EVT_FILTER_BENCH_AD_FLAGS        0x01
+#define SLI_NCP_EVT_FILTER_BENCH_AD_UUID16       0x03
+
+//private function prototypes --------------------------------------------------
+static void sli_ncp_evt_filter_bench_usage(const char *name);
+static bool sli_ncp_evt_filter_bench_check_content(void);
+static bool sli_ncp_evt_filter_bench_expect(bool condition, const char *what);
+static sl_status_t sli_ncp_evt_filter_bench_command(uint8_t id, const uint8_t *payload, uint8_t len);
+static void sli_ncp_evt_filter_bench_address(uint32_t n, uint8_t *address);
+static bool sli_ncp_evt_filter_bench_scan(uint32_t n, const uint8_t *ad, uint8_t size, uint8_t len);
+static bool sli_ncp_evt_filter_bench_iq(int8_t rssi);
+static bool sli_ncp_evt_filter_bench_add(uint32_t event);
+static bool sli_ncp_evt_filter_bench_linear(uint32_t event, uint32_t count);
+static double sli_ncp_evt_filter_bench_now(void);
+
+//private variables ------------------------------------------------------------
+///filtered events, the linear scan baseline searches the same list
+static uint32_t sli_filters[SL_NCP_EVT_FILTER_ARRAY_LENGTH];
+static uint32_t sli_stream[SLI_NCP_EVT_FILTER_BENCH_STREAM];
+static sl_status_t sli_response;
+static sl_bt_msg_t sli_evt;
+///keeps the timed loops from being optimized away
+static volatile uint32_t sli_sink;
+
+//function definitions----------------------------------------------------------
+int main(int argc, char *argv[])
+{
+  uint64_t lookups = SLI_NCP_EVT_FILTER_BENCH_DEFAULT_LOOKUPS;
+  uint64_t rounds;
+  uint32_t random_state = 1;
+  int opt;
+
+  while ((opt = getopt(argc, argv, "n:h")) != -1) {
+    switch (opt) {
+      case 'n':
+        lookups = strtoull(optarg, NULL, 10);
+        break;
+      default:
+        sli_ncp_evt_filter_bench_usage(argv[0]);
+        return (opt == 'h') ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+  }
+  rounds = lookups / SLI_NCP_EVT_FILTER_BENCH_STREAM;
+  if (rounds == 0) {
+    sli_ncp_evt_filter_bench_usage(argv[0]);
+    return EXIT_FAILURE;
+  }
+
+  if (!sli_ncp_evt_filter_bench_check_content()) {
+    return EXIT_FAILURE;
+  }
+  printf("Content rules: allowlist, AD match and minimum RSSI as expected\n");
+
+  //event ids in the BGAPI layout, 8 messages in each class
+  for (uint32_t n = 0; n < SL_NCP_EVT_FILTER_ARRAY_LENGTH; n++) {
+    sli_filters[n] = SLI_NCP_EVT_FILTER_BENCH_ID(n / 8, n % 8);
+  }
+
+  printf("Lookups: %llu, ns per lookup\n", (unsigned long long)(rounds * SLI_NCP_EVT_FILTER_BENCH_STREAM));
+  printf("filters       table      linear\n");
+  for (uint32_t count = 0; count <= SL_NCP_EVT_FILTER_ARRAY_LENGTH; count = (count == 0) ? 1 : 2 * count) {
+    uint32_t table_hits = 0;
+    uint32_t linear_hits = 0;
+    double start;
+    double table_ns;
+    double linear_ns;
+
+    //the stream hits the filtered events and misses on the rest evenly
+    for (uint32_t n = 0; n < SLI_NCP_EVT_FILTER_BENCH_STREAM; n++) {
+      random_state = (random_state * 1103515245U) + 12345U;
+      if ((count > 0) && (n % 2 == 0)) {
+        sli_stream[n] = sli_filters[(random_state >> 8) % count];
+      } else {
+        sli_stream[n] = SLI_NCP_EVT_FILTER_BENCH_ID(0x40 + ((random_state >> 8) % 32), (random_state >> 16) % 8);
+      }
+    }
+
+    user_cmd_manage_event_filter_t cmd = {
+      .hdr = { .len = SL_NCP_EVT_FILTER_CMD_RESET_LEN, .id = SL_NCP_EVT_FILTER_CMD_RESET_ID }
+    };
+    sl_ncp_evt_filter_handler(&cmd);
+    for (uint32_t n = 0; n < count; n++) {
+      if (!sli_ncp_evt_filter_bench_add(sli_filters[n])) {
+        fprintf(stderr, "Failed to add filter %u: 0x%04x\n", n, (unsigned)sli_response);
+        return EXIT_FAILURE;
+      }
+    }
+
+    start = sli_ncp_evt_filter_bench_now();
+    for (uint64_t r = 0; r < rounds; r++) {
+      for (uint32_t n = 0; n < SLI_NCP_EVT_FILTER_BENCH_STREAM; n++) {
+        table_hits += sl_ncp_evt_filter_is_filtered(sli_stream[n]);
+      }
+    }
+    table_ns = (sli_ncp_evt_filter_bench_now() - start) * 1e9;
+
+    start = sli_ncp_evt_filter_bench_now();
+    for (uint64_t r = 0; r < rounds; r++) {
+      for (uint32_t n = 0; n < SLI_NCP_EVT_FILTER_BENCH_STREAM; n++) {
+        linear_hits += sli_ncp_evt_filter_bench_linear(sli_stream[n], count);
+      }
+    }
+    linear_ns = (sli_ncp_evt_filter_bench_now() - start) * 1e9;
+
+    if (table_hits != linear_hits) {
+      fprintf(stderr, "Mismatch with %u filters: %u hits against %u\n", count, table_hits, linear_hits);
+      return EXIT_FAILURE;
+    }
+    sli_sink = table_hits;
+    printf("%7u  %10.2f  %10.2f\n", count,
+           table_ns / (double)(rounds * SLI_NCP_EVT_FILTER_BENCH_STREAM),
+           linear_ns / (double)(rounds * SLI_NCP_EVT_FILTER_BENCH_STREAM));
+  }
+
+  return EXIT_SUCCESS;
+}
+
+///response of the filter commands, the NCP sends it to the host
+void sl_bt_send_rsp_user_manage_event_filter(uint16_t result)
+{
+  sli_response = result;
+}
+
+static void sli_ncp_evt_filter_bench_usage(const char *name)
+{
+  printf("Usage: %s [options]\n", name);
+  printf("  -n  Number of timed lookups, default: %u\n", SLI_NCP_EVT_FILTER_BENCH_DEFAULT_LOOKUPS);
+}
+
+///the allowlist, AD match and minimum RSSI rules against hand-made events
+static bool sli_ncp_evt_filter_bench_check_content(void)
+{
+  uint8_t addresses[SLI_NCP_EVT_FILTER_BENCH_BULK_COUNT * SL_NCP_EVT_FILTER_ADDRESS_LEN];
+  uint8_t rule[] = { SLI_NCP_EVT_FILTER_BENCH_AD_UUID16, 0x0f, 0x18 };
+  int8_t min_rssi;
+  bool ok = true;
+
+  //the first command fills all but two entries, the repeated addresses are stored once
+  for (uint32_t n = 0; n < SLI_NCP_EVT_FILTER_BENCH_BULK_COUNT; n++) {
+    sli_ncp_evt_filter_bench_address(n % SLI_NCP_EVT_FILTER_BENCH_BULK_UNIQUE,
+                                     &addresses[n * SL_NCP_EVT_FILTER_ADDRESS_LEN]);
+  }
+  ok &= sli_ncp_evt_filter_bench_expect(
+    sli_ncp_evt_filter_bench_command(SL_NCP_EVT_FILTER_CMD_ADD_ADDRESS_ID, addresses, sizeof(addresses)) == SL_STATUS_OK,
+    "bulk add with repeated addresses");
+  //the second one only fits in part, the addresses before the overflow are kept
+  for (uint32_t n = 0; n < 4; n++) {
+    sli_ncp_evt_filter_bench_address(SLI_NCP_EVT_FILTER_BENCH_BULK_UNIQUE + n,
+                                     &addresses[n * SL_NCP_EVT_FILTER_ADDRESS_LEN]);
+  }
+  ok &= sli_ncp_evt_filter_bench_expect(
+    sli_ncp_evt_filter_bench_command(SL_NCP_EVT_FILTER_CMD_ADD_ADDRESS_ID, addresses, 4 * SL_NCP_EVT_FILTER_ADDRESS_LEN) == SL_STATUS_FULL,
+    "overflowing add is SL_STATUS_FULL");
+  for (uint32_t n = 0; n < SL_NCP_EVT_FILTER_ADDRESS_LIST_LENGTH; n++) {
+    ok &= sli_ncp_evt_filter_bench_expect(!sli_ncp_evt_filter_bench_scan(n, NULL, 0, 0), "allowlisted address kept");
+  }
+  ok &= sli_ncp_evt_filter_bench_expect(sli_ncp_evt_filter_bench_scan(SL_NCP_EVT_FILTER_ADDRESS_LIST_LENGTH, NULL, 0, 0),
+                                        "address beyond the overflow dropped");
+  ok &= sli_ncp_evt_filter_bench_expect(sli_ncp_evt_filter_bench_scan(1000, NULL, 0, 0), "other address dropped");
+  (void)sli_ncp_evt_filter_bench_command(SL_NCP_EVT_FILTER_CMD_RESET_ADDRESS_ID, NULL, 0);
+  ok &= sli_ncp_evt_filter_bench_expect(!sli_ncp_evt_filter_bench_scan(1000, NULL, 0, 0), "empty allowlist lets through");
+
+  //Battery Service UUID 0x180f in the 16-bit UUID lists
+  ok &= sli_ncp_evt_filter_bench_expect(
+    sli_ncp_evt_filter_bench_command(SL_NCP_EVT_FILTER_CMD_ADD_AD_MATCH_ID, rule, sizeof(rule)) == SL_STATUS_OK,
+    "AD match rule added");
+  {
+    const uint8_t middle[] = { 0x02, SLI_NCP_EVT_FILTER_BENCH_AD_FLAGS, 0x06,
+                               0x07, SLI_NCP_EVT_FILTER_BENCH_AD_UUID16, 0x0a, 0x18, 0x0f, 0x18, 0x0d, 0x18 };
+    ok &= sli_ncp_evt_filter_bench_expect(!sli_ncp_evt_filter_bench_scan(0, middle, sizeof(middle), sizeof(middle)),
+                                          "UUID in the middle of the list matched");
+  }
+  {
+    const uint8_t misaligned[] = { 0x05, SLI_NCP_EVT_FILTER_BENCH_AD_UUID16, 0x0a, 0x0f, 0x18, 0x0d };
+    ok &= sli_ncp_evt_filter_bench_expect(sli_ncp_evt_filter_bench_scan(0, misaligned, sizeof(misaligned), sizeof(misaligned)),
+                                          "UUID bytes across two UUIDs not matched");
+  }
+  {
+    //the structure claims 9 bytes, the UUID after the end of the data is not read
+    const uint8_t past_end[] = { 0x09, SLI_NCP_EVT_FILTER_BENCH_AD_UUID16, 0x0a, 0x18, 0x0f, 0x18 };
+    ok &= sli_ncp_evt_filter_bench_expect(sli_ncp_evt_filter_bench_scan(0, past_end, sizeof(past_end), 4),
+                                          "UUID past the end of the data not matched");
+    ok &= sli_ncp_evt_filter_bench_expect(!sli_ncp_evt_filter_bench_scan(0, past_end, sizeof(past_end), sizeof(past_end)),
+                                          "UUID of a structure cut by the data end matched");
+  }
+  {
+    const uint8_t terminated[] = { 0x02, SLI_NCP_EVT_FILTER_BENCH_AD_FLAGS, 0x06, 0x00,
+                                   0x03, SLI_NCP_EVT_FILTER_BENCH_AD_UUID16, 0x0f, 0x18 };
+    ok &= sli_ncp_evt_filter_bench_expect(sli_ncp_evt_filter_bench_scan(0, terminated, sizeof(terminated), sizeof(terminated)),
+                                          "UUID after a zero length terminator not matched");
+  }
+  (void)sli_ncp_evt_filter_bench_command(SL_NCP_EVT_FILTER_CMD_RESET_AD_MATCH_ID, NULL, 0);
+  ok &= sli_ncp_evt_filter_bench_expect(!sli_ncp_evt_filter_bench_scan(0, NULL, 0, 0), "no AD match rule lets through");
+
+  //-128 is the floor, it disables the check
+  min_rssi = SL_NCP_EVT_FILTER_MIN_RSSI_DISABLED;
+  (void)sli_ncp_evt_filter_bench_command(SL_NCP_EVT_FILTER_CMD_SET_MIN_RSSI_ID, (const uint8_t *)&min_rssi, 1);
+  ok &= sli_ncp_evt_filter_bench_expect(!sli_ncp_evt_filter_bench_iq(-128), "-128 dBm passes the disabled floor");
+  min_rssi = -127;
+  (void)sli_ncp_evt_filter_bench_command(SL_NCP_EVT_FILTER_CMD_SET_MIN_RSSI_ID, (const uint8_t *)&min_rssi, 1);
+  ok &= sli_ncp_evt_filter_bench_expect(sli_ncp_evt_filter_bench_iq(-128), "-128 dBm below a -127 dBm floor dropped");
+  ok &= sli_ncp_evt_filter_bench_expect(!sli_ncp_evt_filter_bench_iq(-127), "-127 dBm at a -127 dBm floor kept");
+  min_rssi = SL_NCP_EVT_FILTER_MIN_RSSI_DISABLED;
+  (void)sli_ncp_evt_filter_bench_command(SL_NCP_EVT_FILTER_CMD_SET_MIN_RSSI_ID, (const uint8_t *)&min_rssi, 1);
+
+  return ok;
+}
+
+static bool sli_ncp_evt_filter_bench_expect(bool condition, const char *what)
+{
+  if (!condition) {
+    fprintf(stderr, "Content rule check failed: %s\n", what);
+  }
+  return condition;
+}
+
+static sl_status_t sli_ncp_evt_filter_bench_command(uint8_t id, const uint8_t *payload, uint8_t len)
+{
+  user_cmd_manage_event_filter_t cmd = {
+    .hdr = { .len = 1 + len, .id = id }
+  };
+
+  if (len > 0) {
+    memcpy(cmd.payload, payload, len);
+  }
+  sl_ncp_evt_filter_handler(&cmd);
+  return sli_response;
+}
+
+///spread over the bytes, so that the sorted order differs from the order of n
+static void sli_ncp_evt_filter_bench_address(uint32_t n, uint8_t *address)
+{
+  address[0] = (uint8_t)(n * 37);
+  address[1] = (uint8_t)n;
+  address[2] = (uint8_t)(n >> 8);
+  address[3] = 0x5a;
+  address[4] = (uint8_t)(n * 11);
+  address[5] = 0xc0;
+}
+
+///true if a legacy scan report of address n with size bytes of AD, len of them reported, is dropped
+static bool sli_ncp_evt_filter_bench_scan(uint32_t n, const uint8_t *ad, uint8_t size, uint8_t len)
+{
+  sl_bt_evt_scanner_legacy_advertisement_report_t *report = &sli_evt.data.evt_scanner_legacy_advertisement_report;
+
+  memset(&sli_evt, 0, sizeof(sli_evt));
+  sli_evt.header = sl_bt_evt_scanner_legacy_advertisement_report_id;
+  sli_ncp_evt_filter_bench_address(n, report->address.addr);
+  if (size > 0) {
+    memcpy(report->data.data, ad, size);
+  }
+  report->data.len = len;
+  return sl_ncp_evt_filter_is_content_filtered(&sli_evt);
+}
+
+///true if a connectionless IQ report of the given RSSI is dropped
+static bool sli_ncp_evt_filter_bench_iq(int8_t rssi)
+{
+  memset(&sli_evt, 0, sizeof(sli_evt));
+  sli_evt.header = sl_bt_evt_cte_receiver_connectionless_iq_report_id;
+  sli_evt.data.evt_cte_receiver_connectionless_iq_report.rssi = rssi;
+  return sl_ncp_evt_filter_is_content_filtered(&sli_evt);
+}
+
+static bool sli_ncp_evt_filter_bench_add(uint32_t event)
+{
+  user_cmd_manage_event_filter_t cmd = {
+    .hdr = { .len = SL_NCP_EVT_FILTER_CMD_ADD_LEN, .id = SL_NCP_EVT_FILTER_CMD_ADD_ID },
+    .evt = event
+  };
+
+  sl_ncp_evt_filter_handler(&cmd);
+  return sli_response == SL_STATUS_OK;
+}
+
+///the lookup before the hash table, a scan over the filtered events
+static bool sli_ncp_evt_filter_bench_linear(uint32_t event, uint32_t count)
+{
+  for (uint32_t n = 0; n < count; n++) {
+    if (sli_filters[n] == event) {
+      return true;
+    }
+  }
+  return false;
+}
+
+static double sli_ncp_evt_filter_bench_now(void)
+{
+  struct timespec now;
+
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (double)now.tv_sec + ((double)now.tv_nsec * 1e-9);
+}
@@ -0,0 +1,217 @@
+/***************************************************************************//**
+ * @file
+ * @brief Stress test of the NCP host UART receive ring buffer.
+ * @version 1.0.0
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2024 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * The licensor of this software is Silicon Laboratories Inc. Your use of this
+ * software is governed by the terms of Silicon Labs Master Software License
+ * Agreement (MSLA) available at
+ * www.silabs.com/about-us/legal/master-software-license-agreement. This
+ * software is distributed to you in Source Code format and is governed by the
+ * sections of the MSLA applicable to Source Code.
+ *
+ ******************************************************************************/
+#include <pthread.h>
+#include <sched.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "sl_simple_com.h"
+#include "sl_ncp_host_com.h"
+#include "sl_ncp_host_com_config.h"
+
+//macros -----------------------------------------------------------------------
+#define SLI_NCP_HOST_COM_STRESS_DEFAULT_FRAMES 1000000
+#define SLI_NCP_HOST_COM_STRESS_DEFAULT_SEED   1
+///BGAPI header length and the largest payload of an event
+#define SLI_NCP_HOST_COM_STRESS_HEADER_LEN     4
+#define SLI_NCP_HOST_COM_STRESS_MAX_PAYLOAD    255
+///largest block handed over by one UART DMA receive callback
+#define SLI_NCP_HOST_COM_STRESS_MAX_FRAGMENT   256
+#define SLI_NCP_HOST_COM_STRESS_MAX_FRAME      (SLI_NCP_HOST_COM_STRESS_HEADER_LEN + SLI_NCP_HOST_COM_STRESS_MAX_PAYLOAD)
+
+//private type definitions -----------------------------------------------------
+typedef struct {
+  uint32_t frames;
+  uint32_t seed;
+} sli_ncp_host_com_stress_config_t;
+
+//private function prototypes --------------------------------------------------
+static void sli_ncp_host_com_stress_usage(const char *name);
+static void *sli_ncp_host_com_stress_producer(void *arg);
+static size_t sli_ncp_host_com_stress_frame(uint32_t seed, uint32_t n, uint8_t *frame);
+static uint32_t sli_ncp_host_com_stress_random(uint32_t *state);
+static void sli_ncp_host_com_stress_read(uint32_t len, uint8_t *data);
+
+//function definitions----------------------------------------------------------
+int main(int argc, char *argv[])
+{
+  sli_ncp_host_com_stress_config_t config = {
+    .frames = SLI_NCP_HOST_COM_STRESS_DEFAULT_FRAMES,
+    .seed = SLI_NCP_HOST_COM_STRESS_DEFAULT_SEED
+  };
+  uint8_t expected[SLI_NCP_HOST_COM_STRESS_MAX_FRAME];
+  uint8_t received[SLI_NCP_HOST_COM_STRESS_MAX_FRAME];
+  uint64_t bytes = 0;
+  pthread_t producer;
+  int opt;
+
+  while ((opt = getopt(argc, argv, "n:S:h")) != -1) {
+    switch (opt) {
+      case 'n':
+        config.frames = (uint32_t)strtoul(optarg, NULL, 10);
+        break;
+      case 'S':
+        config.seed = (uint32_t)strtoul(optarg, NULL, 0);
+        break;
+      default:
+        sli_ncp_host_com_stress_usage(argv[0]);
+        return (opt == 'h') ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+  }
+  if ((config.frames == 0) || (config.seed == 0)) {
+    sli_ncp_host_com_stress_usage(argv[0]);
+    return EXIT_FAILURE;
+  }
+
+  sl_ncp_host_com_init();
+  if (pthread_create(&producer, NULL, sli_ncp_host_com_stress_producer, &config) != 0) {
+    fprintf(stderr, "Failed to start the producer thread\n");
+    return EXIT_FAILURE;
+  }
+
+  //reads the frames the way sli_wait_for_bgapi_message() does, header first
+  for (uint32_t n = 0; n < config.frames; n++) {
+    size_t len = sli_ncp_host_com_stress_frame(config.seed, n, expected);
+    uint32_t payload;
+
+    sli_ncp_host_com_stress_read(SLI_NCP_HOST_COM_STRESS_HEADER_LEN, received);
+    payload = received[1] | ((uint32_t)(received[0] & 0x07) << 8);
+    if ((payload + SLI_NCP_HOST_COM_STRESS_HEADER_LEN) != len) {
+      fprintf(stderr, "Frame %u: payload length %u, expected %zu\n",
+              n, payload, len - SLI_NCP_HOST_COM_STRESS_HEADER_LEN);
+      return EXIT_FAILURE;
+    }
+    sli_ncp_host_com_stress_read(payload, &received[SLI_NCP_HOST_COM_STRESS_HEADER_LEN]);
+    if (memcmp(received, expected, len) != 0) {
+      fprintf(stderr, "Frame %u differs\n", n);
+      return EXIT_FAILURE;
+    }
+    bytes += len;
+  }
+
+  pthread_join(producer, NULL);
+  if (sl_ncp_host_com_peek() != 0) {
+    fprintf(stderr, "%d bytes left in the ring buffer\n", sl_ncp_host_com_peek());
+    return EXIT_FAILURE;
+  }
+  printf("Frames: %u, %llu bytes through a %u byte ring buffer, all byte-exact\n",
+         config.frames, (unsigned long long)bytes, (unsigned)SL_NCP_HOST_COM_BUF_SIZE);
+  return EXIT_SUCCESS;
+}
+
+static void sli_ncp_host_com_stress_usage(const char *name)
+{
+  printf("Usage: %s [options]\n", name);
+  printf("  -n  Number of BGAPI frames, default: %u\n", SLI_NCP_HOST_COM_STRESS_DEFAULT_FRAMES);
+  printf("  -S  Seed of the frame contents and the fragment sizes, default: %u\n",
+         SLI_NCP_HOST_COM_STRESS_DEFAULT_SEED);
+}
+
+///stands in for the UART DMA, delivers the byte stream in random fragments
+static void *sli_ncp_host_com_stress_producer(void *arg)
+{
+  const sli_ncp_host_com_stress_config_t *config = arg;
+  uint8_t frame[SLI_NCP_HOST_COM_STRESS_MAX_FRAME];
+  uint32_t random_state = ~config->seed;
+  size_t len = 0;
+  size_t sent = 0;
+  uint32_t n = 0;
+
+  while ((n < config->frames) || (sent < len)) {
+    uint32_t fragment = 1 + (sli_ncp_host_com_stress_random(&random_state) % SLI_NCP_HOST_COM_STRESS_MAX_FRAGMENT);
+    uint8_t block[SLI_NCP_HOST_COM_STRESS_MAX_FRAGMENT];
+    uint32_t filled = 0;
+
+    //a fragment may end in the middle of a frame or span several frames
+    while ((filled < fragment) && ((n < config->frames) || (sent < len))) {
+      if (sent == len) {
+        len = sli_ncp_host_com_stress_frame(config->seed, n++, frame);
+        sent = 0;
+      }
+      size_t chunk = len - sent;
+      if (chunk > fragment - filled) {
+        chunk = fragment - filled;
+      }
+      memcpy(&block[filled], &frame[sent], chunk);
+      filled += (uint32_t)chunk;
+      sent += chunk;
+    }
+
+    //the receive callback drops a fragment that does not fit, wait for room
+    while ((uint32_t)(SL_NCP_HOST_COM_BUF_SIZE - sl_ncp_host_com_peek()) < filled) {
+      sched_yield();
+    }
+    sl_simple_com_receive_cb(SL_STATUS_OK, filled, block);
+  }
+  return NULL;
+}
+
+///IQ report sized events with contents derived from the frame number
+static size_t sli_ncp_host_com_stress_frame(uint32_t seed, uint32_t n, uint8_t *frame)
+{
+  uint32_t random_state = (seed * 2654435761U) ^ (n + 1);
+  uint32_t payload = sli_ncp_host_com_stress_random(&random_state) % (SLI_NCP_HOST_COM_STRESS_MAX_PAYLOAD + 1);
+
+  frame[0] = 0xa0;
+  frame[1] = (uint8_t)payload;
+  frame[2] = 0x45;
+  frame[3] = 0x06;
+  for (uint32_t k = 0; k < payload; k++) {
+    frame[SLI_NCP_HOST_COM_STRESS_HEADER_LEN + k] = (uint8_t)sli_ncp_host_com_stress_random(&random_state);
+  }
+  return SLI_NCP_HOST_COM_STRESS_HEADER_LEN + payload;
+}
+
+///xorshift32
+static uint32_t sli_ncp_host_com_stress_random(uint32_t *state)
+{
+  uint32_t x = (*state != 0) ? *state : 1;
+
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+  *state = x;
+  return x;
+}
+
+///polls until the bytes have arrived, like the non-blocking BGAPI reader
+static void sli_ncp_host_com_stress_read(uint32_t len, uint8_t *data)
+{
+  while (sl_ncp_host_com_read(len, data) < 0) {
+    sched_yield();
+  }
+}
+
+///the ring buffer is exercised without a UART behind it
+void sl_simple_com_transmit(uint32_t len, const uint8_t *data)
+{
+  (void)len;
+  (void)data;
+  sl_simple_com_transmit_cb(SL_STATUS_OK);
+}
+
+void sl_simple_com_step(void)
+{
+}
+
+void sl_simple_com_receive(void)
+{
+}
@@ -0,0 +1,57 @@
+/***************************************************************************//**
+ * @file
+ * @brief POSIX replacement of the application timer used by the NCP application.
+ * @version 1.0.0
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2024 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * The licensor of this software is Silicon Laboratories Inc. Your use of this
+ * software is governed by the terms of Silicon Labs Master Software License
+ * Agreement (MSLA) available at
+ * www.silabs.com/about-us/legal/master-software-license-agreement. This
+ * software is distributed to you in Source Code format and is governed by the
+ * sections of the MSLA applicable to Source Code.
+ *
+ ******************************************************************************/
+#ifndef APP_TIMER_H
+#define APP_TIMER_H
+#ifdef __cplusplus
+extern "C" {
+#endif
+#include <stdbool.h>
+#include <stdint.h>
+#include "sl_status.h"
+
+//type definitions -------------------------------------------------------------
+typedef struct app_timer app_timer_t;
+
+///Timer callback.
+typedef void (*app_timer_callback_t)(app_timer_t *timer, void *data);
+
+///Timer, the host side check only keeps the callback.
+struct app_timer {
+  app_timer_callback_t callback; ///< Callback of the running timer
+  void *callback_data; ///< Data passed to the callback
+};
+
+//function prototypes ----------------------------------------------------------
+/***************************************************************************//**
+ * Starts a timer, implemented by the host side check.
+ ******************************************************************************/
+sl_status_t app_timer_start(app_timer_t *timer,
+                            uint32_t timeout_ms,
+                            app_timer_callback_t callback,
+                            void *callback_data,
+                            bool is_periodic);
+
+/***************************************************************************//**
+ * Stops a timer, implemented by the host side check.
+ ******************************************************************************/
+sl_status_t app_timer_stop(app_timer_t *timer);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* APP_TIMER_H */
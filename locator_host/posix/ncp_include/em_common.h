@@ -0,0 +1,28 @@
+/***************************************************************************//**
+ * @file
+ * @brief POSIX replacement of the emlib common definitions for the NCP application.
+ * @version 1.0.0
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2024 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * The licensor of this software is Silicon Laboratories Inc. Your use of this
+ * software is governed by the terms of Silicon Labs Master Software License
+ * Agreement (MSLA) available at
+ * www.silabs.com/about-us/legal/master-software-license-agreement. This
+ * software is distributed to you in Source Code format and is governed by the
+ * sections of the MSLA applicable to Source Code.
+ *
+ ******************************************************************************/
+#ifndef EM_COMMON_H
+#define EM_COMMON_H
+#ifdef __cplusplus
+extern "C" {
+#endif
+#include "sl_common.h"
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* EM_COMMON_H */
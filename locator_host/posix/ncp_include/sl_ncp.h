@@ -0,0 +1,54 @@
+/***************************************************************************//**
+ * @file
+ * @brief POSIX replacement of the NCP interface used by the NCP application.
+ * @version 1.0.0
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2024 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * The licensor of this software is Silicon Laboratories Inc. Your use of this
+ * software is governed by the terms of Silicon Labs Master Software License
+ * Agreement (MSLA) available at
+ * www.silabs.com/about-us/legal/master-software-license-agreement. This
+ * software is distributed to you in Source Code format and is governed by the
+ * sections of the MSLA applicable to Source Code.
+ *
+ ******************************************************************************/
+#ifndef SL_NCP_H
+#define SL_NCP_H
+#ifdef __cplusplus
+extern "C" {
+#endif
+#include <stdbool.h>
+#include <stdint.h>
+#include "sl_status.h"
+#include "sl_bt_api.h"
+
+//function prototypes ----------------------------------------------------------
+/***************************************************************************//**
+ * Local event processor, implemented by the NCP application.
+ ******************************************************************************/
+bool sl_ncp_local_evt_process(sl_bt_msg_t *evt);
+
+/***************************************************************************//**
+ * User command handler, implemented by the NCP application.
+ ******************************************************************************/
+void sl_ncp_user_cmd_message_to_target_cb(void *data);
+
+/***************************************************************************//**
+ * Response of a user command, implemented by the host side check.
+ ******************************************************************************/
+void sl_ncp_user_cmd_message_to_target_rsp(sl_status_t result,
+                                           uint8_t len,
+                                           uint8_t *data);
+
+/***************************************************************************//**
+ * User event to the host, implemented by the host side check.
+ ******************************************************************************/
+void sl_ncp_user_evt_message_to_host(uint8_t len, uint8_t *data);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* SL_NCP_H */
@@ -0,0 +1,313 @@
+/***************************************************************************//**
+ * @file
+ * @brief IQ report rate limit of the NCP application against simulated tags.
+ * @version 1.0.0
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2024 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * The licensor of this software is Silicon Laboratories Inc. Your use of this
+ * software is governed by the terms of Silicon Labs Master Software License
+ * Agreement (MSLA) available at
+ * www.silabs.com/about-us/legal/master-software-license-agreement. This
+ * software is distributed to you in Source Code format and is governed by the
+ * sections of the MSLA applicable to Source Code.
+ *
+ ******************************************************************************/
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "sl_ncp.h"
+#include "sl_sleeptimer.h"
+#include "app_timer.h"
+#include "app.h"
+
+//macros -----------------------------------------------------------------------
+///rate of the LF clock of the sleeptimer on the NCP
+#define SLI_NCP_IQ_RATE_CHECK_TIMER_FREQUENCY 32768
+#define SLI_NCP_IQ_RATE_CHECK_DEFAULT_SECONDS 10
+#define SLI_NCP_IQ_RATE_CHECK_DATA_CHANNELS   37
+///reports saved up by a silent tag, IQ_DECIMATION_BURST of app.c
+#define SLI_NCP_IQ_RATE_CHECK_BURST           2
+#define SLI_NCP_IQ_RATE_CHECK_CHANNELS        40
+///distinct channels expected in the first round of kept reports of a fast tag,
+///every fifth report of the random channels would cover about 23 of the 37
+#define SLI_NCP_IQ_RATE_CHECK_MIN_FIRST_ROUND 27
+
+//private type definitions -----------------------------------------------------
+///Reports of one simulated tag.
+typedef struct {
+  uint32_t sent;
+  uint32_t kept;
+  uint32_t channels[SLI_NCP_IQ_RATE_CHECK_CHANNELS]; ///< kept reports on each channel
+  uint32_t first_round; ///< distinct channels of the first SLI_NCP_IQ_RATE_CHECK_DATA_CHANNELS kept reports
+} sli_ncp_iq_rate_check_result_t;
+
+//private function prototypes --------------------------------------------------
+static void sli_ncp_iq_rate_check_usage(const char *name);
+static sl_status_t sli_ncp_iq_rate_check_set_rate(uint8_t tag, uint16_t max_rate);
+static void sli_ncp_iq_rate_check_run(uint8_t tag,
+                                      uint32_t hz,
+                                      uint32_t seconds,
+                                      bool advertising_channels,
+                                      sli_ncp_iq_rate_check_result_t *result);
+static uint32_t sli_ncp_iq_rate_check_spread(const sli_ncp_iq_rate_check_result_t *result,
+                                             uint32_t *min,
+                                             uint32_t *max);
+static bool sli_ncp_iq_rate_check_kept(const sli_ncp_iq_rate_check_result_t *result,
+                                       uint16_t max_rate,
+                                       uint32_t seconds);
+static bool sli_ncp_iq_rate_check_expect(bool condition, const char *what);
+static uint32_t sli_ncp_iq_rate_check_random(uint32_t *state);
+
+//private variables ------------------------------------------------------------
+///the sleeptimer of the NCP, advanced by the simulated reports
+static uint32_t sli_tick;
+static uint32_t sli_random_state = 1;
+static sl_status_t sli_response;
+static uint32_t sli_stats_events;
+
+//function definitions----------------------------------------------------------
+int main(int argc, char *argv[])
+{
+  uint32_t seconds = SLI_NCP_IQ_RATE_CHECK_DEFAULT_SECONDS;
+  sli_ncp_iq_rate_check_result_t result;
+  uint32_t distinct;
+  uint32_t min;
+  uint32_t max;
+  bool ok = true;
+  int opt;
+
+  while ((opt = getopt(argc, argv, "t:h")) != -1) {
+    switch (opt) {
+      case 't':
+        seconds = (uint32_t)strtoul(optarg, NULL, 10);
+        break;
+      default:
+        sli_ncp_iq_rate_check_usage(argv[0]);
+        return (opt == 'h') ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+  }
+  if (seconds == 0) {
+    sli_ncp_iq_rate_check_usage(argv[0]);
+    return EXIT_FAILURE;
+  }
+
+  //no limit, every report is forwarded
+  sli_ncp_iq_rate_check_run(1, 50, seconds, false, &result);
+  printf("no limit, 50 Hz tag:        kept %u of %u\n", result.kept, result.sent);
+  ok &= sli_ncp_iq_rate_check_expect(result.kept == result.sent, "unlimited tag thinned");
+
+  ok &= sli_ncp_iq_rate_check_expect(sli_ncp_iq_rate_check_set_rate(0xff, 10) == SL_STATUS_OK, "global limit refused");
+
+  //five times the limit, the reports kept spread over the data channels
+  sli_ncp_iq_rate_check_run(2, 50, seconds, false, &result);
+  distinct = sli_ncp_iq_rate_check_spread(&result, &min, &max);
+  printf("10/s limit, 50 Hz tag:      kept %u of %u on %u channels, %u to %u each, %u in the first %u\n",
+         result.kept, result.sent, distinct, min, max, result.first_round, SLI_NCP_IQ_RATE_CHECK_DATA_CHANNELS);
+  ok &= sli_ncp_iq_rate_check_expect(sli_ncp_iq_rate_check_kept(&result, 10, seconds), "kept count of the 50 Hz tag");
+  ok &= sli_ncp_iq_rate_check_expect((result.kept < 2 * SLI_NCP_IQ_RATE_CHECK_DATA_CHANNELS)
+                                     || (distinct == SLI_NCP_IQ_RATE_CHECK_DATA_CHANNELS),
+                                     "channels of the 50 Hz tag");
+  ok &= sli_ncp_iq_rate_check_expect((result.kept < SLI_NCP_IQ_RATE_CHECK_DATA_CHANNELS)
+                                     || (result.first_round >= SLI_NCP_IQ_RATE_CHECK_MIN_FIRST_ROUND),
+                                     "channel spread of the 50 Hz tag");
+
+  //ten times the limit on the three advertising channels
+  sli_ncp_iq_rate_check_run(3, 100, seconds, true, &result);
+  distinct = sli_ncp_iq_rate_check_spread(&result, &min, &max);
+  printf("10/s limit, 100 Hz tag:     kept %u of %u on %u channels, %u to %u each\n",
+         result.kept, result.sent, distinct, min, max);
+  ok &= sli_ncp_iq_rate_check_expect(sli_ncp_iq_rate_check_kept(&result, 10, seconds), "kept count of the 100 Hz tag");
+  ok &= sli_ncp_iq_rate_check_expect((distinct == 3) && ((max - min) <= 1), "channel spread of the 100 Hz tag");
+
+  //tags at or below their limit are never thinned
+  sli_ncp_iq_rate_check_run(4, 10, seconds, false, &result);
+  printf("10/s limit, 10 Hz tag:      kept %u of %u\n", result.kept, result.sent);
+  ok &= sli_ncp_iq_rate_check_expect(result.kept == result.sent, "10 Hz tag at its limit thinned");
+  sli_ncp_iq_rate_check_run(5, 8, seconds, false, &result);
+  printf("10/s limit, 8 Hz tag:       kept %u of %u\n", result.kept, result.sent);
+  ok &= sli_ncp_iq_rate_check_expect(result.kept == result.sent, "8 Hz tag below its limit thinned");
+
+  //an own limit overrides the global one, 0 returns to it
+  ok &= sli_ncp_iq_rate_check_expect(sli_ncp_iq_rate_check_set_rate(6, 2) == SL_STATUS_OK, "tag limit refused");
+  sli_ncp_iq_rate_check_run(6, 50, seconds, false, &result);
+  printf("2/s own limit, 50 Hz tag:   kept %u of %u\n", result.kept, result.sent);
+  ok &= sli_ncp_iq_rate_check_expect(sli_ncp_iq_rate_check_kept(&result, 2, seconds), "kept count of the 2/s tag");
+  ok &= sli_ncp_iq_rate_check_expect(sli_ncp_iq_rate_check_set_rate(7, 2) == SL_STATUS_OK, "tag limit refused");
+  sli_ncp_iq_rate_check_run(7, 2, seconds, false, &result);
+  printf("2/s own limit, 2 Hz tag:    kept %u of %u\n", result.kept, result.sent);
+  ok &= sli_ncp_iq_rate_check_expect(result.kept == result.sent, "2 Hz tag at its own limit thinned");
+  ok &= sli_ncp_iq_rate_check_expect(sli_ncp_iq_rate_check_set_rate(6, 0) == SL_STATUS_OK, "tag limit reset refused");
+  sli_ncp_iq_rate_check_run(6, 50, seconds, false, &result);
+  printf("back to 10/s, 50 Hz tag:    kept %u of %u\n", result.kept, result.sent);
+  ok &= sli_ncp_iq_rate_check_expect(result.kept <= (10 * seconds) + SLI_NCP_IQ_RATE_CHECK_BURST,
+                                     "kept count back at the global limit");
+
+  return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+uint32_t sl_sleeptimer_get_tick_count(void)
+{
+  return sli_tick;
+}
+
+uint32_t sl_sleeptimer_get_timer_frequency(void)
+{
+  return SLI_NCP_IQ_RATE_CHECK_TIMER_FREQUENCY;
+}
+
+///the statistics timer is never fired, the checks count the reports themselves
+sl_status_t app_timer_start(app_timer_t *timer,
+                            uint32_t timeout_ms,
+                            app_timer_callback_t callback,
+                            void *callback_data,
+                            bool is_periodic)
+{
+  (void)timeout_ms;
+  (void)is_periodic;
+  timer->callback = callback;
+  timer->callback_data = callback_data;
+  return SL_STATUS_OK;
+}
+
+sl_status_t app_timer_stop(app_timer_t *timer)
+{
+  timer->callback = NULL;
+  return SL_STATUS_OK;
+}
+
+void sl_ncp_user_cmd_message_to_target_rsp(sl_status_t result, uint8_t len, uint8_t *data)
+{
+  (void)len;
+  (void)data;
+  sli_response = result;
+}
+
+void sl_ncp_user_evt_message_to_host(uint8_t len, uint8_t *data)
+{
+  (void)len;
+  (void)data;
+  sli_stats_events++;
+}
+
+static void sli_ncp_iq_rate_check_usage(const char *name)
+{
+  printf("Usage: %s [options]\n", name);
+  printf("  -t  Simulated seconds of each tag, default: %u\n", SLI_NCP_IQ_RATE_CHECK_DEFAULT_SECONDS);
+}
+
+///sends IQ_RATE_CMD_ID for the tag address, 0xff for all tags
+static sl_status_t sli_ncp_iq_rate_check_set_rate(uint8_t tag, uint16_t max_rate)
+{
+  struct {
+    uint8_t len;
+    uint8_t data[IQ_RATE_CMD_LEN];
+  } cmd;
+  iq_rate_cmd_t rate;
+
+  memset(&rate.address, tag, sizeof(rate.address));
+  rate.max_rate = max_rate;
+  cmd.len = IQ_RATE_CMD_LEN;
+  cmd.data[0] = IQ_RATE_CMD_ID;
+  memcpy(&cmd.data[1], &rate, sizeof(rate));
+  sli_response = SL_STATUS_FAIL;
+  sl_ncp_user_cmd_message_to_target_cb(&cmd);
+  return sli_response;
+}
+
+///Silabs IQ reports of a tag at a fixed rate on random channels
+static void sli_ncp_iq_rate_check_run(uint8_t tag,
+                                      uint32_t hz,
+                                      uint32_t seconds,
+                                      bool advertising_channels,
+                                      sli_ncp_iq_rate_check_result_t *result)
+{
+  sl_bt_msg_t evt;
+  uint32_t start = sli_tick;
+  uint32_t min;
+  uint32_t max;
+  uint8_t channel;
+
+  memset(result, 0, sizeof(*result));
+  for (uint32_t n = 0; n < hz * seconds; n++) {
+    sli_tick = start + (uint32_t)(((uint64_t)n * SLI_NCP_IQ_RATE_CHECK_TIMER_FREQUENCY) / hz);
+    if (advertising_channels) {
+      channel = (uint8_t)(SLI_NCP_IQ_RATE_CHECK_DATA_CHANNELS + (n % 3));
+    } else {
+      channel = (uint8_t)(sli_ncp_iq_rate_check_random(&sli_random_state) % SLI_NCP_IQ_RATE_CHECK_DATA_CHANNELS);
+    }
+    memset(&evt, 0, sizeof(evt));
+    evt.header = sl_bt_evt_cte_receiver_silabs_iq_report_id;
+    memset(&evt.data.evt_cte_receiver_silabs_iq_report.address, tag, sizeof(bd_addr));
+    evt.data.evt_cte_receiver_silabs_iq_report.channel = channel;
+    result->sent++;
+    if (sl_ncp_local_evt_process(&evt)) {
+      result->kept++;
+      result->channels[channel]++;
+      if (result->kept == SLI_NCP_IQ_RATE_CHECK_DATA_CHANNELS) {
+        result->first_round = sli_ncp_iq_rate_check_spread(result, &min, &max);
+      }
+    }
+  }
+  //the next tag starts one report interval later
+  sli_tick = start + (uint32_t)(((uint64_t)hz * seconds * SLI_NCP_IQ_RATE_CHECK_TIMER_FREQUENCY) / hz);
+}
+
+///number of channels with kept reports and the least and most kept on one of them
+static uint32_t sli_ncp_iq_rate_check_spread(const sli_ncp_iq_rate_check_result_t *result,
+                                             uint32_t *min,
+                                             uint32_t *max)
+{
+  uint32_t distinct = 0;
+
+  *min = UINT32_MAX;
+  *max = 0;
+  for (uint32_t channel = 0; channel < SLI_NCP_IQ_RATE_CHECK_CHANNELS; channel++) {
+    if (result->channels[channel] == 0) {
+      continue;
+    }
+    distinct++;
+    *min = (result->channels[channel] < *min) ? result->channels[channel] : *min;
+    *max = (result->channels[channel] > *max) ? result->channels[channel] : *max;
+  }
+  if (distinct == 0) {
+    *min = 0;
+  }
+  return distinct;
+}
+
+///one report per interval of the limit in ticks, and the one of the saved up time at the start
+static bool sli_ncp_iq_rate_check_kept(const sli_ncp_iq_rate_check_result_t *result,
+                                       uint16_t max_rate,
+                                       uint32_t seconds)
+{
+  uint32_t interval = SLI_NCP_IQ_RATE_CHECK_TIMER_FREQUENCY / max_rate;
+  uint32_t expected = ((seconds * SLI_NCP_IQ_RATE_CHECK_TIMER_FREQUENCY) / interval) + 1;
+
+  return (result->kept >= expected) && (result->kept <= expected + 1);
+}
+
+static bool sli_ncp_iq_rate_check_expect(bool condition, const char *what)
+{
+  if (!condition) {
+    fprintf(stderr, "IQ rate check failed: %s\n", what);
+  }
+  return condition;
+}
+
+///xorshift32
+static uint32_t sli_ncp_iq_rate_check_random(uint32_t *state)
+{
+  uint32_t x = (*state != 0) ? *state : 1;
+
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+  *state = x;
+  return x;
+}
@@ -0,0 +1,240 @@
+/***************************************************************************//**
+ * @file
+ * @brief NCP host communication over a serial device, pty or TCP socket for POSIX.
+ * @version 1.0.0
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2024 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * The licensor of this software is Silicon Laboratories Inc. Your use of this
+ * software is governed by the terms of Silicon Labs Master Software License
+ * Agreement (MSLA) available at
+ * www.silabs.com/about-us/legal/master-software-license-agreement. This
+ * software is distributed to you in Source Code format and is governed by the
+ * sections of the MSLA applicable to Source Code.
+ *
+ ******************************************************************************/
+#include <errno.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <poll.h>
+#include <stdio.h>
+#include <string.h>
+#include <termios.h>
+#include <unistd.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include "sl_common.h"
+#include "sl_bt_ncp_host.h"
+#include "sl_ncp_host_com_posix.h"
+#include "app_log.h"
+
+//macros -----------------------------------------------------------------------
+//private type definitions -----------------------------------------------------
+//private function prototypes --------------------------------------------------
+static speed_t sli_ncp_host_com_posix_speed(uint32_t baudrate);
+
+//private variables ------------------------------------------------------------
+static int sli_ncp_host_com_posix_fd = -1;
+
+//function definitions----------------------------------------------------------
+sl_status_t sl_ncp_host_com_posix_open_serial(const char *device, uint32_t baudrate)
+{
+  struct termios tty;
+  speed_t speed = sli_ncp_host_com_posix_speed(baudrate);
+
+  if (speed == B0) {
+    app_log_error("Unsupported baud rate: %u" APP_LOG_NL, baudrate);
+    return SL_STATUS_INVALID_PARAMETER;
+  }
+
+  int fd = open(device, O_RDWR | O_NOCTTY | O_CLOEXEC);
+  if (fd < 0) {
+    app_log_error("Failed to open %s: %s" APP_LOG_NL, device, strerror(errno));
+    return SL_STATUS_FAIL;
+  }
+
+  //raw mode, 8N1, hardware flow control as used by the NCP target
+  if (tcgetattr(fd, &tty) == 0) {
+    cfmakeraw(&tty);
+    cfsetispeed(&tty, speed);
+    cfsetospeed(&tty, speed);
+    tty.c_cflag |= CLOCAL | CREAD | CRTSCTS;
+    tty.c_cflag &= ~(CSTOPB | PARENB);
+    tty.c_cc[VMIN] = 0;
+    tty.c_cc[VTIME] = 0;
+    if (tcsetattr(fd, TCSANOW, &tty) != 0) {
+      app_log_error("Failed to configure %s: %s" APP_LOG_NL, device, strerror(errno));
+      close(fd);
+      return SL_STATUS_FAIL;
+    }
+    tcflush(fd, TCIOFLUSH);
+  }
+  //tcgetattr fails on non-terminal files (e.g. fifos), they are used as they are
+
+  sl_ncp_host_com_posix_close();
+  sli_ncp_host_com_posix_fd = fd;
+  return SL_STATUS_OK;
+}
+
+sl_status_t sl_ncp_host_com_posix_open_tcp(const char *host, uint16_t port)
+{
+  struct addrinfo hints = { 0 };
+  struct addrinfo *result;
+  struct addrinfo *ai;
+  char service[6];
+  int fd = -1;
+
+  hints.ai_family = AF_UNSPEC;
+  hints.ai_socktype = SOCK_STREAM;
+  snprintf(service, sizeof(service), "%u", port);
+  int rc = getaddrinfo(host, service, &hints, &result);
+  if (rc != 0) {
+    app_log_error("Failed to resolve %s: %s" APP_LOG_NL, host, gai_strerror(rc));
+    return SL_STATUS_FAIL;
+  }
+
+  for (ai = result; ai != NULL; ai = ai->ai_next) {
+    fd = socket(ai->ai_family, ai->ai_socktype | SOCK_CLOEXEC, ai->ai_protocol);
+    if (fd < 0) {
+      continue;
+    }
+    if (connect(fd, ai->ai_addr, ai->ai_addrlen) == 0) {
+      break;
+    }
+    close(fd);
+    fd = -1;
+  }
+  freeaddrinfo(result);
+
+  if (fd < 0) {
+    app_log_error("Failed to connect to %s:%u" APP_LOG_NL, host, port);
+    return SL_STATUS_FAIL;
+  }
+
+  //BGAPI commands are short and latency sensitive
+  int one = 1;
+  setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+  sl_ncp_host_com_posix_close();
+  sli_ncp_host_com_posix_fd = fd;
+  return SL_STATUS_OK;
+}
+
+void sl_ncp_host_com_posix_close(void)
+{
+  if (sli_ncp_host_com_posix_fd >= 0) {
+    close(sli_ncp_host_com_posix_fd);
+    sli_ncp_host_com_posix_fd = -1;
+  }
+}
+
+sl_status_t sl_ncp_host_com_posix_wait(int timeout_ms)
+{
+  struct pollfd pfd = { .fd = sli_ncp_host_com_posix_fd, .events = POLLIN };
+
+  int rc = poll(&pfd, 1, timeout_ms);
+  if (rc < 0) {
+    return (errno == EINTR) ? SL_STATUS_TIMEOUT : SL_STATUS_FAIL;
+  }
+  if (rc == 0) {
+    return SL_STATUS_TIMEOUT;
+  }
+  if ((pfd.revents & POLLIN) == 0) {
+    return SL_STATUS_FAIL; //POLLHUP or POLLERR without data
+  }
+  int32_t available = sl_ncp_host_com_peek();
+  if (available == 0) {
+    return SL_STATUS_FAIL; //readable without data: end of file, the peer is gone
+  }
+  sl_ncp_host_com_on_receive((uint32_t)available);
+  return SL_STATUS_OK;
+}
+
+SL_WEAK void sl_ncp_host_com_on_receive(uint32_t len)
+{
+  (void)len;
+}
+
+void sl_ncp_host_com_init(void)
+{
+  sl_status_t sc = sl_bt_api_initialize_nonblock(sl_ncp_host_com_write,
+                                                 sl_ncp_host_com_read,
+                                                 sl_ncp_host_com_peek);
+  if (sc != SL_STATUS_OK) {
+    app_log_error("Failed to init Bluetooth NCP: 0x%04x" APP_LOG_NL, (unsigned)sc);
+  }
+}
+
+void sl_ncp_host_com_write(uint32_t len, uint8_t *data)
+{
+  while (len > 0) {
+    ssize_t written = write(sli_ncp_host_com_posix_fd, data, len);
+    if (written < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      app_log_error("NCP write failed: %s" APP_LOG_NL, strerror(errno));
+      return;
+    }
+    data += written;
+    len -= (uint32_t)written;
+  }
+}
+
+int32_t sl_ncp_host_com_read(uint32_t len, uint8_t *data)
+{
+  uint32_t received = 0;
+
+  //the adaptation layer reads the header and the payload separately,
+  //the rest of a message is waited for instead of breaking the stream sync
+  while (received < len) {
+    ssize_t rc = read(sli_ncp_host_com_posix_fd, &data[received], len - received);
+    if (rc > 0) {
+      received += (uint32_t)rc;
+      continue;
+    }
+    if (rc < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      if (errno != EAGAIN) {
+        return -1;
+      }
+    }
+    if (sl_ncp_host_com_posix_wait(SL_NCP_HOST_COM_POSIX_READ_TIMEOUT_MS) != SL_STATUS_OK) {
+      return -1;
+    }
+  }
+  return (int32_t)received;
+}
+
+int32_t sl_ncp_host_com_peek(void)
+{
+  int available = 0;
+
+  if (ioctl(sli_ncp_host_com_posix_fd, FIONREAD, &available) != 0) {
+    return 0;
+  }
+  return available;
+}
+
+static speed_t sli_ncp_host_com_posix_speed(uint32_t baudrate)
+{
+  switch (baudrate) {
+    case 9600:    return B9600;
+    case 19200:   return B19200;
+    case 38400:   return B38400;
+    case 57600:   return B57600;
+    case 115200:  return B115200;
+    case 230400:  return B230400;
+    case 460800:  return B460800;
+    case 921600:  return B921600;
+    case 1000000: return B1000000;
+    case 2000000: return B2000000;
+    default:      return B0;
+  }
+}
@@ -0,0 +1,107 @@
+/***************************************************************************//**
+ * @file
+ * @brief NCP host communication over a serial device, pty or TCP socket for POSIX.
+ * @version 1.0.0
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2024 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * The licensor of this software is Silicon Laboratories Inc. Your use of this
+ * software is governed by the terms of Silicon Labs Master Software License
+ * Agreement (MSLA) available at
+ * www.silabs.com/about-us/legal/master-software-license-agreement. This
+ * software is distributed to you in Source Code format and is governed by the
+ * sections of the MSLA applicable to Source Code.
+ *
+ ******************************************************************************/
+#ifndef SL_NCP_HOST_COM_POSIX_H
+#define SL_NCP_HOST_COM_POSIX_H
+#ifdef __cplusplus
+extern "C" {
+#endif
+#include <stdint.h>
+#include "sl_status.h"
+
+//macros -----------------------------------------------------------------------
+///Default baud rate of the NCP serial interface
+#define SL_NCP_HOST_COM_POSIX_DEFAULT_BAUDRATE     115200
+///Default TCP port, the port of the VCOM on Silicon Labs development kits
+#define SL_NCP_HOST_COM_POSIX_DEFAULT_TCP_PORT     4901
+///Time to wait for the rest of a partially received message in ms
+#define SL_NCP_HOST_COM_POSIX_READ_TIMEOUT_MS      1000
+
+//type definitions -------------------------------------------------------------
+//global variables -------------------------------------------------------------
+//function prototypes ----------------------------------------------------------
+/***************************************************************************//**
+ * Opens a serial device or pty as the NCP interface.
+ *
+ * @param[in] device Path of the device, e.g. /dev/ttyACM0 or /dev/pts/3.
+ * @param[in] baudrate Baud rate, ignored for ptys.
+ *
+ * @return SL_STATUS_OK if successful. Error code otherwise.
+ ******************************************************************************/
+sl_status_t sl_ncp_host_com_posix_open_serial(const char *device, uint32_t baudrate);
+
+/***************************************************************************//**
+ * Connects to the NCP interface through TCP.
+ *
+ * @param[in] host Host name or IP address.
+ * @param[in] port TCP port.
+ *
+ * @return SL_STATUS_OK if successful. Error code otherwise.
+ ******************************************************************************/
+sl_status_t sl_ncp_host_com_posix_open_tcp(const char *host, uint16_t port);
+
+/***************************************************************************//**
+ * Closes the NCP interface.
+ ******************************************************************************/
+void sl_ncp_host_com_posix_close(void);
+
+/***************************************************************************//**
+ * Waits until data is received from the NCP or the timeout elapses.
+ *
+ * @param[in] timeout_ms Timeout in ms, 0 returns immediately.
+ *
+ * @return SL_STATUS_OK if data is available, SL_STATUS_TIMEOUT if not,
+ *         other error code if the interface is broken.
+ ******************************************************************************/
+sl_status_t sl_ncp_host_com_posix_wait(int timeout_ms);
+
+/***************************************************************************//**
+ * Called when data from the NCP is found available by the wait function.
+ * Weak, does nothing by default.
+ *
+ * @param[in] len Number of bytes available
+ ******************************************************************************/
+void sl_ncp_host_com_on_receive(uint32_t len);
+
+/***************************************************************************//**
+ * Registers the interface in the BGAPI adaptation layer.
+ * Shall be called after one of the open functions.
+ ******************************************************************************/
+void sl_ncp_host_com_init(void);
+
+/***************************************************************************//**
+ * Transmits a BGAPI message to the NCP.
+ ******************************************************************************/
+void sl_ncp_host_com_write(uint32_t len, uint8_t *data);
+
+/***************************************************************************//**
+ * Reads exactly len bytes from the NCP, waits for the missing bytes at most
+ * SL_NCP_HOST_COM_POSIX_READ_TIMEOUT_MS.
+ *
+ * @return Number of bytes read, -1 on error or timeout.
+ ******************************************************************************/
+int32_t sl_ncp_host_com_read(uint32_t len, uint8_t *data);
+
+/***************************************************************************//**
+ * Gives back the number of received bytes waiting to be read.
+ ******************************************************************************/
+int32_t sl_ncp_host_com_peek(void);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* SL_NCP_HOST_COM_POSIX_H */
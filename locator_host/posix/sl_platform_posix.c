@@ -0,0 +1,82 @@
+/***************************************************************************//**
+ * @file
+ * @brief Timer and watchdog drivers for POSIX.
+ * @version 1.0.0
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2024 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * The licensor of this software is Silicon Laboratories Inc. Your use of this
+ * software is governed by the terms of Silicon Labs Master Software License
+ * Agreement (MSLA) available at
+ * www.silabs.com/about-us/legal/master-software-license-agreement. This
+ * software is distributed to you in Source Code format and is governed by the
+ * sections of the MSLA applicable to Source Code.
+ *
+ ******************************************************************************/
+#include <time.h>
+#include "sl_timer.h"
+#include "sl_sleeptimer.h"
+#include "sl_watchdog.h"
+
+//macros -----------------------------------------------------------------------
+///The timer counts nanoseconds of the monotonic clock
+#define SLI_PLATFORM_POSIX_TIMER_FREQUENCY 1000000000UL
+///The sleeptimer runs at the usual LF clock rate
+#define SLI_PLATFORM_POSIX_SLEEPTIMER_FREQUENCY 32768UL
+
+//private type definitions -----------------------------------------------------
+//private function prototypes --------------------------------------------------
+//private variables ------------------------------------------------------------
+//function definitions----------------------------------------------------------
+void sl_timer_init(void)
+{
+}
+
+uint32_t sl_timer_get(void)
+{
+  struct timespec now;
+
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  //wraps like the cycle counter, differences stay valid
+  return (uint32_t)(((uint64_t)now.tv_sec * SLI_PLATFORM_POSIX_TIMER_FREQUENCY) + (uint64_t)now.tv_nsec);
+}
+
+uint32_t sl_timer_get_frequency(void)
+{
+  return SLI_PLATFORM_POSIX_TIMER_FREQUENCY;
+}
+
+uint32_t sl_sleeptimer_get_tick_count(void)
+{
+  struct timespec now;
+
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (uint32_t)(((uint64_t)now.tv_sec * SLI_PLATFORM_POSIX_SLEEPTIMER_FREQUENCY)
+                    + (((uint64_t)now.tv_nsec * SLI_PLATFORM_POSIX_SLEEPTIMER_FREQUENCY) / 1000000000UL));
+}
+
+uint32_t sl_sleeptimer_get_timer_frequency(void)
+{
+  return SLI_PLATFORM_POSIX_SLEEPTIMER_FREQUENCY;
+}
+
+sl_status_t sl_sleeptimer_ms32_to_tick(uint32_t time_ms, uint32_t *tick)
+{
+  uint64_t ticks = ((uint64_t)time_ms * SLI_PLATFORM_POSIX_SLEEPTIMER_FREQUENCY) / 1000;
+
+  if (ticks > UINT32_MAX) {
+    return SL_STATUS_INVALID_PARAMETER;
+  }
+  *tick = (uint32_t)ticks;
+  return SL_STATUS_OK;
+}
+
+void sl_watchdog_init(void)
+{
+}
+
+void sl_watchdog_feed(void)
+{
+}
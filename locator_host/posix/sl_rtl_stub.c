@@ -0,0 +1,234 @@
+/***************************************************************************//**
+ * @file
+ * @brief Stub angle estimator for builds without the Cortex-M33 RTL library.
+ * @version 1.0.0
+ *******************************************************************************
+ * # License
+ * <b>Copyright 2024 Silicon Laboratories Inc. www.silabs.com</b>
+ *******************************************************************************
+ *
+ * The licensor of this software is Silicon Laboratories Inc. Your use of this
+ * software is governed by the terms of Silicon Labs Master Software License
+ * Agreement (MSLA) available at
+ * www.silabs.com/about-us/legal/master-software-license-agreement. This
+ * software is distributed to you in Source Code format and is governed by the
+ * sections of the MSLA applicable to Source Code.
+ *
+ ******************************************************************************/
+#include <math.h>
+#include <stddef.h>
+#include "sl_rtl_clib_api.h"
+
+//macros -----------------------------------------------------------------------
+///Path loss exponent of the free space
+#define SLI_RTL_STUB_PATH_LOSS_EXPONENT 2.0f
+
+//private type definitions -----------------------------------------------------
+//private function prototypes --------------------------------------------------
+//private variables ------------------------------------------------------------
+//function definitions----------------------------------------------------------
+//libaox_static.a is only available for Cortex-M33. The stub accepts every
+//configuration and estimates 0 deg azimuth and elevation, so the rest of the
+//receive -> estimate -> publish path runs unchanged on POSIX.
+
+enum sl_rtl_error_code sl_rtl_aox_init(sl_rtl_aox_libitem *item)
+{
+  *item = NULL;
+  return SL_RTL_ERROR_SUCCESS;
+}
+
+enum sl_rtl_error_code sl_rtl_aox_deinit(sl_rtl_aox_libitem *item)
+{
+  *item = NULL;
+  return SL_RTL_ERROR_SUCCESS;
+}
+
+enum sl_rtl_error_code sl_rtl_aox_set_num_snapshots(sl_rtl_aox_libitem *item, uint32_t num_snapshots)
+{
+  (void)item;
+  (void)num_snapshots;
+  return SL_RTL_ERROR_SUCCESS;
+}
+
+enum sl_rtl_error_code sl_rtl_aox_set_array_type(sl_rtl_aox_libitem *item, enum sl_rtl_aox_array_type array_type)
+{
+  (void)item;
+  (void)array_type;
+  return SL_RTL_ERROR_SUCCESS;
+}
+
+enum sl_rtl_error_code sl_rtl_aox_set_mode(sl_rtl_aox_libitem *item, enum sl_rtl_aox_mode mode)
+{
+  (void)item;
+  (void)mode;
+  return SL_RTL_ERROR_SUCCESS;
+}
+
+enum sl_rtl_error_code sl_rtl_aox_calculate_iq_sample_phase_rotation(sl_rtl_aox_libitem *item,
+                                                                     float iq_data_downsampling_factor,
+                                                                     float *i_samples,
+                                                                     float *q_samples,
+                                                                     uint32_t num_samples,
+                                                                     float *phase_rotation_out)
+{
+  (void)item;
+  (void)iq_data_downsampling_factor;
+  (void)i_samples;
+  (void)q_samples;
+  (void)num_samples;
+  *phase_rotation_out = 0.0f;
+  return SL_RTL_ERROR_SUCCESS;
+}
+
+enum sl_rtl_error_code sl_rtl_aox_set_iq_sample_phase_rotation(sl_rtl_aox_libitem *item, float phase_rotation)
+{
+  (void)item;
+  (void)phase_rotation;
+  return SL_RTL_ERROR_SUCCESS;
+}
+
+enum sl_rtl_error_code sl_rtl_aox_add_constraint(sl_rtl_aox_libitem *item,
+                                                 enum sl_rtl_aox_constraint_type constraint_type,
+                                                 float min_value,
+                                                 float max_value)
+{
+  (void)item;
+  (void)constraint_type;
+  (void)min_value;
+  (void)max_value;
+  return SL_RTL_ERROR_SUCCESS;
+}
+
+enum sl_rtl_error_code sl_rtl_aox_iq_sample_qa_configure(sl_rtl_aox_libitem *item)
+{
+  (void)item;
+  return SL_RTL_ERROR_SUCCESS;
+}
+
+uint32_t sl_rtl_aox_iq_sample_qa_get_results(sl_rtl_aox_libitem *item)
+{
+  (void)item;
+  return 0;
+}
+
+enum sl_rtl_error_code sl_rtl_aox_create_estimator(sl_rtl_aox_libitem *item)
+{
+  (void)item;
+  return SL_RTL_ERROR_SUCCESS;
+}
+
+enum sl_rtl_error_code sl_rtl_aox_reset_estimator(sl_rtl_aox_libitem *item)
+{
+  (void)item;
+  return SL_RTL_ERROR_SUCCESS;
+}
+
+enum sl_rtl_error_code sl_rtl_aox_set_switch_pattern_mode(sl_rtl_aox_libitem *item, enum sl_rtl_aox_switch_pattern_mode mode)
+{
+  (void)item;
+  (void)mode;
+  return SL_RTL_ERROR_SUCCESS;
+}
+
+enum sl_rtl_error_code sl_rtl_aox_update_switch_pattern(sl_rtl_aox_libitem *item,
+                                                        uint32_t *switch_pattern_in,
+                                                        uint32_t **switch_pattern_out)
+{
+  (void)item;
+  (void)switch_pattern_in;
+  if (switch_pattern_out != NULL) {
+    *switch_pattern_out = NULL;
+  }
+  return SL_RTL_ERROR_SUCCESS;
+}
+
+enum sl_rtl_error_code sl_rtl_aox_process(sl_rtl_aox_libitem *item,
+                                          float **i_samples,
+                                          float **q_samples,
+                                          float tone_frequency,
+                                          float *az_out,
+                                          float *el_out)
+{
+  (void)item;
+  (void)i_samples;
+  (void)q_samples;
+  (void)tone_frequency;
+  *az_out = 0.0f;
+  *el_out = 0.0f;
+  return SL_RTL_ERROR_SUCCESS;
+}
+
+enum sl_rtl_error_code sl_rtl_aox_get_latest_aox_standard_deviation(sl_rtl_aox_libitem *item,
+                                                                    float *az_std_dev_out,
+                                                                    float *el_std_dev_out)
+{
+  (void)item;
+  *az_std_dev_out = 0.0f;
+  *el_std_dev_out = 0.0f;
+  return SL_RTL_ERROR_SUCCESS;
+}
+
+enum sl_rtl_error_code sl_rtl_aox_set_expected_direction(sl_rtl_aox_libitem *item, float expected_az, float expected_el)
+{
+  (void)item;
+  (void)expected_az;
+  (void)expected_el;
+  return SL_RTL_ERROR_SUCCESS;
+}
+
+enum sl_rtl_error_code sl_rtl_aox_set_expected_deviation(sl_rtl_aox_libitem *item, float deviation_az, float deviation_el)
+{
+  (void)item;
+  (void)deviation_az;
+  (void)deviation_el;
+  return SL_RTL_ERROR_SUCCESS;
+}
+
+enum sl_rtl_error_code sl_rtl_aox_clear_expected_direction(sl_rtl_aox_libitem *item)
+{
+  (void)item;
+  return SL_RTL_ERROR_SUCCESS;
+}
+
+enum sl_rtl_error_code sl_rtl_util_init(sl_rtl_util_libitem *item)
+{
+  *item = NULL;
+  return SL_RTL_ERROR_SUCCESS;
+}
+
+enum sl_rtl_error_code sl_rtl_util_deinit(sl_rtl_util_libitem *item)
+{
+  *item = NULL;
+  return SL_RTL_ERROR_SUCCESS;
+}
+
+enum sl_rtl_error_code sl_rtl_util_set_parameter(sl_rtl_util_libitem *item, enum sl_rtl_util_parameter parameter, float value)
+{
+  (void)item;
+  (void)parameter;
+  (void)value;
+  return SL_RTL_ERROR_SUCCESS;
+}
+
+enum sl_rtl_error_code sl_rtl_util_filter(sl_rtl_util_libitem *item, float value_in, float *value_out)
+{
+  (void)item;
+  *value_out = value_in;
+  return SL_RTL_ERROR_SUCCESS;
+}
+
+enum sl_rtl_error_code sl_rtl_util_rssi2distance(float tx_power, float rssi, float *distance_out)
+{
+  //log-distance path loss model
+  *distance_out = powf(10.0f, (tx_power - rssi) / (10.0f * SLI_RTL_STUB_PATH_LOSS_EXPONENT));
+  return SL_RTL_ERROR_SUCCESS;
+}
+
+char *sl_rtl_util_iq_sample_qa_code2string(char *buf, int size, uint32_t code)
+{
+  (void)code;
+  if ((buf != NULL) && (size > 0)) {
+    buf[0] = '\0';
+  }
+  return buf;
+}
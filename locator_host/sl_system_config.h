@@ -27,17 +27,26 @@ extern "C" {
 ///Defines whether the angle calculations is enabled or not
 #define SYSTEM_BT_AOA_ANGLE_CALCULATION_EN 1
 
-///Maximum allowed tag number. If angle is not calculated then it can be higher only the UART/MQTT processing will limit. If angle calculation is enabled then heap will limit as well.
+///Maximum allowed tag number. If angle is not calculated then it can be higher only the UART/MQTT processing will limit. If angle calculation is enabled then the estimator states are allocated statically for this many tags, and the heap used by the RTL library will limit as well.
 #if SYSTEM_BT_AOA_ANGLE_CALCULATION_EN
   #define SYSTEM_BT_AOA_MAX_TAG_COUNT      8
 #else
   #define SYSTEM_BT_AOA_MAX_TAG_COUNT      10
 #endif
 
+///Set to 1 to keep the estimator of a removed tag configured and only reset it for the next tag, instead of a full deinit and init.
+#define SYSTEM_BT_AOA_ESTIMATOR_RECYCLING_EN 1
+
+///Reports waiting longer than this for the angle calculation are dropped, in ms. 0 disables the deadline.
+#define SYSTEM_BT_AOA_SCHEDULE_DEADLINE_MS     250
+///Maximum number of angle calculations in one main loop pass, the BGAPI events are processed in between.
+#define SYSTEM_BT_AOA_SCHEDULE_MAX_PER_PASS    2
+
 //IQ sample providing possibilities, raw bytes is the fastest.
 #define SYSTEM_AOA_IQ_SAMPLE_PROVIDE_METHOD_RAW_BYTES          0
 #define SYSTEM_AOA_IQ_SAMPLE_PROVIDE_METHOD_JSON               1
-///Selected IQ sample providing method
+#define SYSTEM_AOA_IQ_SAMPLE_PROVIDE_METHOD_BINARY             2 //versioned frame with metadata, see aoa_iq_frame.h
+///Selected IQ sample providing method, the binary frame is opt-in as existing consumers expect JSON.
 #define SYSTEM_AOA_IQ_SAMPLE_PROVIDE_METHOD                    SYSTEM_AOA_IQ_SAMPLE_PROVIDE_METHOD_JSON
 
 //Utility macros for number to string transformation
@@ -0,0 +1,60 @@
+import argparse
+import json
+
+parser = argparse.ArgumentParser(description='Converts the latency trace dumped by the locator host to Chrome trace JSON (chrome://tracing or ui.perfetto.dev).')
+parser.add_argument('log', type=str, help='Log file (RTT or the output of locator_host_replay -t) holding one or more latency trace dumps.')
+parser.add_argument('--output', type=str, default = 'latency_trace.json', help='Chrome trace JSON file to write.')
+args = parser.parse_args()
+
+# Stages in the order of the timestamps in a record, see sl_latency_trace_stage_t.
+STAGES = ['uart_rx', 'dispatch', 'iq_report', 'angle', 'publish']
+# Name of the span ending at the given stage.
+SPANS = {'dispatch': 'queue', 'iq_report': 'parse', 'angle': 'angle', 'publish': 'publish'}
+TIMER_WRAP = 1 << 32
+
+events = []
+frequency = None
+base = None
+last = None
+offset = 0
+with open(args.log, 'r', errors='replace') as f:
+  for line in f:
+    fields = line.strip().split(',')
+    if fields[0] == 'latency_trace_begin':
+      frequency = int(fields[1])
+      continue
+    if fields[0] != 'latency_trace' or frequency is None or len(fields) != 3 + len(STAGES):
+      continue
+    tag, sequence = fields[1], int(fields[2])
+    stamps = [(stage, int(value)) for stage, value in zip(STAGES, fields[3:]) if value]
+    if not stamps:
+      continue
+    # The timer is 32 bit, records are in time order so a backward step is a wrap.
+    first = stamps[0][1]
+    if last is not None and first + offset < last - TIMER_WRAP // 2:
+      offset += TIMER_WRAP
+    if base is None:
+      base = first + offset
+    times = []
+    for stage, value in stamps:
+      value += offset
+      # Later stages of the record may have wrapped as well.
+      if times and value < times[-1][1]:
+        value += TIMER_WRAP
+      times.append((stage, value))
+    last = times[0][1]
+    for (_, start), (stage, end) in zip(times, times[1:]):
+      events.append({
+        'name': SPANS[stage],
+        'cat': 'latency',
+        'ph': 'X',
+        'pid': 1,
+        'tid': tag,
+        'ts': (start - base) * 1e6 / frequency,
+        'dur': (end - start) * 1e6 / frequency,
+        'args': {'sequence': sequence},
+      })
+
+with open(args.output, 'w') as f:
+  json.dump({'traceEvents': events, 'displayTimeUnit': 'ns'}, f)
+print(f'{len(events)} spans written to {args.output}')
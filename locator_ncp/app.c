@@ -27,10 +27,61 @@
  * 3. This notice may not be removed or altered from any source distribution.
  *
  ******************************************************************************/
+#include <stddef.h>
+#include <string.h>
 #include "em_common.h"
 #include "sl_ncp.h"
+#include "sl_sleeptimer.h"
+#include "app_timer.h"
 #include "app.h"
 
+// Tags tracked by the IQ report decimation.
+#define IQ_DECIMATION_TAG_COUNT        32
+// Default period of the IQ report statistics event in ms.
+#define IQ_DECIMATION_STATS_PERIOD     1000
+// Reports a tag may save up while it is silent.
+#define IQ_DECIMATION_BURST            2
+// A report on a recently kept channel is held back only if the tag sends at
+// least this many times the allowed rate, slower tags are not thinned out.
+#define IQ_DECIMATION_DIVERSITY_RATIO  2
+#define IQ_DECIMATION_CHANNEL_COUNT    40
+
+typedef enum {
+  IQ_HANDLE_NONE,
+  IQ_HANDLE_CONNECTION,
+  IQ_HANDLE_SYNC
+} iq_handle_type_t;
+
+typedef struct {
+  bool used;
+  bd_addr address;
+  iq_handle_type_t handle_type;
+  uint16_t handle;
+  uint16_t max_rate;      // Own limit of the tag, 0 follows the global one
+  uint32_t tick;          // Time of the last report
+  uint32_t period;        // Smoothed report interval of the tag in ticks
+  uint32_t credit;        // Saved up time in ticks, a report costs one interval
+  uint64_t channels;      // Channels of the reports kept since the last repeat
+  uint32_t skipped;       // Skipped reports in the statistics period
+} iq_tag_t;
+
+static iq_tag_t iq_tags[IQ_DECIMATION_TAG_COUNT];
+static uint16_t iq_max_rate = 0;
+static uint32_t iq_forwarded = 0;
+static uint32_t iq_skipped = 0;
+static app_timer_t iq_stats_timer;
+
+static sl_status_t iq_set_rate(const iq_rate_cmd_t *cmd);
+static sl_status_t iq_set_stats_period(uint16_t period);
+static void iq_stats_timer_cb(app_timer_t *timer, void *data);
+static bool iq_report_is_kept(iq_tag_t *tag, uint8_t channel);
+static iq_tag_t *iq_find_by_address(const bd_addr *address);
+static iq_tag_t *iq_find_by_handle(iq_handle_type_t handle_type, uint16_t handle);
+static iq_tag_t *iq_add(const bd_addr *address);
+static void iq_release(iq_tag_t *tag);
+static void iq_set_handle(const bd_addr *address, iq_handle_type_t handle_type, uint16_t handle);
+static void iq_clear_handle(iq_handle_type_t handle_type, uint16_t handle);
+
 /***************************************************************************//**
  * Application Init.
  ******************************************************************************/
@@ -40,6 +91,7 @@ SL_WEAK void app_init(void)
   // Put your additional application init code here!                         //
   // This is called once during start-up.                                    //
   /////////////////////////////////////////////////////////////////////////////
+  (void)iq_set_stats_period(IQ_DECIMATION_STATS_PERIOD);
 }
 
 /**************************************************************************//**
@@ -111,6 +163,24 @@ void sl_ncp_user_cmd_message_to_target_cb(void *data)
 #endif
       break;
 
+    // -------------------------------
+    case IQ_RATE_CMD_ID:
+      if (cmd->len == IQ_RATE_CMD_LEN) {
+        sl_ncp_user_cmd_message_to_target_rsp(iq_set_rate(&user_cmd->data.iq_rate), 0, NULL);
+      } else {
+        sl_ncp_user_cmd_message_to_target_rsp(SL_STATUS_INVALID_PARAMETER, 0, NULL);
+      }
+      break;
+
+    // -------------------------------
+    case IQ_STATS_CMD_ID:
+      if (cmd->len == IQ_STATS_CMD_LEN) {
+        sl_ncp_user_cmd_message_to_target_rsp(iq_set_stats_period(user_cmd->data.iq_stats.period), 0, NULL);
+      } else {
+        sl_ncp_user_cmd_message_to_target_rsp(SL_STATUS_INVALID_PARAMETER, 0, NULL);
+      }
+      break;
+
     // -------------------------------
     // Unknown user command.
     default:
@@ -119,3 +189,312 @@ void sl_ncp_user_cmd_message_to_target_cb(void *data)
       break;
   }
 }
+
+/***************************************************************************//**
+ * Local event processor.
+ *
+ * Drops the IQ reports of the tags that exceed their maximum rate before they
+ * are queued to the host. The connection and synchronization handles are
+ * mapped to the tag addresses from the opened and closed events.
+ *
+ * @param[in] evt The event.
+ * @return true, if the event shall be sent to the host.
+ *
+ * @note This overrides the dummy weak implementation.
+ ******************************************************************************/
+bool sl_ncp_local_evt_process(sl_bt_msg_t *evt)
+{
+  iq_tag_t *tag = NULL;
+  uint8_t channel;
+
+  switch (SL_BT_MSG_ID(evt->header)) {
+    case sl_bt_evt_connection_opened_id:
+      iq_set_handle(&evt->data.evt_connection_opened.address,
+                    IQ_HANDLE_CONNECTION,
+                    evt->data.evt_connection_opened.connection);
+      return true;
+
+    case sl_bt_evt_connection_closed_id:
+      iq_clear_handle(IQ_HANDLE_CONNECTION, evt->data.evt_connection_closed.connection);
+      return true;
+
+    case sl_bt_evt_periodic_sync_opened_id:
+      iq_set_handle(&evt->data.evt_periodic_sync_opened.address,
+                    IQ_HANDLE_SYNC,
+                    evt->data.evt_periodic_sync_opened.sync);
+      return true;
+
+    case sl_bt_evt_sync_closed_id:
+      iq_clear_handle(IQ_HANDLE_SYNC, evt->data.evt_sync_closed.sync);
+      return true;
+
+    case sl_bt_evt_cte_receiver_silabs_iq_report_id:
+      tag = iq_find_by_address(&evt->data.evt_cte_receiver_silabs_iq_report.address);
+      if ((tag == NULL) && (iq_max_rate != 0)) {
+        tag = iq_add(&evt->data.evt_cte_receiver_silabs_iq_report.address);
+      }
+      channel = evt->data.evt_cte_receiver_silabs_iq_report.channel;
+      break;
+
+    case sl_bt_evt_cte_receiver_connection_iq_report_id:
+      tag = iq_find_by_handle(IQ_HANDLE_CONNECTION, evt->data.evt_cte_receiver_connection_iq_report.connection);
+      channel = evt->data.evt_cte_receiver_connection_iq_report.channel;
+      break;
+
+    case sl_bt_evt_cte_receiver_connectionless_iq_report_id:
+      tag = iq_find_by_handle(IQ_HANDLE_SYNC, evt->data.evt_cte_receiver_connectionless_iq_report.sync);
+      channel = evt->data.evt_cte_receiver_connectionless_iq_report.channel;
+      break;
+
+    default:
+      return true;
+  }
+
+  // Untracked tags are not limited.
+  if ((tag == NULL) || iq_report_is_kept(tag, channel)) {
+    iq_forwarded++;
+    return true;
+  }
+  tag->skipped++;
+  iq_skipped++;
+  return false;
+}
+
+/***************************************************************************//**
+ * Sets the maximum IQ report rate of a tag or of all tags.
+ *
+ * @param[in] cmd Address and rate.
+ * @return Returns ok or no more resource if the tag cannot be tracked.
+ ******************************************************************************/
+static sl_status_t iq_set_rate(const iq_rate_cmd_t *cmd)
+{
+  static const bd_addr all_tags = { .addr = { 0xff, 0xff, 0xff, 0xff, 0xff, 0xff } };
+  iq_tag_t *tag;
+
+  if (memcmp(&cmd->address, &all_tags, sizeof(bd_addr)) == 0) {
+    iq_max_rate = cmd->max_rate;
+    return SL_STATUS_OK;
+  }
+
+  tag = iq_find_by_address(&cmd->address);
+  if (tag == NULL) {
+    if (cmd->max_rate == 0) {
+      return SL_STATUS_OK;
+    }
+    tag = iq_add(&cmd->address);
+    if (tag == NULL) {
+      return SL_STATUS_NO_MORE_RESOURCE;
+    }
+  }
+  tag->max_rate = cmd->max_rate;
+  return SL_STATUS_OK;
+}
+
+/***************************************************************************//**
+ * Sets the period of the IQ report statistics event.
+ *
+ * @param[in] period Period in ms, 0 stops the event.
+ * @return Returns the status of the timer.
+ ******************************************************************************/
+static sl_status_t iq_set_stats_period(uint16_t period)
+{
+  (void)app_timer_stop(&iq_stats_timer);
+  if (period == 0) {
+    return SL_STATUS_OK;
+  }
+  return app_timer_start(&iq_stats_timer, period, iq_stats_timer_cb, NULL, true);
+}
+
+/***************************************************************************//**
+ * Sends the IQ report statistics of the last period to the host.
+ ******************************************************************************/
+static void iq_stats_timer_cb(app_timer_t *timer, void *data)
+{
+  iq_stats_evt_t stats_evt;
+  (void)timer;
+  (void)data;
+
+  if (iq_skipped > 0) {
+    stats_evt.hdr = IQ_STATS_EVT_ID;
+    stats_evt.forwarded = iq_forwarded;
+    stats_evt.skipped = iq_skipped;
+    stats_evt.tag_count = 0;
+    for (uint32_t i = 0; i < IQ_DECIMATION_TAG_COUNT; i++) {
+      if (iq_tags[i].used && (iq_tags[i].skipped > 0)
+          && (stats_evt.tag_count < IQ_STATS_EVT_TAGS)) {
+        stats_evt.tags[stats_evt.tag_count].address = iq_tags[i].address;
+        stats_evt.tags[stats_evt.tag_count].skipped = iq_tags[i].skipped;
+        stats_evt.tag_count++;
+      }
+      iq_tags[i].skipped = 0;
+    }
+    sl_ncp_user_evt_message_to_host(offsetof(iq_stats_evt_t, tags)
+                                    + (stats_evt.tag_count * sizeof(iq_stats_evt_tag_t)),
+                                    (uint8_t *)&stats_evt);
+  }
+  iq_forwarded = 0;
+  iq_skipped = 0;
+}
+
+/***************************************************************************//**
+ * Decides whether an IQ report of the tag is kept.
+ *
+ * The tag earns one report per interval of its rate limit. When it sends much
+ * faster than that, a report on a channel it was already kept on waits for
+ * one on another channel, until the saved up time would be lost. The angle
+ * estimation then sees as many channels as possible.
+ *
+ * @param[in] tag Tag of the report.
+ * @param[in] channel Channel of the report.
+ * @return Returns true if the report is kept, false otherwise.
+ ******************************************************************************/
+static bool iq_report_is_kept(iq_tag_t *tag, uint8_t channel)
+{
+  uint16_t max_rate = (tag->max_rate != 0) ? tag->max_rate : iq_max_rate;
+  uint32_t now = sl_sleeptimer_get_tick_count();
+  uint32_t elapsed = now - tag->tick;
+  uint64_t channel_bit = 0;
+  uint32_t interval;
+  uint32_t credit_max;
+  bool kept = false;
+
+  tag->tick = now;
+  tag->period = (tag->period == 0) ? elapsed
+                : (tag->period - (tag->period / 8) + (elapsed / 8));
+  if (max_rate == 0) {
+    return true;
+  }
+
+  interval = sl_sleeptimer_get_timer_frequency() / max_rate;
+  credit_max = IQ_DECIMATION_BURST * interval;
+  if ((tag->credit > credit_max) || (elapsed >= credit_max - tag->credit)) {
+    tag->credit = credit_max;
+  } else {
+    tag->credit += elapsed;
+  }
+  if (channel < IQ_DECIMATION_CHANNEL_COUNT) {
+    channel_bit = (uint64_t)1 << channel;
+  }
+
+  if (tag->credit >= interval) {
+    if ((tag->channels & channel_bit) == 0) {
+      tag->channels |= channel_bit;
+      kept = true;
+    } else if (((uint64_t)tag->period * IQ_DECIMATION_DIVERSITY_RATIO > interval)
+               || (tag->credit + tag->period > credit_max)) {
+      // Waiting would drop reports or lose time, start a new round of channels.
+      tag->channels = channel_bit;
+      kept = true;
+    }
+  }
+  if (kept) {
+    tag->credit -= interval;
+  }
+  return kept;
+}
+
+/***************************************************************************//**
+ * Finds a tracked tag by address.
+ ******************************************************************************/
+static iq_tag_t *iq_find_by_address(const bd_addr *address)
+{
+  for (uint32_t i = 0; i < IQ_DECIMATION_TAG_COUNT; i++) {
+    if (iq_tags[i].used && (memcmp(&iq_tags[i].address, address, sizeof(bd_addr)) == 0)) {
+      return &iq_tags[i];
+    }
+  }
+  return NULL;
+}
+
+/***************************************************************************//**
+ * Finds a tracked tag by connection or synchronization handle.
+ ******************************************************************************/
+static iq_tag_t *iq_find_by_handle(iq_handle_type_t handle_type, uint16_t handle)
+{
+  for (uint32_t i = 0; i < IQ_DECIMATION_TAG_COUNT; i++) {
+    if (iq_tags[i].used && (iq_tags[i].handle_type == handle_type)
+        && (iq_tags[i].handle == handle)) {
+      return &iq_tags[i];
+    }
+  }
+  return NULL;
+}
+
+/***************************************************************************//**
+ * Starts tracking a tag.
+ *
+ * When all entries are used, the tag silent for the longest time is replaced,
+ * unless it has its own rate limit or an open connection or synchronization.
+ *
+ * @param[in] address Address of the tag.
+ * @return Returns the new entry or NULL if none is available.
+ ******************************************************************************/
+static iq_tag_t *iq_add(const bd_addr *address)
+{
+  uint32_t now = sl_sleeptimer_get_tick_count();
+  iq_tag_t *tag = NULL;
+
+  for (uint32_t i = 0; i < IQ_DECIMATION_TAG_COUNT; i++) {
+    if (!iq_tags[i].used) {
+      tag = &iq_tags[i];
+      break;
+    }
+    if ((iq_tags[i].max_rate == 0) && (iq_tags[i].handle_type == IQ_HANDLE_NONE)
+        && ((tag == NULL) || ((now - iq_tags[i].tick) > (now - tag->tick)))) {
+      tag = &iq_tags[i];
+    }
+  }
+  if (tag != NULL) {
+    memset(tag, 0, sizeof(*tag));
+    tag->used = true;
+    tag->address = *address;
+    tag->tick = now;
+    // A new tag starts with the full burst.
+    tag->credit = UINT32_MAX;
+  }
+  return tag;
+}
+
+/***************************************************************************//**
+ * Stops tracking a tag unless it has its own rate limit.
+ ******************************************************************************/
+static void iq_release(iq_tag_t *tag)
+{
+  tag->handle_type = IQ_HANDLE_NONE;
+  if (tag->max_rate == 0) {
+    tag->used = false;
+  }
+}
+
+/***************************************************************************//**
+ * Maps a connection or synchronization handle to the address of its tag.
+ ******************************************************************************/
+static void iq_set_handle(const bd_addr *address, iq_handle_type_t handle_type, uint16_t handle)
+{
+  iq_tag_t *tag = iq_find_by_handle(handle_type, handle);
+
+  // A stale mapping of a reused handle.
+  if (tag != NULL) {
+    iq_release(tag);
+  }
+  tag = iq_find_by_address(address);
+  if (tag == NULL) {
+    tag = iq_add(address);
+  }
+  if (tag != NULL) {
+    tag->handle_type = handle_type;
+    tag->handle = handle;
+  }
+}
+
+/***************************************************************************//**
+ * Removes the mapping of a closed connection or synchronization.
+ ******************************************************************************/
+static void iq_clear_handle(iq_handle_type_t handle_type, uint16_t handle)
+{
+  iq_tag_t *tag = iq_find_by_handle(handle_type, handle);
+
+  if (tag != NULL) {
+    iq_release(tag);
+  }
+}
@@ -45,12 +45,52 @@ typedef uint8_t cmd_2_t[8];
 #define BOARD_CMD_ID        0x03
 #define BOARD_RSP_DATA_LEN  8
 
+// Set the maximum IQ report rate of a tag, or of all tags.
+// The address ff:ff:ff:ff:ff:ff sets the limit of the tags without their own
+// limit. A rate of 0 removes the limit. Reports in excess are dropped before
+// they are queued to the host.
+#define IQ_RATE_CMD_ID      0x04
+#define IQ_RATE_CMD_LEN     (1 + sizeof(iq_rate_cmd_t))
+PACKSTRUCT(struct iq_rate_cmd {
+  bd_addr address;
+  uint16_t max_rate;  // IQ reports per second
+});
+typedef struct iq_rate_cmd iq_rate_cmd_t;
+
+// Set the period of the IQ report statistics event, 0 stops it.
+#define IQ_STATS_CMD_ID     0x05
+#define IQ_STATS_CMD_LEN    (1 + sizeof(iq_stats_cmd_t))
+PACKSTRUCT(struct iq_stats_cmd {
+  uint16_t period;    // ms
+});
+typedef struct iq_stats_cmd iq_stats_cmd_t;
+
+// IQ report statistics, sent as user message to host when reports were
+// skipped in the last period.
+#define IQ_STATS_EVT_ID     0x05
+#define IQ_STATS_EVT_TAGS   16
+PACKSTRUCT(struct iq_stats_evt_tag {
+  bd_addr address;
+  uint32_t skipped;
+});
+typedef struct iq_stats_evt_tag iq_stats_evt_tag_t;
+PACKSTRUCT(struct iq_stats_evt {
+  uint8_t hdr;
+  uint32_t forwarded;  // IQ reports queued to the host in the period
+  uint32_t skipped;    // IQ reports skipped in the period, all tags
+  uint8_t tag_count;
+  iq_stats_evt_tag_t tags[IQ_STATS_EVT_TAGS];  // tags with skipped reports
+});
+typedef struct iq_stats_evt iq_stats_evt_t;
+
 PACKSTRUCT(struct user_cmd {
   uint8_t hdr;
   // Example: union of user commands.
   union {
     cmd_1_t cmd_1;
     cmd_2_t cmd_2;
+    iq_rate_cmd_t iq_rate;
+    iq_stats_cmd_t iq_stats;
   } data;
 });
 
@@ -345,7 +345,8 @@ static bool handle_user_command(uint32_t hdr, void *data)
  *****************************************************************************/
 void sl_bt_on_event(sl_bt_msg_t *evt)
 {
-  if (!sl_ncp_evt_filter_is_filtered((uint32_t)SL_BT_MSG_ID(evt->header))) {
+  if (!sl_ncp_evt_filter_is_filtered((uint32_t)SL_BT_MSG_ID(evt->header))
+      && !sl_ncp_evt_filter_is_content_filtered(evt)) {
     if (sl_ncp_local_evt_process(evt)) {
       // Enqueue event
       evt_enqueue(MSG_GET_LEN(evt),
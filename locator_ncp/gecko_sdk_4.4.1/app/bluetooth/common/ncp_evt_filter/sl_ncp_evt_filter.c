@@ -29,19 +29,50 @@
  ******************************************************************************/
 
 #include <stdint.h>
+#include <string.h>
 #include "sl_status.h"
 #include "sl_ncp_evt_filter.h"
 #include "sl_ncp_evt_filter_config.h"
 #include "sl_ncp_evt_filter_common.h"
 
-static evt_filter_t evt_filter_array[SL_NCP_EVT_FILTER_ARRAY_LENGTH];
+// Slots of the event filter hash table, at most half of them are used
+#define SL_NCP_EVT_FILTER_TABLE_SIZE  (2 * SL_NCP_EVT_FILTER_ARRAY_LENGTH)
+// Marks an unused slot, no event has a zero header
+#define SL_NCP_EVT_FILTER_EMPTY       0
+
+typedef struct {
+  uint8_t ad_type;
+  uint8_t len;
+  uint8_t pattern[SL_NCP_EVT_FILTER_AD_MATCH_MAX_LEN];
+} evt_filter_ad_match_t;
+
+// Open addressing hash table with linear probing, keyed on the message id
+static evt_filter_t evt_filter_array[SL_NCP_EVT_FILTER_TABLE_SIZE];
 static uint8_t evt_pos = 0;
 
+// Allowlisted addresses as 48-bit keys, sorted in ascending order
+static uint64_t evt_filter_address_array[SL_NCP_EVT_FILTER_ADDRESS_LIST_LENGTH];
+static uint16_t evt_address_count = 0;
+
+static evt_filter_ad_match_t evt_filter_ad_match_array[SL_NCP_EVT_FILTER_AD_MATCH_LIST_LENGTH];
+static uint8_t evt_ad_match_count = 0;
+
+static int8_t evt_min_rssi = SL_NCP_EVT_FILTER_MIN_RSSI_DISABLED;
+
 static sl_status_t evt_filter_add_to_array(evt_filter_t event);
 static bool evt_filter_search_in_array(evt_filter_t event);
 static sl_status_t evt_filter_remove_from_array(evt_filter_t event);
 static sl_status_t evt_filter_reset_array(void);
+static uint32_t evt_filter_hash(evt_filter_t event);
 static bool evt_filter_check_is_valid_user_command(user_cmd_manage_event_filter_t *cmd);
+static sl_status_t evt_filter_add_addresses(const uint8_t *addresses, uint8_t count);
+static sl_status_t evt_filter_add_ad_match(const uint8_t *rule, uint8_t len);
+static uint64_t evt_filter_address_key(const uint8_t *address);
+static uint16_t evt_filter_address_lower_bound(uint64_t key);
+static bool evt_filter_address_is_allowed(const bd_addr *address);
+static bool evt_filter_ad_is_matched(const uint8array *data);
+static bool evt_filter_ad_match_rule(const evt_filter_ad_match_t *rule,
+                                     const uint8array *data);
 
 // -----------------------------------------------------------------------------
 // Public functions (API implementation)
@@ -78,6 +109,40 @@ void sl_ncp_evt_filter_handler(user_cmd_manage_event_filter_t *cmd)
       status = evt_filter_reset_array();
       break;
 
+    // -------------------------------
+    // Add addresses to the allowlist
+    case SL_NCP_EVT_FILTER_CMD_ADD_ADDRESS_ID:
+      status = evt_filter_add_addresses(cmd->payload,
+                                        (cmd->hdr.len - 1) / SL_NCP_EVT_FILTER_ADDRESS_LEN);
+      break;
+
+    // -------------------------------
+    // Clear the allowlist
+    case SL_NCP_EVT_FILTER_CMD_RESET_ADDRESS_ID:
+      evt_address_count = 0;
+      status = SL_STATUS_OK;
+      break;
+
+    // -------------------------------
+    // Add an advertisement data match rule
+    case SL_NCP_EVT_FILTER_CMD_ADD_AD_MATCH_ID:
+      status = evt_filter_add_ad_match(cmd->payload, cmd->hdr.len - 1);
+      break;
+
+    // -------------------------------
+    // Clear the advertisement data match rules
+    case SL_NCP_EVT_FILTER_CMD_RESET_AD_MATCH_ID:
+      evt_ad_match_count = 0;
+      status = SL_STATUS_OK;
+      break;
+
+    // -------------------------------
+    // Set the minimum RSSI of the IQ reports
+    case SL_NCP_EVT_FILTER_CMD_SET_MIN_RSSI_ID:
+      evt_min_rssi = (int8_t)cmd->payload[0];
+      status = SL_STATUS_OK;
+      break;
+
     // -------------------------------
     default:
       // Unknown subcommand, send response with failure.
@@ -95,6 +160,44 @@ bool sl_ncp_evt_filter_is_filtered(uint32_t header)
   return evt_filter_search_in_array(header);
 }
 
+/***************************************************************************//**
+ * Checks if the given event is dropped by the content rules.
+ ******************************************************************************/
+bool sl_ncp_evt_filter_is_content_filtered(const sl_bt_msg_t *evt)
+{
+  bool filtered = false;
+
+  switch (SL_BT_MSG_ID(evt->header)) {
+    case sl_bt_evt_scanner_legacy_advertisement_report_id:
+      filtered = !evt_filter_address_is_allowed(&evt->data.evt_scanner_legacy_advertisement_report.address)
+                 || !evt_filter_ad_is_matched(&evt->data.evt_scanner_legacy_advertisement_report.data);
+      break;
+
+    case sl_bt_evt_scanner_extended_advertisement_report_id:
+      filtered = !evt_filter_address_is_allowed(&evt->data.evt_scanner_extended_advertisement_report.address)
+                 || !evt_filter_ad_is_matched(&evt->data.evt_scanner_extended_advertisement_report.data);
+      break;
+
+    case sl_bt_evt_cte_receiver_silabs_iq_report_id:
+      filtered = (evt->data.evt_cte_receiver_silabs_iq_report.rssi < evt_min_rssi)
+                 || !evt_filter_address_is_allowed(&evt->data.evt_cte_receiver_silabs_iq_report.address);
+      break;
+
+    case sl_bt_evt_cte_receiver_connection_iq_report_id:
+      filtered = (evt->data.evt_cte_receiver_connection_iq_report.rssi < evt_min_rssi);
+      break;
+
+    case sl_bt_evt_cte_receiver_connectionless_iq_report_id:
+      filtered = (evt->data.evt_cte_receiver_connectionless_iq_report.rssi < evt_min_rssi);
+      break;
+
+    default:
+      break;
+  }
+
+  return filtered;
+}
+
 /***************************************************************************//**
  * Checks the payload length and header length.
  *
@@ -124,6 +227,38 @@ static bool evt_filter_check_is_valid_user_command(user_cmd_manage_event_filter_
       }
       break;
 
+    case SL_NCP_EVT_FILTER_CMD_ADD_ADDRESS_ID:
+      if ((cmd->hdr.len > SL_NCP_EVT_FILTER_CMD_ADD_ADDRESS_LEN(0))
+          && (((cmd->hdr.len - 1) % SL_NCP_EVT_FILTER_ADDRESS_LEN) == 0)) {
+        valid = true;
+      }
+      break;
+
+    case SL_NCP_EVT_FILTER_CMD_RESET_ADDRESS_ID:
+      if (SL_NCP_EVT_FILTER_CMD_RESET_ADDRESS_LEN == cmd->hdr.len) {
+        valid = true;
+      }
+      break;
+
+    case SL_NCP_EVT_FILTER_CMD_ADD_AD_MATCH_ID:
+      if ((cmd->hdr.len > SL_NCP_EVT_FILTER_CMD_ADD_AD_MATCH_LEN(0))
+          && (cmd->hdr.len <= SL_NCP_EVT_FILTER_CMD_ADD_AD_MATCH_LEN(SL_NCP_EVT_FILTER_AD_MATCH_MAX_LEN))) {
+        valid = true;
+      }
+      break;
+
+    case SL_NCP_EVT_FILTER_CMD_RESET_AD_MATCH_ID:
+      if (SL_NCP_EVT_FILTER_CMD_RESET_AD_MATCH_LEN == cmd->hdr.len) {
+        valid = true;
+      }
+      break;
+
+    case SL_NCP_EVT_FILTER_CMD_SET_MIN_RSSI_ID:
+      if (SL_NCP_EVT_FILTER_CMD_SET_MIN_RSSI_LEN == cmd->hdr.len) {
+        valid = true;
+      }
+      break;
+
     default:
       break;
   }
@@ -147,74 +282,282 @@ static sl_status_t evt_filter_reset_array(void)
 /***************************************************************************//**
  * Deletes the given event in the event filter array.
  *
+ * The following entries of the probe sequence are shifted back so that no
+ * deleted markers are needed and lookups stop at the first empty slot.
+ *
  * @param[in] event
  * @return Returns ok or not_found or empty
  ******************************************************************************/
 static sl_status_t evt_filter_remove_from_array(evt_filter_t event)
 {
-  uint8_t i, j;
-  sl_status_t status = SL_STATUS_NOT_FOUND;
-  uint8_t evt_pos_tmp = evt_pos;
-
-  if (evt_pos > 0) {
-    for (i = 0; i < evt_pos; i++) {
-      if (event == evt_filter_array[i]) {
-        evt_filter_array[i] = 0;
-        status = SL_STATUS_OK;
-        evt_pos -= 1;
-
-        //move element one space ahead from the removed element
-        for (j = i; j < evt_pos_tmp - 1; j++) {
-          evt_filter_array[j] = evt_filter_array[j + 1];
-          evt_filter_array[j + 1] = 0;
-        }
-        break;
-      }
+  uint32_t hole;
+  uint32_t slot;
+  uint32_t home;
+  bool in_place;
+
+  if (evt_pos == 0) {
+    return SL_STATUS_EMPTY;
+  }
+
+  for (hole = evt_filter_hash(event);
+       evt_filter_array[hole] != event;
+       hole = (hole + 1) % SL_NCP_EVT_FILTER_TABLE_SIZE) {
+    if (evt_filter_array[hole] == SL_NCP_EVT_FILTER_EMPTY) {
+      return SL_STATUS_NOT_FOUND;
     }
-  } else {
-    status = SL_STATUS_EMPTY;
   }
 
-  return status;
+  for (slot = (hole + 1) % SL_NCP_EVT_FILTER_TABLE_SIZE;
+       evt_filter_array[slot] != SL_NCP_EVT_FILTER_EMPTY;
+       slot = (slot + 1) % SL_NCP_EVT_FILTER_TABLE_SIZE) {
+    home = evt_filter_hash(evt_filter_array[slot]);
+    // Move the entry into the hole unless its home slot lies cyclically in (hole, slot].
+    in_place = (hole <= slot) ? ((hole < home) && (home <= slot))
+               : ((hole < home) || (home <= slot));
+    if (!in_place) {
+      evt_filter_array[hole] = evt_filter_array[slot];
+      hole = slot;
+    }
+  }
+  evt_filter_array[hole] = SL_NCP_EVT_FILTER_EMPTY;
+  evt_pos -= 1;
+
+  return SL_STATUS_OK;
 }
 
 /***************************************************************************//**
  * Stores the given event in the event filter array.
  *
  * @param[in] event
- * @return Returns ok or full or already exists
+ * @return Returns ok or full or already exists or invalid parameter
  ******************************************************************************/
 static sl_status_t evt_filter_add_to_array(evt_filter_t event)
 {
-  sl_status_t status = SL_STATUS_OK;
+  uint32_t slot;
 
+  if (event == SL_NCP_EVT_FILTER_EMPTY) {
+    return SL_STATUS_INVALID_PARAMETER;
+  }
+
+  for (slot = evt_filter_hash(event);
+       evt_filter_array[slot] != SL_NCP_EVT_FILTER_EMPTY;
+       slot = (slot + 1) % SL_NCP_EVT_FILTER_TABLE_SIZE) {
+    if (evt_filter_array[slot] == event) {
+      return SL_STATUS_ALREADY_EXISTS;
+    }
+  }
   if (evt_pos == SL_NCP_EVT_FILTER_ARRAY_LENGTH) {
-    status = SL_STATUS_FULL;
-  } else if (false == evt_filter_search_in_array(event)) {
-    evt_filter_array[evt_pos] = event;
-    evt_pos++;
-  } else {
-    status = SL_STATUS_ALREADY_EXISTS;
+    return SL_STATUS_FULL;
   }
-  return status;
+  // Cannot be full, the table has twice as many slots as events.
+  evt_filter_array[slot] = event;
+  evt_pos++;
+  return SL_STATUS_OK;
 }
 
 /***************************************************************************//**
  * Searches the given event in the event filter array.
  *
+ * The table is at most half full, a lookup takes about two probes on average
+ * whatever the number of filtered events is.
+ *
  * @param[in] event
  * @return Returns true if finds, false otherwise.
  ******************************************************************************/
 static bool evt_filter_search_in_array(evt_filter_t event)
 {
+  uint32_t slot;
+
+  if (evt_pos == 0) {
+    return false;
+  }
+  for (slot = evt_filter_hash(event);
+       evt_filter_array[slot] != SL_NCP_EVT_FILTER_EMPTY;
+       slot = (slot + 1) % SL_NCP_EVT_FILTER_TABLE_SIZE) {
+    if (evt_filter_array[slot] == event) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/***************************************************************************//**
+ * Returns the home slot of the given event.
+ *
+ * The class and the message id are in the upper half of the header, the
+ * multiplicative hash spreads them over the table.
+ ******************************************************************************/
+static uint32_t evt_filter_hash(evt_filter_t event)
+{
+  return (((uint32_t)event * 2654435761U) >> 16) % SL_NCP_EVT_FILTER_TABLE_SIZE;
+}
+
+/***************************************************************************//**
+ * Stores the given addresses in the allowlist, keeping it sorted.
+ *
+ * @param[in] addresses count packed addresses
+ * @param[in] count number of addresses
+ * @return Returns ok or full, the addresses before the first one that did not
+ *         fit are stored.
+ ******************************************************************************/
+static sl_status_t evt_filter_add_addresses(const uint8_t *addresses, uint8_t count)
+{
+  uint64_t key;
+  uint16_t position;
+
+  for (; count > 0; count--, addresses += SL_NCP_EVT_FILTER_ADDRESS_LEN) {
+    key = evt_filter_address_key(addresses);
+    position = evt_filter_address_lower_bound(key);
+    if ((position < evt_address_count)
+        && (evt_filter_address_array[position] == key)) {
+      // Already on the list.
+      continue;
+    }
+    if (evt_address_count == SL_NCP_EVT_FILTER_ADDRESS_LIST_LENGTH) {
+      return SL_STATUS_FULL;
+    }
+    memmove(&evt_filter_address_array[position + 1],
+            &evt_filter_address_array[position],
+            (evt_address_count - position) * sizeof(evt_filter_address_array[0]));
+    evt_filter_address_array[position] = key;
+    evt_address_count++;
+  }
+  return SL_STATUS_OK;
+}
+
+/***************************************************************************//**
+ * Stores the given advertisement data match rule.
+ *
+ * @param[in] rule AD type followed by the pattern
+ * @param[in] len length of the rule
+ * @return Returns ok or full
+ ******************************************************************************/
+static sl_status_t evt_filter_add_ad_match(const uint8_t *rule, uint8_t len)
+{
+  evt_filter_ad_match_t *ad_match;
+
+  if (evt_ad_match_count == SL_NCP_EVT_FILTER_AD_MATCH_LIST_LENGTH) {
+    return SL_STATUS_FULL;
+  }
+  ad_match = &evt_filter_ad_match_array[evt_ad_match_count];
+  ad_match->ad_type = rule[0];
+  ad_match->len = len - 1;
+  memcpy(ad_match->pattern, &rule[1], ad_match->len);
+  evt_ad_match_count++;
+  return SL_STATUS_OK;
+}
+
+/***************************************************************************//**
+ * Packs an address into an integer key, byte 0 is the least significant.
+ ******************************************************************************/
+static uint64_t evt_filter_address_key(const uint8_t *address)
+{
+  uint64_t key = 0;
   uint8_t i;
-  bool catch = false;
 
-  for (i = 0; i < evt_pos; i++) {
-    if (event == evt_filter_array[i]) {
-      catch = true;
+  for (i = 0; i < SL_NCP_EVT_FILTER_ADDRESS_LEN; i++) {
+    key |= (uint64_t)address[i] << (8 * i);
+  }
+  return key;
+}
+
+/***************************************************************************//**
+ * Returns the position of the first allowlist key not less than the given one.
+ ******************************************************************************/
+static uint16_t evt_filter_address_lower_bound(uint64_t key)
+{
+  uint16_t low = 0;
+  uint16_t high = evt_address_count;
+  uint16_t middle;
+
+  while (low < high) {
+    middle = low + ((high - low) / 2);
+    if (evt_filter_address_array[middle] < key) {
+      low = middle + 1;
+    } else {
+      high = middle;
+    }
+  }
+  return low;
+}
+
+/***************************************************************************//**
+ * Checks the given address against the allowlist.
+ *
+ * @param[in] address
+ * @return Returns true if allowlisted or the allowlist is empty.
+ ******************************************************************************/
+static bool evt_filter_address_is_allowed(const bd_addr *address)
+{
+  uint64_t key;
+  uint16_t position;
+
+  if (evt_address_count == 0) {
+    return true;
+  }
+  key = evt_filter_address_key(address->addr);
+  position = evt_filter_address_lower_bound(key);
+  return (position < evt_address_count)
+         && (evt_filter_address_array[position] == key);
+}
+
+/***************************************************************************//**
+ * Checks the given advertisement data against the AD match rules.
+ *
+ * @param[in] data advertisement or scan response data
+ * @return Returns true if any rule matches or there are no rules.
+ ******************************************************************************/
+static bool evt_filter_ad_is_matched(const uint8array *data)
+{
+  uint8_t i;
+
+  if (evt_ad_match_count == 0) {
+    return true;
+  }
+  for (i = 0; i < evt_ad_match_count; i++) {
+    if (evt_filter_ad_match_rule(&evt_filter_ad_match_array[i], data)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/***************************************************************************//**
+ * Searches the AD structures of the rule's type for the pattern.
+ *
+ * The pattern is compared at every multiple of its length within the AD
+ * structure, so a UUID is found anywhere in a UUID list and other patterns
+ * match the beginning of the AD data.
+ *
+ * @param[in] rule AD match rule
+ * @param[in] data advertisement or scan response data
+ * @return Returns true if the pattern is found.
+ ******************************************************************************/
+static bool evt_filter_ad_match_rule(const evt_filter_ad_match_t *rule,
+                                     const uint8array *data)
+{
+  uint16_t i = 0;
+  uint16_t end;
+  uint16_t offset;
+
+  // Each AD structure is a length, a type and length - 1 bytes of data.
+  while ((i + 1) < data->len) {
+    if (data->data[i] == 0) {
+      // Early termination of the significant part.
       break;
     }
+    end = i + 1 + data->data[i];
+    if (end > data->len) {
+      end = data->len;
+    }
+    if (data->data[i + 1] == rule->ad_type) {
+      for (offset = i + 2; (offset + rule->len) <= end; offset += rule->len) {
+        if (memcmp(&data->data[offset], rule->pattern, rule->len) == 0) {
+          return true;
+        }
+      }
+    }
+    i = end;
   }
-  return catch;
+  return false;
 }
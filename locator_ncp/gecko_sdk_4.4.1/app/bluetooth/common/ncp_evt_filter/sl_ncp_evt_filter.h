@@ -47,7 +47,10 @@ PACKSTRUCT(struct user_cmd_manage_event_filter {
     uint8_t len;
     uint8_t id;
   } hdr;
-  evt_filter_t evt;
+  union {
+    evt_filter_t evt;                 // Event id of the add and remove commands
+    uint8_t payload[UINT8_MAX - 1];   // Payload of the content rule commands
+  };
 });
 
 typedef struct user_cmd_manage_event_filter user_cmd_manage_event_filter_t;
@@ -70,5 +73,18 @@ void sl_ncp_evt_filter_handler(user_cmd_manage_event_filter_t *cmd);
  ******************************************************************************/
 bool sl_ncp_evt_filter_is_filtered(uint32_t header);
 
+/***************************************************************************//**
+ * Checks if the given event is dropped by the content rules.
+ *
+ * Scan reports are checked against the address allowlist and the AD match
+ * rules, Silabs IQ reports against the address allowlist and the minimum RSSI,
+ * connection and connectionless IQ reports against the minimum RSSI. An empty
+ * allowlist or rule list lets every event through.
+ *
+ * @param[in] evt outgoing Bluetooth stack event
+ * @return Returns true if filtered, false otherwise.
+ ******************************************************************************/
+bool sl_ncp_evt_filter_is_content_filtered(const sl_bt_msg_t *evt);
+
 /** @} (end addtogroup ncp_evt_filter) */
 #endif // SL_NCP_EVT_FILTER_H